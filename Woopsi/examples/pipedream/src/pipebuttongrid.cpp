@@ -21,6 +21,9 @@ PipeButtonGrid::PipeButtonGrid(s16 x, s16 y, u8 rows, u8 columns) : Gadget(x, y,
 	_rows = rows;
 	_columns = columns;
 
+	// Index the buttons so that clicks and redraws do not check every button
+	setSpatialIndexEnabled(true);
+
 	generateRandomLayout(0);
 }
 
@@ -0,0 +1,36 @@
+#ifndef _ANIMATABLE_H_
+#define _ANIMATABLE_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	/**
+	 * Base Animatable class, intended to be subclassed.  Any class that needs
+	 * to be advanced once per frame by the Animator should inherit from this
+	 * class.
+	 */
+	class Animatable {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		inline Animatable() { }
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~Animatable() { }
+
+		/**
+		 * Advance the animation by one frame.  Implementations should only
+		 * damage the display if the displayed state has actually changed.
+		 * @return True if the animation should keep running; false if it has
+		 * finished and should be removed from the animator.
+		 */
+		virtual bool animate() = 0;
+	};
+}
+
+#endif
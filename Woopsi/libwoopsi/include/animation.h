@@ -123,8 +123,9 @@ namespace WoopsiUI {
 
 		/**
 		 * Run the animation.  Should be called every frame.
+		 * @return True if the current frame changed.
 		 */
-		void run();
+		bool run();
 		
 		/**
 		 * Start the animation.
@@ -0,0 +1,81 @@
+#ifndef _ANIMATOR_H_
+#define _ANIMATOR_H_
+
+#include <nds.h>
+#include "woopsiarray.h"
+
+namespace WoopsiUI {
+
+	class Animatable;
+
+	/**
+	 * Advances all running animations and tweens once per frame.  Woopsi owns
+	 * an instance and runs it every VBL.
+	 *
+	 * Animatable objects are added when they start running and are removed
+	 * automatically when they report that they have finished.  The animator
+	 * does not own the objects it runs; objects must be removed before they
+	 * are deleted.
+	 *
+	 * While the animator is empty, nothing is animating and Woopsi is free to
+	 * sleep until the next input event.
+	 */
+	class Animator {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		Animator();
+
+		/**
+		 * Destructor.
+		 */
+		inline ~Animator() { };
+
+		/**
+		 * Add an object to the list of objects advanced every frame.  Does
+		 * nothing if the object is already in the list.
+		 * @param animatable The object to add.
+		 */
+		void add(Animatable* animatable);
+
+		/**
+		 * Remove an object from the list of objects advanced every frame.
+		 * Can safely be called while the animator is running.
+		 * @param animatable The object to remove.
+		 */
+		void remove(Animatable* animatable);
+
+		/**
+		 * Check if an object is in the list of objects advanced every frame.
+		 * @param animatable The object to check.
+		 * @return True if the object is running.
+		 */
+		bool contains(const Animatable* animatable) const;
+
+		/**
+		 * Check if anything is animating.
+		 * @return True if any objects are running.
+		 */
+		inline bool isAnimating() const { return _animatables.size() > 0; };
+
+		/**
+		 * Advance all running objects by one frame and remove any that have
+		 * finished.  Objects added while the animator is running are first
+		 * advanced in the following frame.
+		 */
+		void run();
+
+	private:
+		WoopsiArray<Animatable*> _animatables;	/**< Objects advanced every frame. */
+		bool _isRunning;						/**< True while run() is advancing objects. */
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline Animator(const Animator& animator) { };
+	};
+}
+
+#endif
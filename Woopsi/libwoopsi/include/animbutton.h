@@ -3,18 +3,19 @@
 
 #include <nds.h>
 #include "gadget.h"
+#include "animatable.h"
 #include "animation.h"
-#include "gadgeteventhandler.h"
 
 namespace WoopsiUI {
 
-	class WoopsiTimer;
-
 	/**
 	 * Button class that has an animation running in its clickable area.  Note
 	 * that the bitmaps used in the animation should all be the same size.
+	 *
+	 * The button is run by Woopsi's Animator while its animation is playing,
+	 * and is only redrawn when the animation moves to a new frame.
 	 */
-	class AnimButton : public Gadget, public GadgetEventHandler {
+	class AnimButton : public Gadget, public Animatable {
 
 	public:
 
@@ -52,13 +53,19 @@ namespace WoopsiUI {
 		 */
 		virtual void getPreferredDimensions(Rect& rect) const;
 
+		/**
+		 * Advance the current animation by one frame.  Called by the
+		 * Animator.
+		 * @return True while the current animation is playing.
+		 */
+		virtual bool animate();
+
 	protected:
 		Animation* _animNormal;					/**< Animation played when button is not clicked */
 		Animation* _animClicked;				/**< Animation played when button is clicked */
 		u16 _animX;								/**< X co-ordinate of the animations */
 		u16 _animY;								/**< Y co-ordinate of the animations */
 		bool _initialised;						/**< Tracks if the animation has started or not */
-		WoopsiTimer* _timer;					/**< Controls animation timing and playback */
 		
 		static const int ANIM_BUTTON_DEFAULT_WIDTH;		/**< Default preferred width */
 		static const int ANIM_BUTTON_DEFAULT_HEIGHT;	/**< Default preferred height */
@@ -122,15 +129,19 @@ namespace WoopsiUI {
 		virtual ~AnimButton();
 
 		/**
-		 * Copy constructor is protected to prevent usage.
+		 * Ask the Animator to start running the button.
 		 */
-		inline AnimButton(const AnimButton& animButton) : Gadget(animButton) { };
+		void startAnimating();
 
 		/**
-		 * Handle any child events.
-		 * @param source The gadget that raised the event.
+		 * Ask the Animator to stop running the button.
 		 */
-		void handleActionEvent(Gadget& source);
+		void stopAnimating();
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline AnimButton(const AnimButton& animButton) : Gadget(animButton) { };
 	};
 }
 
@@ -0,0 +1,135 @@
+#ifndef _BACKING_STORE_H_
+#define _BACKING_STORE_H_
+
+#include <nds.h>
+#include "region.h"
+
+namespace WoopsiUI {
+
+	class FrameBuffer;
+	class Gadget;
+
+	/**
+	 * Off-screen copy of a gadget and its children.  Used to move gadgets
+	 * around the display by copying their pixels instead of redrawing them.
+	 *
+	 * The store keeps track of which parts of its bitmap are up to date.  By
+	 * default it registers itself with the DamagedRectManager, which tells it
+	 * about all damage to the display before the damage is redrawn, and any
+	 * damaged parts of the store become out of date.  Stores used as layer
+	 * surfaces are instead told only about changes to the gadgets within the
+	 * layer.  Out of date parts are brought up to date when update() is
+	 * called.  Parts of the gadget that are visible are
+	 * copied from the display by capture(); parts that are hidden behind
+	 * other gadgets are rendered off-screen by the gadget's redraw() method.
+	 *
+	 * Gadgets that draw directly to the display outside of redraw() do not
+	 * damage the display, so capture() should be called before the store is
+	 * used in order to pick up any such drawing in the visible parts of the
+	 * gadget.
+	 */
+	class BackingStore {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param gadget The gadget to store.
+		 * @param isTrackingDisplay If true, the store is marked as out of
+		 * date wherever the display is damaged.  If false, the store must be
+		 * told about changes by calling markDamaged().
+		 */
+		BackingStore(Gadget* gadget, bool isTrackingDisplay = true);
+
+		/**
+		 * Destructor.
+		 */
+		~BackingStore();
+
+		/**
+		 * Mark part of the display as damaged.  Any parts of the store that
+		 * fall within the region become out of date.
+		 * @param region The damaged region, in Woopsi-space.
+		 */
+		void markDamaged(const Region& region);
+
+		/**
+		 * Mark the entire store as out of date.
+		 */
+		void invalidate();
+
+		/**
+		 * Copy the visible parts of the gadget from the display into the
+		 * store.  The display should be up to date before this is called.
+		 */
+		void capture();
+
+		/**
+		 * Render all out of date parts of the gadget into the store.
+		 */
+		void update();
+
+		/**
+		 * Copy the store to the visible parts of the gadget on the display.
+		 * Any visible parts of the store that are out of date are marked as
+		 * damaged instead so that they will be redrawn.
+		 */
+		void draw();
+
+		/**
+		 * Copy part of the store to the current render target, or to the
+		 * display if there is no render target, blending it with the existing
+		 * pixels.  The region should be up to date.
+		 * @param region The region to copy, in Woopsi-space.
+		 * @param alpha The opacity of the store, from 0 to 255.
+		 * @see Gadget::setRenderTarget()
+		 */
+		void composite(const Region& region, u8 alpha);
+
+		/**
+		 * Get the bitmap containing the stored pixels.
+		 * @return The store's bitmap.
+		 */
+		inline const FrameBuffer* getBitmap() const { return _bitmap; };
+
+	private:
+		Gadget* _gadget;					/**< Gadget being stored. */
+		u16* _data;							/**< Pixel data. */
+		FrameBuffer* _bitmap;				/**< Bitmap wrapping the pixel data. */
+		Region _validRegion;				/**< Up to date region, relative to the gadget. */
+		bool _isTrackingDisplay;			/**< True if registered with the damaged rect manager. */
+
+		/**
+		 * Reallocate the bitmap if the gadget's size has changed.
+		 */
+		void resizeBitmap();
+
+		/**
+		 * Get the framebuffer that displays the gadget.
+		 * @return The gadget's framebuffer.
+		 */
+		FrameBuffer* getFrameBuffer() const;
+
+		/**
+		 * Get the Woopsi-space y co-ordinate of the top of the framebuffer
+		 * that displays the gadget.
+		 * @return The y co-ordinate of the framebuffer.
+		 */
+		s16 getFrameBufferY() const;
+
+		/**
+		 * Blend two colours.
+		 * @param source The colour being drawn.
+		 * @param dest The existing colour.
+		 * @param alpha The opacity of the source colour, from 0 to 255.
+		 * @return The blended colour.
+		 */
+		static u16 blend(u16 source, u16 dest, u8 alpha);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline BackingStore(const BackingStore& backingStore) { };
+	};
+}
+
+#endif
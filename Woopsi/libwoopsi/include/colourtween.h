@@ -0,0 +1,56 @@
+#ifndef _COLOUR_TWEEN_H_
+#define _COLOUR_TWEEN_H_
+
+#include <nds.h>
+#include "tween.h"
+
+namespace WoopsiUI {
+
+	class Gadget;
+
+	/**
+	 * Tween that fades a gadget's background colour from its colour when the
+	 * tween starts to a new colour.  Each channel is faded separately.  The
+	 * gadget is only redrawn in frames in which its colour changes.
+	 */
+	class ColourTween : public Tween {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param gadget The gadget to recolour.
+		 * @param colour The final background colour.
+		 * @param frames The number of frames the fade takes.
+		 * @param easing The easing curve to use.
+		 */
+		ColourTween(Gadget* gadget, u16 colour, u16 frames, Easing easing = TWEEN_EASING_LINEAR);
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~ColourTween() { };
+
+		/**
+		 * Start fading the gadget from its current background colour.
+		 */
+		virtual void start();
+
+	protected:
+		Gadget* _gadget;					/**< Gadget being recoloured */
+		u16 _fromColour;					/**< Background colour when the tween started */
+		u16 _toColour;						/**< Final background colour */
+
+		/**
+		 * Set the gadget's colour to the colour at the supplied progress.
+		 * @param progress The eased progress, from 0 to PROGRESS_MAX.
+		 */
+		virtual void update(s32 progress);
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline ColourTween(const ColourTween& colourTween) : Tween(colourTween) { };
+	};
+}
+
+#endif
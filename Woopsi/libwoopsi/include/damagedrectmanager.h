@@ -2,18 +2,50 @@
 #define _DAMAGED_RECT_MANAGER_
 
 #include "rect.h"
+#include "region.h"
 #include "woopsiarray.h"
 
 namespace WoopsiUI {
 
+	class BackingStore;
 	class Gadget;
 
 	/**
-	 * Manages damaged rects.  Keeps a list of damaged rects and redraws them
-	 * when redraw() is called.
+	 * Manages damaged rects.  Keeps a region describing all damaged areas of
+	 * the display and redraws it when redraw() is called.
+	 *
+	 * Every rect in the damaged region causes a walk of the gadget tree when
+	 * it is redrawn.  Lots of small, nearby updates (a text cursor, a progress
+	 * bar and a label changing in the same frame) can therefore cost more in
+	 * traversal than in drawing.  Before redrawing, the manager merges pairs
+	 * of rects into their bounding box if the number of undamaged pixels the
+	 * box would redraw is no more than the rect cost, which is the estimated
+	 * cost of redrawing an extra rect expressed in pixels.
+	 *
+	 * The damaged region is split between gadgets from the top of the z-order
+	 * downwards, so each opaque gadget claims the area it covers and the
+	 * gadgets beneath it are never asked to paint that area.  The area beneath
+	 * a non-opaque gadget is painted by the gadgets below it first.  The
+	 * ratio of the painted area to the drawn area reported by
+	 * getRedrawStats() is the overdraw; it is 1.0 if every gadget is opaque.
+	 *
+	 * Gadgets that are layers are not drawn directly.  Instead, the out of
+	 * date parts of their surfaces are re-rendered and the damaged region is
+	 * composited from the surface.
 	 */
 	class DamagedRectManager {
 	public:
+
+		/**
+		 * Statistics describing the most recent redraw.
+		 */
+		typedef struct {
+			s32 damagedArea;				/**< Number of pixels that were damaged. */
+			s32 drawnArea;					/**< Number of pixels that were redrawn. */
+			s32 damagedRectCount;			/**< Number of damaged rects before merging. */
+			s32 drawnRectCount;				/**< Number of rects redrawn after merging. */
+			s32 paintedArea;				/**< Number of pixels painted by gadgets. */
+		} RedrawStats;
 		
 		/**
 		 * Constructor.
@@ -28,29 +60,149 @@ namespace WoopsiUI {
 		~DamagedRectManager();
 
 		/**
-		 * Add a damaged rect to the list.  The method automatically clips and
-		 * splits the rect to ensure that only new regions are added to the
-		 * list.
-		 * @param rect The rect to add to the list.
+		 * Add a damaged rect to the damaged region.  Areas that are already
+		 * damaged are merged with the new rect so that each pixel is only
+		 * redrawn once.
+		 * @param rect The rect to add.
 		 */
 		void addDamagedRect(const Rect& rect);
+
+		/**
+		 * Add a damaged region to the damaged region.
+		 * @param region The region to add.
+		 */
+		void addDamagedRegion(const Region& region);
+
+		/**
+		 * Remove a region from the damaged region.  Used when the contents of
+		 * part of the display have been restored without redrawing, such as
+		 * when a gadget is copied from its backing store.
+		 * @param region The region to remove.
+		 */
+		void removeDamagedRegion(const Region& region);
+
+		/**
+		 * Redraw part of a gadget and its children immediately, bypassing the
+		 * damaged region.  If the gadget is a layer it is drawn directly
+		 * rather than being composited from its surface.
+		 * @param gadget The gadget to redraw.
+		 * @param region The region to redraw, in Woopsi-space.  The region is
+		 * emptied as it is redrawn.
+		 */
+		void drawRegion(Gadget* gadget, Region& region);
+
+		/**
+		 * Add a backing store to the list of stores that are told about
+		 * damage to the display.
+		 * @param backingStore The store to add.
+		 */
+		void addBackingStore(BackingStore* backingStore);
+
+		/**
+		 * Remove a backing store from the list of stores that are told about
+		 * damage to the display.
+		 * @param backingStore The store to remove.
+		 */
+		void removeBackingStore(BackingStore* backingStore);
 		
 		/**
 		 * Redraws all damaged rects.
 		 */
 		void redraw();
 
+		/**
+		 * Check if any part of the display is waiting to be redrawn.
+		 * @return True if the damaged region is not empty.
+		 */
+		inline bool isDamaged() const { return !_damagedRegion.isEmpty(); };
+
+		/**
+		 * Check if any part of a rect is waiting to be redrawn.
+		 * @param rect The rect to check, in Woopsi co-ordinates.
+		 * @return True if the rect overlaps the damaged region.
+		 */
+		inline bool isDamaged(const Rect& rect) const { return _damagedRegion.intersects(rect); };
+
+		/**
+		 * Set the estimated cost of redrawing an extra rect, in pixels.  Two
+		 * damaged rects are merged into their bounding box if the box would
+		 * redraw no more than this number of undamaged pixels.  Set to 0 to
+		 * merge only rects whose bounding box contains no undamaged pixels.
+		 * @param rectCost The cost of a rect in pixels.
+		 */
+		inline void setRectCost(s32 rectCost) { _rectCost = rectCost; };
+
+		/**
+		 * Get the estimated cost of redrawing an extra rect, in pixels.
+		 * @return The cost of a rect in pixels.
+		 * @see setRectCost()
+		 */
+		inline const s32 getRectCost() const { return _rectCost; };
+
+		/**
+		 * Get statistics describing the most recent redraw.  The difference
+		 * between the drawn and damaged areas is the overdraw introduced by
+		 * merging rects.  The difference between the painted and drawn areas
+		 * is the overdraw introduced by painting beneath non-opaque gadgets.
+		 * @return Statistics for the most recent redraw.
+		 */
+		inline const RedrawStats& getRedrawStats() const { return _redrawStats; };
+
 	private:
-		WoopsiArray<Rect>* _damagedRects;		/**< List of damaged rects. */
+		Region _damagedRegion;					/**< Region of the display that needs redrawing. */
+		s32 _rectCost;							/**< Estimated cost of an extra rect in pixels. */
+		RedrawStats _redrawStats;				/**< Statistics for the most recent redraw. */
+		WoopsiArray<BackingStore*> _backingStores;	/**< Stores that must be told about damage. */
 		Gadget* _gadget;						/**< The top-level gadget. */
 		
 		/**
 		 * Redraws all damaged rects.
-		 * @param gadget The gadget to compare with the damaged region list to
-		 * see if it intersects any regions.  If so, those regions are redrawn.
-		 * @param damagedRects Damaged region list.
+		 * @param gadget The gadget to compare with the damaged region to see
+		 * if it intersects.  If so, the intersection is redrawn by the gadget
+		 * and its children and is removed from the damaged region.
+		 * @param damagedRegion The damaged region.
+		 */
+		void drawRects(Gadget* gadget, Region& damagedRegion);
+
+		/**
+		 * Get a gadget and its children to redraw the part of the damaged
+		 * region that overlaps the gadget.
+		 * @param gadget The gadget to draw.
+		 * @param subRegion The part of the damaged region that overlaps the
+		 * gadget.  Areas are removed as children redraw them.
+		 */
+		void drawGadget(Gadget* gadget, Region& subRegion);
+
+		/**
+		 * Copy part of a layer from its surface, re-rendering any out of date
+		 * parts of the surface first.
+		 * @param gadget The layer.
+		 * @param region The region to copy.
+		 */
+		void compositeLayer(Gadget* gadget, const Region& region);
+
+		/**
+		 * Redraws the part of the damaged region that lies beneath a
+		 * non-opaque gadget using the gadget's lower siblings and its parent.
+		 * @param gadget The non-opaque gadget.
+		 * @param damagedRegion The damaged region beneath the gadget.  Areas
+		 * are removed as they are redrawn.
+		 */
+		void drawBeneath(Gadget* gadget, Region& damagedRegion);
+
+		/**
+		 * Get a gadget to redraw all of the rects in a region and record the
+		 * painted area.
+		 * @param gadget The gadget to redraw.
+		 * @param region The region to redraw.
+		 */
+		void paintRegion(Gadget* gadget, const Region& region);
+
+		/**
+		 * Merge rects in the damaged region into their bounding boxes where
+		 * the overdraw is cheaper than the cost of the extra rects.
 		 */
-		void drawRects(Gadget* gadget, WoopsiArray<Rect>* damagedRects);
+		void coalesce();
 	};
 }
 
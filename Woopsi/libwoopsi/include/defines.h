@@ -16,6 +16,24 @@ const s32 SCREEN_COUNT = 2;
  */
 const s32 TOP_SCREEN_Y_OFFSET = 512;
 
+/**
+ * Duration of a single frame in milliseconds.  Used by the SDL build to
+ * pace frames in which nothing is presented.
+ */
+const u32 SDL_FRAME_DURATION = 16;
+
+/**
+ * Number of frames drawn each second.  Used to convert millisecond timer
+ * deadlines into frames.
+ */
+const u32 FRAMES_PER_SECOND = 60;
+
+/**
+ * Maximum time in milliseconds that the SDL build sleeps while waiting for
+ * input when there is nothing else to do.
+ */
+const u32 IDLE_TIMEOUT = 1000;
+
 /**
  * The TOP_SCREEN_NUMBER gives the index of the top screen in the frameBuffer[]
  * framebuffer pointer array.
@@ -50,6 +68,69 @@ const s32 KEY_INITIAL_REPEAT_TIME = 25;
  */
 const s32 KEY_SECONDARY_REPEAT_TIME = 5;
 
+/**
+ * Initial size, in bytes, of the arena used for objects that only live for a
+ * single VBL.  The arena grows automatically if a frame needs more memory.
+ */
+const u32 FRAME_ARENA_SIZE = 2048;
+
+/**
+ * Gadgets and rect caches are allocated from a slab allocator that groups
+ * objects into size classes.  Each size class is a multiple of this value,
+ * which must be a multiple of 8.
+ */
+const u32 GADGET_SLAB_GRANULARITY = 16;
+
+/**
+ * Gadgets larger than this size, in bytes, are allocated from the heap rather
+ * than from the gadget slab allocator.
+ */
+const u32 GADGET_SLAB_MAX_OBJECT_SIZE = 1024;
+
+/**
+ * Estimated cost, in pixels, of redrawing an extra damaged rect.  Each rect
+ * requires a walk of the gadget hierarchy, so damaged rects are merged into
+ * their bounding box if the box would redraw no more than this number of
+ * undamaged pixels.
+ */
+const s32 DAMAGED_RECT_COST = 256;
+
+/**
+ * Preferred width and height of the cells in a gadget's spatial index of its
+ * children.
+ */
+const u16 SPATIAL_GRID_CELL_SIZE = 32;
+
+/**
+ * Maximum number of cells in a gadget's spatial index.  If the children cover
+ * too large an area the cell size is increased to stay within this limit.
+ */
+const s32 SPATIAL_GRID_MAX_CELLS = 128;
+
+/**
+ * Number of directory entries read in each batch by a DirectoryReader.  On the
+ * DS this is the number of entries read per frame; in the SDL build it is the
+ * number of entries the reading thread collects before publishing them.
+ */
+const s32 DIRECTORY_READ_BATCH_SIZE = 64;
+
+/**
+ * Maximum number of directory listings held in the directory cache.
+ */
+const s32 DIRECTORY_CACHE_SIZE = 8;
+
+/**
+ * Minimum number of items a ListData must contain before it builds a trigram
+ * index to speed up filtering.  Shorter lists are searched item by item.
+ */
+const s32 FILTER_INDEX_THRESHOLD = 1024;
+
+/**
+ * Number of code points, starting from 0, whose widths are cached by a Document
+ * to speed up wrapping.  256 covers ASCII and Latin-1.
+ */
+const s32 DOCUMENT_WIDTH_TABLE_SIZE = 256;
+
 /**
  * Woopsi version number.
  */
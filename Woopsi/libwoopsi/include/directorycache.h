@@ -0,0 +1,128 @@
+#ifndef _DIRECTORY_CACHE_H_
+#define _DIRECTORY_CACHE_H_
+
+#include <nds.h>
+#include "directoryreader.h"
+#include "woopsiarray.h"
+#include "woopsistring.h"
+
+namespace WoopsiUI {
+
+	/**
+	 * Caches the most recently read directory listings so that returning to
+	 * a directory does not require it to be read again.  Woopsi owns a single
+	 * instance shared by every FileListBox.
+	 *
+	 * A listing is only useful while it matches the file system, so each
+	 * cached directory is watched with inotify.  Any change to a watched
+	 * directory discards its listing.  Pending notifications are processed
+	 * whenever a listing is requested, so the cache costs nothing while it
+	 * is not being used.
+	 *
+	 * Change notifications are only available in the SDL build on Linux.  On
+	 * other platforms the cache cannot tell when a listing is out of date, so
+	 * it stores nothing and getListing() always returns NULL.
+	 *
+	 * Listings are stored in two stages.  beginListing() is called before
+	 * reading starts so that changes made while the directory is being read
+	 * are noticed; storeListing() is called once the read is complete.  The
+	 * least recently used listing is discarded when the cache is full.
+	 */
+	class DirectoryCache {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param capacity The maximum number of listings to cache.
+		 */
+		DirectoryCache(const s32 capacity);
+
+		/**
+		 * Destructor.
+		 */
+		~DirectoryCache();
+
+		/**
+		 * Get the cached listing of a directory.  The listing is only valid
+		 * until the next call to a method of the cache.
+		 * @param path The path of the directory.
+		 * @return The listing, or NULL if the directory is not cached.
+		 */
+		const WoopsiArray<DirectoryReader::Entry>* getListing(const WoopsiString& path);
+
+		/**
+		 * Start watching a directory that is about to be read.  Any existing
+		 * listing for the directory is discarded.
+		 * @param path The path of the directory.
+		 */
+		void beginListing(const WoopsiString& path);
+
+		/**
+		 * Store the listing of a directory that has been read.  The listing is
+		 * discarded if the directory has changed since beginListing() was
+		 * called for it.
+		 * @param path The path of the directory.
+		 * @param entries The entries in the directory.
+		 */
+		void storeListing(const WoopsiString& path, const WoopsiArray<DirectoryReader::Entry>& entries);
+
+		/**
+		 * Discard the listing of a directory.
+		 * @param path The path of the directory.
+		 */
+		void invalidate(const WoopsiString& path);
+
+		/**
+		 * Discard all listings.
+		 */
+		void clear();
+
+		/**
+		 * Check if the cache can store listings.  If not, there is no need to
+		 * keep a listing once it has been read.
+		 * @return True if the cache can store listings.
+		 */
+		inline bool isEnabled() const { return _inotifyFd >= 0; };
+
+	private:
+
+		/**
+		 * Struct describing a cached directory.
+		 */
+		typedef struct {
+			WoopsiString path;							/**< Path of the directory. */
+			WoopsiArray<DirectoryReader::Entry> entries;	/**< Entries in the directory. */
+			s32 watch;									/**< Watch descriptor monitoring the directory. */
+			bool isComplete;							/**< True once the entries have been stored. */
+		} Listing;
+
+		WoopsiArray<Listing*> _listings;				/**< Listings ordered from most to least recently used. */
+		s32 _capacity;									/**< Maximum number of listings. */
+		s32 _inotifyFd;									/**< Inotify instance, or -1 if unavailable. */
+
+		/**
+		 * Find the listing for a directory.
+		 * @param path The path of the directory.
+		 * @return The index of the listing, or -1 if there is none.
+		 */
+		s32 findListing(const WoopsiString& path) const;
+
+		/**
+		 * Delete a listing and stop watching its directory.
+		 * @param index The index of the listing.
+		 */
+		void removeListing(const s32 index);
+
+		/**
+		 * Discard the listings of any directories that have changed.
+		 */
+		void processEvents();
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline DirectoryCache(const DirectoryCache& directoryCache) { };
+	};
+}
+
+#endif
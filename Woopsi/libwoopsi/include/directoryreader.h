@@ -0,0 +1,125 @@
+#ifndef _DIRECTORY_READER_H_
+#define _DIRECTORY_READER_H_
+
+#include <nds.h>
+#include "woopsiarray.h"
+#include "woopsistring.h"
+
+#include <dirent.h>
+
+namespace WoopsiUI {
+
+	/**
+	 * Reads the contents of a directory incrementally, so that a gadget can
+	 * display a large directory without blocking while it is read.
+	 *
+	 * In the SDL build the directory is read on a background thread.  Where
+	 * the platform's dirent structure provides d_type (as on Linux, where
+	 * readdir() is built on getdents64), entries are classified without
+	 * calling stat() on each one.  Entries are published to the reader's
+	 * queue in batches.
+	 *
+	 * On the DS there are no threads, so each call to read() reads the next
+	 * batch of entries from libfat.
+	 *
+	 * The "." entry is never reported.
+	 */
+	class DirectoryReader {
+	public:
+
+		/**
+		 * Struct describing a directory entry.
+		 */
+		typedef struct {
+			WoopsiString name;					/**< Name of the entry. */
+			bool isDirectory;					/**< True if the entry is a directory. */
+		} Entry;
+
+		/**
+		 * Constructor.
+		 */
+		DirectoryReader();
+
+		/**
+		 * Destructor.  Stops reading if a directory is open.
+		 */
+		~DirectoryReader();
+
+		/**
+		 * Start reading a directory.  Any directory that is already being read
+		 * is closed first.
+		 * @param path The path of the directory to read.
+		 */
+		void open(const WoopsiString& path);
+
+		/**
+		 * Stop reading the current directory and discard any entries that
+		 * have not been collected.
+		 */
+		void close();
+
+		/**
+		 * Append the entries that are ready to the supplied array.
+		 * @param entries Array to append the entries to.
+		 * @return The number of entries appended.
+		 */
+		s32 read(WoopsiArray<Entry>& entries);
+
+		/**
+		 * Check if every entry in the directory has been collected by read().
+		 * Also true if no directory is open or the directory could not be
+		 * opened.
+		 * @return True if there are no more entries to read.
+		 */
+		bool isComplete();
+
+	private:
+		char* _pathBuffer;						/**< Directory path with a trailing separator, followed by space for an entry name. */
+		s32 _pathLength;						/**< Length of the directory path in the buffer. */
+
+#ifdef USING_SDL
+		SDL_Thread* _thread;					/**< Thread reading the directory. */
+		SDL_mutex* _mutex;						/**< Guards the queue and completion flag. */
+		WoopsiArray<Entry> _queue;				/**< Entries read but not yet collected. */
+		bool _threadComplete;					/**< True once the thread has read every entry. */
+		volatile bool _cancelled;				/**< Set to stop the thread early. */
+
+		/**
+		 * Entry point of the reading thread.
+		 * @param data Pointer to the reader.
+		 * @return Always 0.
+		 */
+		static int threadEntry(void* data);
+
+		/**
+		 * Read the directory into the queue.  Runs on the reading thread.
+		 */
+		void readAll();
+
+		/**
+		 * Move a batch of entries into the queue.
+		 * @param batch The entries to move.  Cleared on return.
+		 */
+		void publish(WoopsiArray<Entry>& batch);
+#else
+		DIR* _dir;								/**< Directory being read, or NULL. */
+#endif
+
+		/**
+		 * Determine whether a directory entry is itself a directory.  Uses
+		 * the entry's type if it is known, and stat() otherwise.
+		 * @param ent The entry to examine.
+		 * @param isDirectory Populated with true if the entry is a directory.
+		 * @return False if the entry could not be examined and should be
+		 * skipped.
+		 */
+		bool getIsDirectory(const struct dirent* ent, bool& isDirectory);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline DirectoryReader(const DirectoryReader& directoryReader) { };
+	};
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define _TEXT_H_
 
 #include <nds.h>
+#include "defines.h"
 #include "fontbase.h"
 #include "woopsiarray.h"
 #include "woopsistring.h"
@@ -97,7 +98,7 @@ namespace WoopsiUI {
 		 * @param lineNumber The line number to check.
 		 * @return The number of characters in the line.
 		 */
-		const u8 getLineLength(const s32 lineNumber) const;
+		const s32 getLineLength(const s32 lineNumber) const;
 
 		/**
 		 * Get the number of characters in the specified line number, ignoring
@@ -105,14 +106,14 @@ namespace WoopsiUI {
 		 * @param lineNumber The line number to check.
 		 * @return The number of characters in the line.
 		 */
-		const s16 getLineTrimmedLength(const s32 lineNumber) const;
+		const s32 getLineTrimmedLength(const s32 lineNumber) const;
 
 		/**
 		 * Get the width in pixels of the specified line number.
 		 * @param lineNumber The line number to check.
 		 * @return The pixel width of the line.
 		 */
-		const s16 getLinePixelLength(const s32 lineNumber) const;
+		const s32 getLinePixelLength(const s32 lineNumber) const;
 
 		/**
 		 * Get the width in pixels of the specified line number, ignoring any
@@ -120,7 +121,7 @@ namespace WoopsiUI {
 		 * @param lineNumber The line number to check.
 		 * @return The pixel width of the line.
 		 */
-		const s16 getLineTrimmedPixelLength(const s32 lineNumber) const;
+		const s32 getLineTrimmedPixelLength(const s32 lineNumber) const;
 
 		/**
 		 * Get the total height of the text in pixels.
@@ -132,7 +133,7 @@ namespace WoopsiUI {
 		 * Get the width of the longest line in pixels.
 		 * @return The width of the longest line.
 		 */
-		inline const u8 getPixelWidth() const { return _textPixelWidth; };
+		inline const s32 getPixelWidth() const { return _textPixelWidth; };
 
 		/**
 		 * Get the pixel spacing between each line of text.
@@ -166,18 +167,40 @@ namespace WoopsiUI {
 		void stripTopLines(const s32 lines);
 		
 		/**
-		 * Wrap all of the text.
+		 * Wrap all of the text.  Every line is treated as changed.
 		 */
 		void wrap();
 
 		/**
 		 * Wrap the text from the line containing the specified char index
-		 * onwards.
+		 * onwards.  The text is assumed to have changed only at the specified
+		 * index, by the difference in length since the last wrap; lines
+		 * beyond the change that have the same content and position as
+		 * before are not reported as changed.
 		 * @param charIndex The index of the char to start wrapping from; note
-		 * that the wrapping function will re-wrap that entire line of text.
+		 * that the wrapping function will re-wrap that entire line of text
+		 * and the two lines before it.
 		 */
 		void wrap(s32 charIndex);
 
+		/**
+		 * Get the index of the first line changed by the most recent wrap.
+		 * Lines before this index have the same content and position as
+		 * before.
+		 * @return The index of the first changed line.
+		 */
+		inline const s32 getFirstChangedLine() const { return _firstChangedLine; };
+
+		/**
+		 * Get the index of the last line changed by the most recent wrap.
+		 * Lines after this index have the same content and position as
+		 * before.  If the wrap removed lines, this may be beyond the last
+		 * line of the text.
+		 * @return The index of the last changed line, or -1 if the document
+		 * has never contained any lines.
+		 */
+		inline const s32 getLastChangedLine() const { return _lastChangedLine; };
+
 		/**
 		 * Get the index of the line of text that contains the specified index
 		 * within the raw char array.
@@ -196,6 +219,14 @@ namespace WoopsiUI {
 		 */
 		const s32 getLineStartIndex(const s32 line) const { return _linePositions[line]; };
 
+		/**
+		 * Gets the offset in bytes within the UTF-8 encoded text of the start
+		 * of the line of text indicated by the line parameter.
+		 * @param line The line number to locate within the text.
+		 * @return The byte offset of the start of the supplied line.
+		 */
+		const s32 getLineStartOffset(const s32 line) const { return _lineOffsets[line]; };
+
 		/**
 		 * Get a reference to the internal string.  String is constant to
 		 * prevent it being changed without notifying the document.  Any change
@@ -211,17 +242,53 @@ namespace WoopsiUI {
 		 */
 		typedef struct {
 			s32 index;
-			u8 width;
+			s32 width;
 		} LongestLine;
 		
 		FontBase* _font;							/**< Font to be used for output */
 		WoopsiArray<s32> _linePositions;			/**< Array containing start indexes of each wrapped line */
+		WoopsiArray<s32> _lineOffsets;				/**< Array containing start byte offsets of each wrapped line */
 		WoopsiArray<LongestLine> _longestLines;		/**< Array containing data describing successively longer wrapped lines */
 		u8 _lineSpacing;							/**< Spacing between lines of text */
 		s32 _textPixelHeight;						/**< Total height of the wrapped text in pixels */
-		u8 _textPixelWidth;							/**< Total width of the wrapped text in pixels */
+		s32 _textPixelWidth;						/**< Total width of the wrapped text in pixels */
 		u16 _width;									/**< Width in pixels available to the text */
+		s32 _wrappedTextLength;						/**< Length of the text when it was last wrapped */
+		s32 _firstChangedLine;						/**< First line changed by the most recent wrap */
+		s32 _lastChangedLine;						/**< Last line changed by the most recent wrap */
 		WoopsiString _text;							/**< Content of the document. */
+		u8 _charWidths[DOCUMENT_WIDTH_TABLE_SIZE];	/**< Widths of the lowest code points in the current font */
+
+		/**
+		 * Fill the width table with the widths of the lowest code points in
+		 * the current font.  Must be called whenever the font changes.
+		 */
+		void buildWidthTable();
+
+		/**
+		 * Get the width of a character in the current font, using the width
+		 * table if possible.
+		 * @param codePoint The character to get the width of.
+		 * @return The width of the character in pixels.
+		 */
+		inline const u8 getCharWidth(const u32 codePoint) const {
+			return codePoint < (u32)DOCUMENT_WIDTH_TABLE_SIZE ? _charWidths[codePoint] : _font->getCharWidth(codePoint);
+		};
+
+		/**
+		 * Get the byte offset of the end of a line.
+		 * @param lineNumber The line number to check.
+		 * @return The byte offset immediately after the last byte of the line.
+		 */
+		const s32 getLineEndOffset(const s32 lineNumber) const;
+
+		/**
+		 * Get the width in pixels of a run of characters.
+		 * @param offset The byte offset of the first character.
+		 * @param length The number of characters to measure.
+		 * @return The width of the characters in pixels.
+		 */
+		const s32 getTextWidth(s32 offset, s32 length) const;
 	};
 }
 
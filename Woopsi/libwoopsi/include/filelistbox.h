@@ -3,6 +3,8 @@
 
 #include "scrollinglistbox.h"
 #include "filelistboxdataitem.h"
+#include "animatable.h"
+#include "directoryreader.h"
 #include "gadget.h"
 #include "gadgeteventhandler.h"
 #include "gadgetstyle.h"
@@ -27,8 +29,14 @@ namespace WoopsiUI {
 	 *
 	 * When using this class, ensure you call "fatInitDefault();" somewhere in
 	 * your setup code.
+	 *
+	 * Directories are read incrementally by a DirectoryReader.  Entries are
+	 * added to the list in batches once per frame as they become available,
+	 * so the list can be used while a large directory is still being read.
+	 * Complete listings are stored in Woopsi's DirectoryCache so that
+	 * returning to an unchanged directory does not read it again.
 	 */
-	class FileListBox : public Gadget, public GadgetEventHandler  {
+	class FileListBox : public Gadget, public GadgetEventHandler, public Animatable  {
 	public:
 
 		/**
@@ -54,6 +62,14 @@ namespace WoopsiUI {
 		 */
 		virtual void handleValueChangeEvent(Gadget& source);
 
+		/**
+		 * Add any directory entries that have been read since the last frame
+		 * to the list.  Called by the animator while the directory is being
+		 * read.
+		 * @return True if there are more entries to read.
+		 */
+		virtual bool animate();
+
 		/**
 		 * Add a new option to the gadget using default colours.
 		 * @param text Text to show in the option.
@@ -143,6 +159,24 @@ namespace WoopsiUI {
 			return _listbox->getOptionCount();
 		};
 
+		/**
+		 * Show only the files whose names contain the supplied term.
+		 * Matching ignores the case of ASCII letters.  Specify an empty string
+		 * to show all files.
+		 * @param filter The term to search for.
+		 */
+		virtual inline void setFilter(const WoopsiString& filter) {
+			_listbox->setFilter(filter);
+		};
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible files must contain.
+		 */
+		virtual inline const WoopsiString& getFilter() const {
+			return _listbox->getFilter();
+		};
+
 		/**
 		 * Set the displayed path.
 		 * @param path The new path.
@@ -163,6 +197,8 @@ namespace WoopsiUI {
 	protected:
 		ScrollingListBox* _listbox;			/**< Pointer to the list box */
 		FilePath* _path;					/**< Path currently displayed */
+		DirectoryReader _reader;			/**< Reads the current directory. */
+		WoopsiArray<DirectoryReader::Entry> _entries;	/**< Entries read so far from the current directory, or the latest batch if the listing will not be cached. */
 
 		/**
 		 * Draw the area of this gadget that falls within the clipping region.
@@ -185,9 +221,29 @@ namespace WoopsiUI {
 		virtual ~FileListBox();
 
 		/**
-		 * Populate list with directory data.
+		 * Populate list with directory data.  The list is cleared immediately
+		 * and filled in over the following frames.
 		 */
 		virtual void readDirectory();
+
+		/**
+		 * Add directory entries to the list.
+		 * @param entries The entries to add.
+		 * @param first The index of the first entry to add.
+		 */
+		void addEntries(const WoopsiArray<DirectoryReader::Entry>& entries, const s32 first);
+
+		/**
+		 * Register with the animator so that entries are added as they are
+		 * read.
+		 */
+		void startReading();
+
+		/**
+		 * Stop reading the current directory and unregister from the
+		 * animator.
+		 */
+		void stopReading();
 		
 		/**
 		 * Copy constructor is protected to prevent usage.
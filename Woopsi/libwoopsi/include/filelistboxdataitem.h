@@ -26,7 +26,7 @@ namespace WoopsiUI {
 		 * @param isDirectory True indicates that the item is a directory; false
 		 * indicates that it is a file.
 		 */
-		FileListBoxDataItem(const char* text, const u32 value,
+		FileListBoxDataItem(const WoopsiString& text, const u32 value,
 			const u16 normalTextColour,
 			const u16 normalBackColour,
 			const u16 selectedTextColour,
@@ -53,6 +53,14 @@ namespace WoopsiUI {
 		 */
 		virtual s8 compareTo(const ListDataItem* item) const;
 
+		/**
+		 * Get a key that allows most comparisons to be made without calling
+		 * compareTo().  The top bit of the key places directories before
+		 * files; the remaining bits hold the text sort key.
+		 * @return The sort key.
+		 */
+		virtual u32 getSortKey() const;
+
 	private:
 		bool _isDirectory;						/**< True if the option is a directory. */
 	};
@@ -164,6 +164,24 @@ namespace WoopsiUI {
 			return _listbox->getOptionCount();
 		};
 
+		/**
+		 * Show only the files whose names contain the supplied term.
+		 * Matching ignores the case of ASCII letters.  Specify an empty string
+		 * to show all files.
+		 * @param filter The term to search for.
+		 */
+		virtual inline void setFilter(const WoopsiString& filter) {
+			_listbox->setFilter(filter);
+		};
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible files must contain.
+		 */
+		virtual inline const WoopsiString& getFilter() const {
+			return _listbox->getFilter();
+		};
+
 		/**
 		 * Set the displayed path.
 		 * @param path The new path.
@@ -0,0 +1,131 @@
+#ifndef _FRAME_ARENA_H_
+#define _FRAME_ARENA_H_
+
+#include <nds.h>
+#include <new>
+
+namespace WoopsiUI {
+
+	/**
+	 * Bump allocator for objects that only live for a single frame.  Memory is
+	 * handed out by advancing a pointer through a pre-allocated block, and is
+	 * reclaimed all at once when reset() is called.  Woopsi owns an instance
+	 * and resets it once per VBL, after all damaged rects have been redrawn.
+	 *
+	 * Individual allocations cannot be freed.  Objects created in the arena
+	 * with placement new must have their destructors called explicitly and
+	 * must not be deleted.  No object allocated from the arena can be used
+	 * after the arena has been reset.
+	 *
+	 * Strictly nested allocations, such as the graphics ports created while a
+	 * gadget redraws a single rect, can be released early by rewinding the
+	 * arena to a marker taken before they were allocated.  This keeps the
+	 * arena small when a frame redraws a large number of rects.
+	 *
+	 * If a frame needs more memory than the arena holds, additional blocks
+	 * are allocated.  When the arena is next reset, the blocks are replaced
+	 * with a single block large enough to hold everything, so that a steady
+	 * workload settles into a single block and performs no heap allocations.
+	 */
+	class FrameArena {
+	public:
+
+		/**
+		 * Records a position within the arena.
+		 * @see getMarker()
+		 * @see rewind()
+		 */
+		typedef struct {
+			void* block;					/**< Block that was current when the marker was taken. */
+			u32 offset;						/**< Offset within the block. */
+			u32 usedSize;					/**< Bytes allocated when the marker was taken. */
+		} Marker;
+
+		/**
+		 * Constructor.
+		 * @param blockSize Initial size of the arena in bytes.
+		 */
+		FrameArena(u32 blockSize);
+
+		/**
+		 * Destructor.
+		 */
+		~FrameArena();
+
+		/**
+		 * Allocate memory from the arena.  The memory is aligned to 8 bytes.
+		 * @param size The number of bytes to allocate.
+		 * @return A pointer to the allocated memory.
+		 */
+		void* allocate(u32 size);
+
+		/**
+		 * Release all memory allocated from the arena so that it can be
+		 * reused.
+		 */
+		void reset();
+
+		/**
+		 * Get a marker representing the current position within the arena.
+		 * @return A marker that can be passed to rewind().
+		 */
+		Marker getMarker() const;
+
+		/**
+		 * Release all memory allocated since the supplied marker was taken.
+		 * Any objects allocated since then must already have been destroyed.
+		 * @param marker A marker previously returned by getMarker().
+		 */
+		void rewind(const Marker& marker);
+
+		/**
+		 * Get the number of bytes allocated since the arena was last reset.
+		 * @return The number of bytes allocated.
+		 */
+		inline const u32 getUsedSize() const { return _usedSize; };
+
+		/**
+		 * Get the total number of bytes that the arena can hand out before it
+		 * must allocate more memory.
+		 * @return The capacity of the arena.
+		 */
+		const u32 getCapacity() const;
+
+	private:
+
+		/**
+		 * A single chunk of arena memory.  Blocks are chained together when
+		 * a frame overflows the first block.
+		 */
+		typedef struct Block {
+			struct Block* next;				/**< Next block in the chain. */
+			u8* data;						/**< Block memory. */
+			u32 size;						/**< Size of the block in bytes. */
+			u32 offset;						/**< Offset of the first free byte. */
+		} Block;
+
+		Block* _head;						/**< First block in the chain. */
+		Block* _current;					/**< Block currently being allocated from. */
+		u32 _usedSize;						/**< Bytes allocated since the last reset. */
+
+		/**
+		 * Create a new block.
+		 * @param size Size of the block in bytes.
+		 * @return The new block.
+		 */
+		Block* newBlock(u32 size);
+
+		/**
+		 * Delete the supplied block and all blocks chained after it.
+		 * @param block The first block to delete.
+		 */
+		void deleteBlocks(Block* block);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline FrameArena(const FrameArena& frameArena) { };
+	};
+}
+
+#endif
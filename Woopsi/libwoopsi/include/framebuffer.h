@@ -3,6 +3,8 @@
 
 #include <nds.h>
 #include "mutablebitmapbase.h"
+#include "rect.h"
+#include "woopsiarray.h"
 
 namespace WoopsiUI {
 
@@ -17,6 +19,10 @@ namespace WoopsiUI {
 	 * The FrameBuffer class automatically switches from using the DS'
 	 * framebuffer (more accurately, a 16-bit background) to using an SDL
 	 * surface if Woopsi is compiled in SDL mode.
+	 *
+	 * The framebuffer can optionally keep track of the areas that have been
+	 * written to.  The SDL build uses this to upload only the changed parts
+	 * of the display each frame.
 	 */
 	class FrameBuffer : public MutableBitmapBase {
 	public:
@@ -46,7 +52,40 @@ namespace WoopsiUI {
 		/**
 		 * Destructor.
 		 */
-		virtual inline ~FrameBuffer() { };
+		virtual ~FrameBuffer();
+
+		/**
+		 * Enable or disable tracking of the areas that have been written to.
+		 * The entire bitmap is considered dirty when tracking is enabled.
+		 * @param isEnabled True to enable tracking.
+		 */
+		void setDirtyTrackingEnabled(bool isEnabled);
+
+		/**
+		 * Check if any part of the bitmap has been written to since the dirty
+		 * area was last cleared.  Always returns false if tracking is
+		 * disabled.
+		 * @return True if the bitmap is dirty.
+		 */
+		inline bool isDirty() const { return _dirtyTop < _dirtyBottom; };
+
+		/**
+		 * Get the areas of the bitmap that have been written to since the
+		 * dirty area was last cleared.  Consecutive dirty rows are merged
+		 * into a single rect.
+		 * @param rects Array to append the dirty rects to.
+		 */
+		void getDirtyRects(WoopsiArray<Rect>& rects) const;
+
+		/**
+		 * Mark the entire bitmap as clean.
+		 */
+		void clearDirty();
+
+		/**
+		 * Mark the entire bitmap as dirty.
+		 */
+		void markAllDirty();
 		
 		/**
 		 * Get a pointer to the internal bitmap.
@@ -126,6 +165,27 @@ namespace WoopsiUI {
 
 		u16 _width;									/**< Width of the bitmap */
 		u16 _height;								/**< Height of the bitmap */
+		s16* _dirtyLeft;							/**< Left edge of the dirty span of each row, or NULL if tracking is disabled. */
+		s16* _dirtyRight;							/**< Right edge (exclusive) of the dirty span of each row. */
+		s16 _dirtyTop;								/**< First dirty row. */
+		s16 _dirtyBottom;							/**< Row after the last dirty row. */
+
+		/**
+		 * Record that pixels have been written.  Writes that run off the end
+		 * of a row wrap onto the next row.
+		 * @param x The x co-ordinate of the first pixel.
+		 * @param y The y co-ordinate of the first pixel.
+		 * @param size The number of pixels written.
+		 */
+		void markDirty(s16 x, s16 y, u32 size);
+
+		/**
+		 * Record that a span of pixels within a single row has been written.
+		 * @param y The row.
+		 * @param x1 The x co-ordinate of the first pixel.
+		 * @param x2 The x co-ordinate after the last pixel.
+		 */
+		void markRowDirty(s16 y, s16 x1, s16 x2);
 	};
 }
 
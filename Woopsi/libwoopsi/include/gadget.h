@@ -10,14 +10,20 @@
 #include "hardware.h"
 #include "pad.h"
 #include "rect.h"
+#include "slaballocator.h"
 #include "woopsiarray.h"
+#include "woopsismallarray.h"
 #include "woopsistring.h"
 
 namespace WoopsiUI {
 
+	class BackingStore;
 	class GraphicsPort;
 	class FontBase;
+	class FrameArena;
 	class RectCache;
+	class Region;
+	class SpatialGrid;
 
 	/**
 	 * Class providing all the basic functionality of a Woopsi gadget.
@@ -46,6 +52,7 @@ namespace WoopsiUI {
 			u8 modal : 1;						/**< True if the gadget is modal. */
 			u8 canReceiveFocus : 1;				/**< True if the gadget can receive focus. */
 			u8 raisesEvents : 1;				/**< True if the gadget raises events to its handler. */
+			u8 opaque : 1;						/**< True if the gadget paints every pixel of its rect. */
 		} Flags;
 
 		/**
@@ -80,15 +87,70 @@ namespace WoopsiUI {
 		 * @see GadgetFlagType.
 		 */
 		Gadget(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style = NULL);
+
+		/**
+		 * Allocates memory for a gadget from the gadget slab allocator.
+		 * Gadgets are created and deleted frequently (menus, requesters,
+		 * list items), so reusing slots of the same size avoids fragmenting
+		 * the heap.
+		 * @param size The size of the object.
+		 * @return Memory for the object.
+		 */
+		static void* operator new(size_t size);
+
+		/**
+		 * Releases memory allocated by operator new.
+		 * @param data The memory to release.
+		 * @param size The size of the object.
+		 */
+		static void operator delete(void* data, size_t size);
+
+		/**
+		 * Get the slab allocator used for gadgets and their rect caches.
+		 * The allocator is created the first time it is needed.
+		 * @return The gadget slab allocator.
+		 */
+		static SlabAllocator& getAllocator();
+
+		/**
+		 * Redirect all drawing performed by redraw() to an off-screen bitmap
+		 * instead of the display.  Used to render gadgets into backing
+		 * stores.  Drawing performed outside of redraw() is not affected.
+		 * @param bitmap The bitmap to draw to, or NULL to draw to the display.
+		 * @param x The Woopsi-space x co-ordinate of the bitmap's left edge.
+		 * @param y The Woopsi-space y co-ordinate of the bitmap's top edge.
+		 */
+		static void setRenderTarget(FrameBuffer* bitmap, s16 x = 0, s16 y = 0);
+
+		/**
+		 * Get the bitmap that redraw() is drawing to.
+		 * @return The render target, or NULL if drawing to the display.
+		 * @see setRenderTarget()
+		 */
+		static inline FrameBuffer* getRenderTarget() { return _renderTarget; };
+
+		/**
+		 * Get the Woopsi-space x co-ordinate of the render target.
+		 * @return The x co-ordinate of the render target.
+		 */
+		static inline s16 getRenderTargetX() { return _renderTargetX; };
+
+		/**
+		 * Get the Woopsi-space y co-ordinate of the render target.
+		 * @return The y co-ordinate of the render target.
+		 */
+		static inline s16 getRenderTargetY() { return _renderTargetY; };
 		
 		/**
-		 * Get the x co-ordinate of the gadget in "Woopsi space".
+		 * Get the x co-ordinate of the gadget in "Woopsi space".  The value
+		 * is cached until any gadget moves or changes state.
 		 * @return Woopsi space x co-ordinate.
 		 */
 		const s16 getX() const;
 
 		/**
-		 * Get the y co-ordinate of the gadget in "Woopsi space".
+		 * Get the y co-ordinate of the gadget in "Woopsi space".  The value
+		 * is cached until any gadget moves or changes state.
 		 * @return Woopsi space y co-ordinate.
 		 */
 		const s16 getY() const;
@@ -120,9 +182,10 @@ namespace WoopsiUI {
 		inline const bool hasFocus() const { return _flags.hasFocus; };
 
 		/**
-		 * Has the gadget been marked for deletion?  This function recurses up
-		 * the gadget hierarchy and only returns true if all of the gadgets in
-		 * the ancestor chain are not deleted.  
+		 * Has the gadget been marked for deletion?  This function checks the
+		 * gadget hierarchy and returns true if any of the gadgets in the
+		 * ancestor chain are deleted.  The result is cached until any gadget
+		 * moves or changes state.
 		 * Gadgets marked for deletion are automatically deleted and should not
 		 * be interacted with.
 		 * @return True if marked for deletion.
@@ -130,25 +193,27 @@ namespace WoopsiUI {
 		const bool isDeleted() const;
 
 		/**
-		 * Is the gadget allowed to draw?  This function recurses up the gadget
+		 * Is the gadget allowed to draw?  This function checks the gadget
 		 * hierarchy and only returns true if all of the gadgets in the ancestor
-		 * chain are visible.
+		 * chain are visible.  The result is cached until any gadget moves or
+		 * changes state.
 		 * @return True if drawing is enabled.
 		 */
 		const bool isDrawingEnabled() const;
 
 		/**
-		 * Is the gadget hidden?  This function recurses up the gadget
-		 * hierarchy and returns true if any of the gadgets in the ancestor
-		 * chain are hidden.
+		 * Is the gadget hidden?  This function checks the gadget hierarchy and
+		 * returns true if any of the gadgets in the ancestor chain are hidden.
+		 * The result is cached until any gadget moves or changes state.
 		 * @return True if hidden.
 		 */
 		const bool isHidden() const;
 
 		/**
-		 * Is the gadget enabled?  This function recurses up the gadget
-		 * hierarchy and only returns true if all of the gadgets in the ancestor
-		 * chain are enabled.
+		 * Is the gadget enabled?  This function checks the gadget hierarchy
+		 * and only returns true if all of the gadgets in the ancestor chain
+		 * are enabled.  The result is cached until any gadget moves or changes
+		 * state.
 		 * @return True if enabled.
 		 */
 		const bool isEnabled() const;
@@ -174,6 +239,17 @@ namespace WoopsiUI {
 		 */
 		inline const bool isPermeable() const { return _flags.permeable; };
 
+		/**
+		 * Does the gadget paint every pixel within its rect when it is
+		 * redrawn?  Opaque gadgets hide everything beneath them, so the
+		 * gadgets below them are not redrawn in the area they cover.  The
+		 * area beneath a non-opaque gadget is redrawn by the gadgets below it
+		 * before the gadget itself is redrawn.  Gadgets are opaque by default.
+		 * Layers with an alpha value of less than 255 are never opaque.
+		 * @return True if opaque.
+		 */
+		inline const bool isOpaque() const { return _flags.opaque && (_layerAlpha == 255); };
+
 		/**
 		 * Is the gadget double-clickable?  If this is false, double-clicks will
 		 * be detected and processed as single-clicks.
@@ -300,16 +376,19 @@ namespace WoopsiUI {
 		 * will occur.  This should only be called by the Woopsi hierarchy.
 		 * @param clipRect The region to clip to.  Co-ordinates are in Woopsi-
 		 * space.
+		 * @param arena Optional frame arena to allocate the port from.  If
+		 * set, the port must be destroyed by calling its destructor rather
+		 * than deleted.
 		 * @return A pointer to a new GraphicsPort object.
 		 */
-		GraphicsPort* newGraphicsPort(Rect clipRect);
+		GraphicsPort* newGraphicsPort(Rect clipRect, FrameArena* arena = NULL);
 
 		/**
-		 * Gets a pointer to the vector of all of the visible regions of this
-		 * gadget, including any covered by children.
-		 * @return A pointer to a vector of all visible regions.
+		 * Gets a pointer to the visible region of this gadget, including any
+		 * area covered by children.
+		 * @return A pointer to the visible region.
 		 */
-		WoopsiArray<Rect>* getForegroundRegions();
+		const Region* getForegroundRegion();
 
 		/**
 		 * Gets a pointer to the gadget's font.
@@ -398,6 +477,15 @@ namespace WoopsiUI {
 		 */
 		inline void setPermeable(const bool isPermeable) { _flags.permeable = isPermeable; };
 
+		/**
+		 * Sets whether or not this gadget paints every pixel within its rect.
+		 * Gadgets that leave parts of their rects unpainted, such as
+		 * borderless labels without a background, should be made non-opaque.
+		 * @param isOpaque The opaque state.
+		 * @see isOpaque()
+		 */
+		void setOpaque(const bool isOpaque);
+
 		/**
 		 * Sets whether or not the gadgets processes double-clicks.
 		 * @param isDoubleClickable The double-clickable state.
@@ -788,7 +876,8 @@ namespace WoopsiUI {
 		 * Invalidate the visible region cache for all gadgets below the
 		 * supplied gadget in this gadget's child stack.  This will cause those
 		 * gadgets to recalculate their visible regions next time they try to
-		 * draw themselves.
+		 * draw themselves.  Only the parts of the lower gadgets' hierarchies
+		 * that overlap the supplied gadget are invalidated.
 		 * This should be called when the gadget passed as a pointer has swapped
 		 * positions with another gadget in the gadget array (ie. it has moved
 		 * towards the front of the screen or towards the back).
@@ -796,6 +885,17 @@ namespace WoopsiUI {
 		 */
 		void invalidateLowerGadgetsVisibleRectCache(Gadget* gadget);
 
+		/**
+		 * Invalidate the visible region cache for the parts of the hierarchies
+		 * of all gadgets below the supplied gadget that overlap the supplied
+		 * rect.  Should be called with the gadget's old and new rects when
+		 * it moves or changes size.
+		 * @param gadget A pointer to a child gadget.
+		 * @param rect The area that has been covered or exposed, in
+		 * Woopsi-space.
+		 */
+		void invalidateLowerGadgetsVisibleRectCache(Gadget* gadget, const Rect& rect);
+
 		/**
 		 * Adds a gadget to this gadget's child stack.  The gadget is added to
 		 * the top of the stack.  Note that the gadget can only be added if it
@@ -837,7 +937,7 @@ namespace WoopsiUI {
 		 * be called in user code.
 		 * @param parent A pointer to the parent gadget.
 		 */
-		inline void setParent(Gadget* parent) { _parent = parent; };
+		void setParent(Gadget* parent);
 
 		/**
 		 * Rebuild the list of this gadget's visible regions.  If the cache is
@@ -851,6 +951,17 @@ namespace WoopsiUI {
 		 */
 		void invalidateVisibleRectCache();
 
+		/**
+		 * Mark this gadget's visible region cache as invalid if the gadget
+		 * overlaps the supplied rect, and do the same to its child gadgets.
+		 * Gadgets that do not overlap the rect, and their children, keep their
+		 * caches.  Should be called when the area covered by a gadget
+		 * higher up the z-order has changed.
+		 * @param rect The area that has been covered or exposed, in
+		 * Woopsi-space.
+		 */
+		void invalidateVisibleRectCache(const Rect& rect);
+
 		/**
 		 * Clips a rectangular region to the dimensions of this gadget and its
 		 * ancestors.
@@ -1016,6 +1127,89 @@ namespace WoopsiUI {
 		 */
 		void markRectDamaged(const Rect& rect);
 
+		/**
+		 * Enable or disable the spatial index of child gadgets.  When enabled,
+		 * the gadget keeps a grid recording which children overlap each area
+		 * of the gadget.  Clicks and redraws then only examine the children
+		 * under the stylus or damaged area, rather than every child.  This is
+		 * worthwhile for gadgets with large numbers of children, such as
+		 * keyboards and grids of buttons.  The index is rebuilt when needed
+		 * after children are added, removed, moved, resized or re-ordered.
+		 * @param isEnabled True to enable the index; false to disable it.
+		 */
+		void setSpatialIndexEnabled(bool isEnabled);
+
+		/**
+		 * Check if the spatial index of child gadgets is enabled.
+		 * @return True if the index is enabled.
+		 * @see setSpatialIndexEnabled()
+		 */
+		inline const bool isSpatialIndexEnabled() const { return _spatialGrid != NULL; };
+
+		/**
+		 * Mark the spatial index of child gadgets as out of date.  Called
+		 * automatically when children change; only needs to be called
+		 * manually if a subclass alters a child's rect directly.
+		 */
+		void invalidateSpatialIndex();
+
+		/**
+		 * Enable or disable layer mode.  A layer renders itself and its
+		 * children into its own off-screen surface.  When part of a layer
+		 * needs redrawing, only the parts of the surface that have changed
+		 * since the layer was last drawn are re-rendered, and the display is
+		 * then assembled from the surface.  Changes to gadgets beneath a
+		 * translucent layer therefore do not cause the layer's gadgets to be
+		 * redrawn.  Layers use as much memory as a bitmap the size of the
+		 * layer.
+		 *
+		 * Gadgets within a layer that draw directly to the display outside
+		 * of redraw() are re-rendered the next time that part of the layer is
+		 * redrawn.
+		 * @param isEnabled True to make the gadget a layer.
+		 */
+		void setLayerEnabled(bool isEnabled);
+
+		/**
+		 * Check if the gadget is a layer.
+		 * @return True if the gadget is a layer.
+		 * @see setLayerEnabled()
+		 */
+		inline const bool isLayer() const { return _layer != NULL; };
+
+		/**
+		 * Get the layer's surface.
+		 * @return The layer's surface, or NULL if the gadget is not a layer.
+		 */
+		inline BackingStore* getLayer() const { return _layer; };
+
+		/**
+		 * Set the opacity of the layer.  Layers with an alpha value of less
+		 * than 255 are blended with the gadgets beneath them and are treated
+		 * as non-opaque.  The opaque state set with setOpaque() is kept and
+		 * applies again once the alpha value returns to 255.
+		 * @param alpha The opacity, from 0 (invisible) to 255 (solid).
+		 */
+		void setLayerAlpha(u8 alpha);
+
+		/**
+		 * Get the opacity of the layer.
+		 * @return The opacity of the layer.
+		 * @see setLayerAlpha()
+		 */
+		inline const u8 getLayerAlpha() const { return _layerAlpha; };
+
+		/**
+		 * Get the indices of all children that may intersect the supplied
+		 * rect, topmost first.  Uses the spatial index if it is enabled.
+		 * @param rect The rect to check, in Woopsi-space.
+		 * @param indices Array to append the indices to.
+		 * @return False if the spatial index is disabled or the rect covers
+		 * too much of the gadget to benefit from it.  In that case the array
+		 * is not populated and the caller should examine every child.
+		 */
+		bool getGadgetsIntersecting(const Rect& rect, WoopsiArray<s32>& indices);
+
 	protected:
 		Rect _rect;								/**< Rect describing the gadget. */
 		u32 _refcon;							/**< Identifying number of the gadget. */
@@ -1044,8 +1238,8 @@ namespace WoopsiUI {
 		// Hierarchy control
 		Gadget* _parent;						/**< Pointer to the gadget's parent. */
 		Gadget* _focusedGadget;					/**< Pointer to the child gadget that has focus. */
-		WoopsiArray<Gadget*> _gadgets;			/**< List of child gadgets. */
-		WoopsiArray<Gadget*> _shelvedGadgets;	/**< List of shelved child gadgets. */
+		WoopsiSmallArray<Gadget*, 4> _gadgets;	/**< List of child gadgets. */
+		WoopsiSmallArray<Gadget*, 1> _shelvedGadgets;	/**< List of shelved child gadgets. */
 
 		// Decorations
 		s32 _decorationCount;					/**< Total number of decoration child gadgets. */
@@ -1053,10 +1247,35 @@ namespace WoopsiUI {
 		// Visible regions
 		RectCache* _rectCache;					/**< List of the gadget's visible regions. */
 
+		// Child hit-testing
+		SpatialGrid* _spatialGrid;				/**< Optional index of child gadget positions. */
+		BackingStore* _layer;					/**< Surface used if the gadget is a layer. */
+		u8 _layerAlpha;							/**< Opacity of the layer. */
+
+		/**
+		 * Effective state of the gadget, taking its ancestors into account.
+		 */
+		typedef struct {
+			u8 deleted : 1;						/**< True if the gadget or an ancestor is deleted. */
+			u8 drawingEnabled : 1;				/**< True if the gadget and all ancestors are visible. */
+			u8 hidden : 1;						/**< True if the gadget or an ancestor is not visible. */
+			u8 enabled : 1;						/**< True if the gadget and all ancestors are enabled and visible. */
+		} CachedState;
+
+		// Cached hierarchy state
+		mutable u32 _cachedStateGeneration;		/**< State generation in which the cached values were calculated. */
+		mutable s16 _cachedX;					/**< Cached Woopsi-space x co-ordinate. */
+		mutable s16 _cachedY;					/**< Cached Woopsi-space y co-ordinate. */
+		mutable CachedState _cachedState;		/**< Cached effective state. */
+		static u32 _stateGeneration;			/**< Incremented whenever any gadget moves or changes state. */
+		static FrameBuffer* _renderTarget;		/**< Bitmap that redraw() draws to instead of the display. */
+		static s16 _renderTargetX;				/**< Woopsi-space x co-ordinate of the render target. */
+		static s16 _renderTargetY;				/**< Woopsi-space y co-ordinate of the render target. */
+
 		GadgetBorderSize _borderSize;			/**< Size of the gadget borders. */
 
 		// Context menu item definitions
-		WoopsiArray<NameValuePair> _contextMenuItems;	/**< List of all context menu name/value pairs. */
+		WoopsiSmallArray<NameValuePair, 1> _contextMenuItems;	/**< List of all context menu name/value pairs. */
 
 		/**
 		 * Destructor.
@@ -1142,9 +1361,13 @@ namespace WoopsiUI {
 		 * Note that the clipping rect should be clipped to the gadget's visible
 		 * region before creating the graphics port.  The rect should be in
 		 * Woopsi-space co-ordinates.
+		 * @param clipRect The region to clip to.
+		 * @param arena Optional frame arena to allocate the port from.  If
+		 * set, the port must be destroyed by calling its destructor rather
+		 * than deleted.
 		 * @return A new graphics port object.
 		 */
-		GraphicsPort* newInternalGraphicsPort(Rect clipRect);
+		GraphicsPort* newInternalGraphicsPort(Rect clipRect, FrameArena* arena = NULL);
 
 		/**
 		 * Get the index of the next visible gadget higher up the z-order.
@@ -1153,6 +1376,38 @@ namespace WoopsiUI {
 		 */
 		const s32 getHigherVisibleGadget(const s32 startIndex) const;
 
+		/**
+		 * Get the indices of all children that may contain the supplied
+		 * point, topmost first.  Uses the spatial index if it is enabled.
+		 * @param x The x co-ordinate of the point, in Woopsi-space.
+		 * @param y The y co-ordinate of the point, in Woopsi-space.
+		 * @param indices Array to append the indices to.
+		 * @return False if the spatial index is disabled.  In that case the
+		 * array is not populated and the caller should examine every child.
+		 */
+		bool getGadgetsAt(s16 x, s16 y, WoopsiArray<s32>& indices);
+
+		/**
+		 * Invalidate the cached Woopsi-space co-ordinates and effective state
+		 * of every gadget.  Must be called whenever a gadget's position,
+		 * parent, or deleted, shelved, hidden or enabled flags change.
+		 * Subclasses that alter _rect or _flags directly must call this.
+		 */
+		static void invalidateCachedState();
+
+		/**
+		 * Recalculate the cached Woopsi-space co-ordinates and effective
+		 * state from the gadget's parent.
+		 */
+		void updateCachedState() const;
+
+		/**
+		 * Mark part of the surfaces of all layers that contain this gadget,
+		 * including the gadget itself, as out of date.
+		 * @param rect The rect that has changed, in Woopsi-space.
+		 */
+		void markLayersDamaged(const Rect& rect) const;
+
 		/**
 		 * Get the index of the next visible gadget lower down the z-order.
 		 * @param startIndex The starting index.
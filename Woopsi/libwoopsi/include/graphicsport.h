@@ -4,11 +4,13 @@
 #include <nds.h>
 #include "gadget.h"
 #include "woopsiarray.h"
+#include "region.h"
 #include "graphics.h"
 
 namespace WoopsiUI {
 	
 	class FontBase;
+	class FrameArena;
 	class FrameBuffer;
 	class BitmapBase;
 	
@@ -81,19 +83,20 @@ namespace WoopsiUI {
 		 * can draw.
 		 * @param isEnabled Set this to false to disable all drawing commands.
 		 * @param bitmap The bitmap that the port will draw to. 
-		 * @param clipRectList An array of clipping regions within which the
-		 * class must draw.  If set, clipRect must be NULL.
-		 * @param clipRect The clipping region within which the class must draw.
-		 * If set, clipRectList must be NULL.
-		 */
-		GraphicsPort(const s16 x, const s16 y, const u16 width, const u16 height, const bool isEnabled, FrameBuffer* bitmap, const WoopsiArray<Rect>* clipRectList, const Rect* clipRect);
+		 * @param clipRegion The clipping region within which the class must
+		 * draw.  If set, clipRect must be NULL.
+		 * @param clipRect The clipping rect within which the class must draw.
+		 * If set, clipRegion must be NULL.
+		 * @param arena Optional frame arena from which the port's Graphics
+		 * object is allocated.  Should only be set if the port itself is
+		 * allocated from the same arena.
+		 */
+		GraphicsPort(const s16 x, const s16 y, const u16 width, const u16 height, const bool isEnabled, FrameBuffer* bitmap, const Region* clipRegion, const Rect* clipRect, FrameArena* arena = NULL);
 		
 		/**
 		 * Destructor.
 		 */
-		virtual inline ~GraphicsPort() {
-			delete _graphics;
-		};
+		virtual ~GraphicsPort();
 
 		/**
 		 * Sets the clip rect.  Attempts to draw outside of this region
@@ -115,6 +118,20 @@ namespace WoopsiUI {
 		 */
 		void getClipRect(Rect& rect) const;
 
+		/**
+		 * Set the Woopsi-space co-ordinates of the top-left pixel of the
+		 * bitmap that the port draws to.  By default this is the top-left
+		 * pixel of the display that the port is on.  Ports that draw to an
+		 * off-screen bitmap holding a copy of part of the display must set
+		 * this to the position of that part.
+		 * @param x The x co-ordinate of the bitmap.
+		 * @param y The y co-ordinate of the bitmap.
+		 */
+		inline void setBitmapOrigin(s16 x, s16 y) {
+			_bitmapX = x;
+			_bitmapY = y;
+		};
+
 		/**
 		 * Return the x co-ordinate of the graphics port.
 		 * @return The x co-ordinate of the graphics port.
@@ -427,11 +444,13 @@ namespace WoopsiUI {
 		virtual void drawFilledEllipse(s16 xCentre, s16 yCentre, s16 horizRadius, s16 vertRadius, u16 colour);
 
 	private:
-		WoopsiArray<Rect> _clipRectList;		/**< List of rects that the port must draw within. */
+		Region _clipRegion;						/**< Region that the port must draw within. */
 		Rect _rect;								/**< Total area that the port can draw within. */
 		bool _isEnabled;						/**< If false, nothing will be drawn. */
 		Graphics* _graphics;					/**< Used to draw to the bitmap. */
-		bool _isTopScreen;						/**< True if drawing to the top screen. */
+		s16 _bitmapX;							/**< Woopsi-space x co-ordinate of the bitmap's left edge. */
+		s16 _bitmapY;							/**< Woopsi-space y co-ordinate of the bitmap's top edge. */
+		bool _isGraphicsInArena;				/**< True if the Graphics object was allocated from a frame arena. */
 		
 		void convertPortToScreenSpace(s16* x, s16* y);
 		void addClipRect(const Rect& clipRect);
@@ -63,6 +63,16 @@ namespace WoopsiUI {
 		 */
 		static void waitForVBlank();
 
+		/**
+		 * Sleep until an input event arrives or the timeout expires.  Should
+		 * only be called when nothing will change until the next input event.
+		 * The DS build does nothing as waitForVBlank() already halts the CPU
+		 * until the next frame.
+		 * @param timeout The maximum time to wait in milliseconds.
+		 * @return The time spent waiting in milliseconds.
+		 */
+		static u32 waitForEvent(u32 timeout);
+
 		/**
 		 * Get a pointer to the FrameBuffer object that wraps around the top
 		 * frame buffer VRAM.
@@ -94,6 +104,17 @@ namespace WoopsiUI {
 		static SDL_Texture* _texture;
 		static u16* _topBitmap;
 		static u16* _bottomBitmap;
+		static bool _isPresentRequired;			/**< True if the window must be presented even if nothing has been drawn. */
+
+		/**
+		 * Upload the dirty parts of a framebuffer to the texture and mark the
+		 * framebuffer as clean.
+		 * @param buffer The framebuffer to upload.
+		 * @param textureY The y co-ordinate of the framebuffer within the
+		 * texture.
+		 * @return True if anything was uploaded.
+		 */
+		static bool uploadDirtyRects(FrameBuffer* buffer, s16 textureY);
 
 #endif
 
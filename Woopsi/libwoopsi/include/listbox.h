@@ -17,6 +17,10 @@ namespace WoopsiUI {
 	 * an option can be made to automatically select and close a window/etc.
 	 * The options themselves have user-definable text and background colours
 	 * for their selected and unselected states.
+	 *
+	 * Options can be supplied on demand by a ListDataProvider instead of being
+	 * added individually.  Only the options in the visible rows are requested
+	 * when the list is drawn.
 	 */
 	class ListBox : public ListBoxBase, public ScrollingPanel, public ListDataEventHandler {
 	public:
@@ -47,6 +51,14 @@ namespace WoopsiUI {
 		 */
 		virtual void addOption(ListBoxDataItem* option);
 
+		/**
+		 * Add a range of options to the gadget.  The gadget is only updated
+		 * once all of the options have been added.
+		 * @param options Array of options to add.
+		 * @param count The number of options in the array.
+		 */
+		virtual void addOptions(ListBoxDataItem* const* options, const s32 count);
+
 		/**
 		 * Remove an option from the gadget by its index.
 		 * @param index The index of the option to remove.
@@ -58,6 +70,63 @@ namespace WoopsiUI {
 		 */
 		virtual void removeAllOptions();
 
+		/**
+		 * Use a data provider to supply the options instead of storing them
+		 * in the gadget.  Any existing options are removed.  The provider must
+		 * return ListBoxDataItem objects.
+		 * @param dataProvider The data provider, or NULL to store options in
+		 * the gadget.
+		 */
+		virtual void setDataProvider(ListDataProvider* dataProvider);
+
+		/**
+		 * Update the gadget after the data supplied by its data provider has
+		 * changed.
+		 */
+		virtual void refreshOptions();
+
+		/**
+		 * Show only the options whose text contains the supplied term.
+		 * Matching ignores the case of ASCII letters.  Specify an empty string
+		 * to show all options.  Option indices always refer to the full list
+		 * of options.
+		 * @param filter The term to search for.
+		 */
+		virtual void setFilter(const WoopsiString& filter);
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible options must contain.
+		 */
+		virtual inline const WoopsiString& getFilter() const { return _options.getFilter(); };
+
+		/**
+		 * Get the number of options that match the filter.
+		 * @return The number of visible options.
+		 */
+		virtual inline const s32 getVisibleOptionCount() const { return _options.getVisibleItemCount(); };
+
+		/**
+		 * Start a batch of changes to the options.  The gadget is not
+		 * resized or redrawn and no events are raised until the matching
+		 * call to endUpdate().  Calls can be nested.
+		 */
+		virtual inline void beginUpdate() { _options.beginUpdate(); };
+
+		/**
+		 * End a batch of changes started by beginUpdate().  When the outermost
+		 * update ends, the gadget is updated once to reflect all of the
+		 * changes.
+		 */
+		virtual inline void endUpdate() { _options.endUpdate(); };
+
+		/**
+		 * Check if a batch of changes is in progress.
+		 * @return True if beginUpdate() has been called more times than
+		 * endUpdate().
+		 */
+		inline const bool isUpdating() const { return _options.isUpdating(); };
+
 		/**
 		 * Add a new option to the gadget.
 		 * @param text Text to show in the option.
@@ -93,6 +162,16 @@ namespace WoopsiUI {
 		 */
 		virtual void selectAllOptions();
 
+		/**
+		 * Select a range of options.  Does not deselect any other selected
+		 * options.  Does nothing if the listbox does not allow multiple
+		 * selections.
+		 * Raises a value changed event.
+		 * @param first The index of the first option to select.
+		 * @param last The index of the last option to select.
+		 */
+		virtual void selectOptionRange(const s32 first, const s32 last);
+
 		/**
 		 * Deselect all options.
 		 * Raises a value changed event.
@@ -165,6 +244,15 @@ namespace WoopsiUI {
 		 */
 		virtual const u16 getOptionHeight() const;
 
+		/**
+		 * Get the index of the option displayed at the supplied y
+		 * co-ordinate.
+		 * @param y The y co-ordinate to examine.
+		 * @return The index of the option within the full list of options, or
+		 * -1 if no option is displayed there.
+		 */
+		const s32 getOptionIndexAt(s16 y) const;
+
 		/**
 		 * Sets whether or not items added to the list are automatically sorted
 		 * on insert or not.
@@ -5,6 +5,8 @@
 
 namespace WoopsiUI {
 
+	class ListDataProvider;
+
 	/**
 	 * Defines the interface for ListBox classes.
 	 */
@@ -24,6 +26,14 @@ namespace WoopsiUI {
 		 */
 		virtual void addOption(ListBoxDataItem* option) = 0;
 
+		/**
+		 * Add a range of options to the gadget.  The gadget is only updated
+		 * once all of the options have been added.
+		 * @param options Array of options to add.
+		 * @param count The number of options in the array.
+		 */
+		virtual void addOptions(ListBoxDataItem* const* options, const s32 count) = 0;
+
 		/**
 		 * Remove an option from the gadget by its index.
 		 * @param index The index of the option to remove.
@@ -35,6 +45,56 @@ namespace WoopsiUI {
 		 */
 		virtual void removeAllOptions() = 0;
 
+		/**
+		 * Use a data provider to supply the options instead of storing them
+		 * in the gadget.  Any existing options are removed.  The provider must
+		 * return ListBoxDataItem objects.
+		 * @param dataProvider The data provider, or NULL to store options in
+		 * the gadget.
+		 */
+		virtual void setDataProvider(ListDataProvider* dataProvider) = 0;
+
+		/**
+		 * Update the gadget after the data supplied by its data provider has
+		 * changed.
+		 */
+		virtual void refreshOptions() = 0;
+
+		/**
+		 * Show only the options whose text contains the supplied term.
+		 * Matching ignores the case of ASCII letters.  Specify an empty string
+		 * to show all options.  Option indices always refer to the full list
+		 * of options.
+		 * @param filter The term to search for.
+		 */
+		virtual void setFilter(const WoopsiString& filter) = 0;
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible options must contain.
+		 */
+		virtual const WoopsiString& getFilter() const = 0;
+
+		/**
+		 * Get the number of options that match the filter.
+		 * @return The number of visible options.
+		 */
+		virtual const s32 getVisibleOptionCount() const = 0;
+
+		/**
+		 * Start a batch of changes to the options.  The gadget is not
+		 * resized or redrawn and no events are raised until the matching
+		 * call to endUpdate().  Calls can be nested.
+		 */
+		virtual void beginUpdate() = 0;
+
+		/**
+		 * End a batch of changes started by beginUpdate().  When the outermost
+		 * update ends, the gadget is updated once to reflect all of the
+		 * changes.
+		 */
+		virtual void endUpdate() = 0;
+
 		/**
 		 * Add a new option to the gadget.
 		 * @param text Text to show in the option.
@@ -70,6 +130,16 @@ namespace WoopsiUI {
 		 */
 		virtual void selectAllOptions() = 0;
 
+		/**
+		 * Select a range of options.  Does not deselect any other selected
+		 * options.  Does nothing if the listbox does not allow multiple
+		 * selections.
+		 * Raises a value changed event.
+		 * @param first The index of the first option to select.
+		 * @param last The index of the last option to select.
+		 */
+		virtual void selectOptionRange(const s32 first, const s32 last) = 0;
+
 		/**
 		 * Deselect all options.
 		 * Raises a value changed event.
@@ -4,14 +4,35 @@
 #include "woopsiarray.h"
 #include "listdataeventhandler.h"
 #include "listdataitem.h"
+#include "listdataprovider.h"
+#include "selectionset.h"
 #include "woopsistring.h"
 
 namespace WoopsiUI {
 
+	class TrigramIndex;
+
 	/**
 	 * Class representing a list of items.  Designed to be used by the ListBox
 	 * class, etc, to store its data.  Fires events to notify listeners when the
 	 * list changes or a new selection is made.
+	 *
+	 * Items can either be owned by the list or supplied on demand by a
+	 * ListDataProvider.  In either case the selection state is held by the
+	 * list rather than by the items themselves.
+	 *
+	 * Changes can be batched by wrapping them in calls to beginUpdate() and
+	 * endUpdate().  No events are raised during an update; instead, a single
+	 * data changed event and a single selection changed event are raised
+	 * when the update ends if anything changed.
+	 *
+	 * The list can be filtered so that only items whose text contains a
+	 * search term are visible.  The visible items are described by a list of
+	 * indices into the full list, so no items are copied.  Each time the
+	 * filter is extended (as when the user types another character), only the
+	 * items that were already visible are examined.  Large lists are searched
+	 * using a trigram index that is built on demand.  Item indices used by
+	 * all other methods always refer to the full, unfiltered list.
 	 */
 	class ListData {
 	public:
@@ -27,7 +48,7 @@ namespace WoopsiUI {
 		virtual ~ListData();
 
 		/**
-		 * Add a new item.
+		 * Add a new item.  Does nothing if the list uses a data provider.
 		 * @param text Text to show in the option.
 		 * @param value The value of the option.
 		 */
@@ -35,14 +56,49 @@ namespace WoopsiUI {
 
 		/**
 		 * Add an existing item.  ListData becomes the owner of the option and
-		 * will delete it when the list is deleted.
+		 * will delete it when the list is deleted.  Does nothing if the list
+		 * uses a data provider.
 		 * @param item The item to add.
 		 */
 		virtual void addItem(ListDataItem* item);
 
+		/**
+		 * Add a range of existing items.  ListData becomes the owner of the
+		 * items and will delete them when the list is deleted.  A single data
+		 * changed event is raised once all of the items have been added.
+		 * Does nothing if the list uses a data provider.
+		 * @param items Array of items to add.
+		 * @param count The number of items in the array.
+		 */
+		virtual void addItems(ListDataItem* const* items, const s32 count);
+
+		/**
+		 * Start a batch of changes.  Events are suppressed until the matching
+		 * call to endUpdate().  Calls can be nested.
+		 *
+		 * If sorted insertion is enabled, items added during an update are
+		 * appended and the whole list is sorted once when the update ends, so
+		 * the indices of items are not final until then.
+		 */
+		virtual void beginUpdate();
+
+		/**
+		 * End a batch of changes started by beginUpdate().  When the outermost
+		 * update ends, any pending sort is performed and a single data changed
+		 * event and a single selection changed event are raised if needed.
+		 */
+		virtual void endUpdate();
+
+		/**
+		 * Check if a batch of changes is in progress.
+		 * @return True if beginUpdate() has been called more times than
+		 * endUpdate().
+		 */
+		inline const bool isUpdating() const { return _updateDepth > 0; };
 
 		/**
-		 * Remove an item by its index.
+		 * Remove an item by its index.  Does nothing if the list uses a data
+		 * provider.
 		 * @param index The index of the option to remove.
 		 */
 		virtual void removeItem(const s32 index);
@@ -60,7 +116,16 @@ namespace WoopsiUI {
 		virtual void deselectItem(const s32 index);
 
 		/**
-		 * Remove all items.
+		 * Select a range of items.  Does not deselect any other selected items.
+		 * Does nothing if the list does not allow multiple selections.
+		 * @param first The index of the first item to select.
+		 * @param last The index of the last item to select.
+		 */
+		virtual void selectItemRange(const s32 first, const s32 last);
+
+		/**
+		 * Remove all items.  If the list uses a data provider, the provider
+		 * is detached.
 		 */
 		virtual void removeAllItems();
 
@@ -70,7 +135,13 @@ namespace WoopsiUI {
 		 * returned.
 		 * @return The selected index.
 		 */
-		virtual const s32 getSelectedIndex() const;
+		virtual inline const s32 getSelectedIndex() const { return _selection.getFirst(); };
+
+		/**
+		 * Get the number of selected items.
+		 * @return The number of selected items.
+		 */
+		virtual inline const s32 getSelectedCount() const { return _selection.getCount(); };
 
 		/**
 		 * Sets the selected index.  Specify -1 to select nothing.  Resets any
@@ -92,13 +163,19 @@ namespace WoopsiUI {
 		virtual inline void setAllowMultipleSelections(const bool allowMultipleSelections) { _allowMultipleSelections = allowMultipleSelections; };
 
 		/**
-		 * Get the specified item.
+		 * Get the specified item.  If the list uses a data provider, the item
+		 * is only valid until the next call to getItem().
 		 * @return The specified item.
 		 */
-		virtual inline const ListDataItem* getItem(const s32 index) const { return _items[index]; };
+		virtual inline const ListDataItem* getItem(const s32 index) const {
+			return _dataProvider != NULL ? _dataProvider->getItem(index) : _items[index];
+		};
 
 		/**
-		 * Sort the items using their compareTo() methods.
+		 * Sort the items using their sort keys and compareTo() methods.  The
+		 * sort is stable, so items that compare as equal keep their relative
+		 * order.  Selection states move with their items.  Does nothing if
+		 * the list uses a data provider.
 		 */
 		virtual void sort();
 
@@ -106,7 +183,75 @@ namespace WoopsiUI {
 		 * Get the total number of items.
 		 * @return The number of items.
 		 */
-		virtual inline const s32 getItemCount() const { return _items.size(); };
+		virtual inline const s32 getItemCount() const {
+			return _dataProvider != NULL ? _dataProvider->getItemCount() : _items.size();
+		};
+
+		/**
+		 * Check if an item is selected.
+		 * @param index The index of the item.
+		 * @return True if the item is selected.
+		 */
+		virtual inline const bool isItemSelected(const s32 index) const { return _selection.isSelected(index); };
+
+		/**
+		 * Show only the items whose text contains the supplied term.  Matching
+		 * ignores the case of ASCII letters.  Specify an empty string to show
+		 * all items.  Raises a data changed event.
+		 * @param filter The term to search for.
+		 */
+		virtual void setFilter(const WoopsiString& filter);
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible items must contain.
+		 */
+		inline const WoopsiString& getFilter() const { return _filter; };
+
+		/**
+		 * Check if the list is filtered.
+		 * @return True if a filter is set.
+		 */
+		inline const bool isFiltered() const { return _filter.getLength() > 0; };
+
+		/**
+		 * Get the number of items that match the filter.
+		 * @return The number of visible items.
+		 */
+		inline const s32 getVisibleItemCount() const {
+			return isFiltered() ? _visibleIndices.size() : getItemCount();
+		};
+
+		/**
+		 * Convert the index of an item within the filtered view into its
+		 * index within the full list.
+		 * @param visibleIndex The index of the item within the filtered view.
+		 * @return The index of the item within the full list.
+		 */
+		inline const s32 getVisibleItemIndex(const s32 visibleIndex) const {
+			return isFiltered() ? _visibleIndices[visibleIndex] : visibleIndex;
+		};
+
+		/**
+		 * Use a data provider to supply the items instead of storing them in
+		 * the list.  Any items owned by the list are deleted and the selection
+		 * is cleared.  Specify NULL to revert to storing items in the list.
+		 * The list does not take ownership of the provider.
+		 * @param dataProvider The new data provider.
+		 */
+		virtual void setDataProvider(ListDataProvider* dataProvider);
+
+		/**
+		 * Get the data provider.
+		 * @return The data provider, or NULL if the list stores its own items.
+		 */
+		inline ListDataProvider* getDataProvider() const { return _dataProvider; };
+
+		/**
+		 * Notify the list that the data supplied by its data provider has
+		 * changed.  Selections beyond the end of the new data are discarded.
+		 */
+		virtual void refresh();
 
 		/**
 		 * Select all items.  Does nothing if the list does not allow multiple
@@ -153,17 +298,67 @@ namespace WoopsiUI {
 		inline ListDataEventHandler* getListDataEventHandler() { return _listDataEventHandler; };
 
 	protected:
+
+		/**
+		 * Struct describing an item during a sort.
+		 */
+		typedef struct {
+			ListDataItem* item;					/**< The item. */
+			u32 key;							/**< The item's cached sort key. */
+			bool selected;						/**< True if the item is selected. */
+		} SortEntry;
+
 		WoopsiArray<ListDataItem*> _items;							/**< Collection of list data items. */
+		SelectionSet _selection;									/**< Selection state of each item. */
+		ListDataProvider* _dataProvider;							/**< Supplies items on demand if not NULL. */
 		ListDataEventHandler* _listDataEventHandler;				/**< Event handler. */
 		bool _allowMultipleSelections;								/**< If true, multiple options can be selected. */
 		bool _sortInsertedItems;									/**< Automatically sorts items on insertion if true. */
+		s32 _updateDepth;											/**< Number of nested beginUpdate() calls. */
+		bool _sortPending;											/**< True if items were appended during an update and need sorting. */
+		s32 _sortedCount;											/**< Number of items at the start of the list that were sorted before the update. */
+		bool _dataChangePending;									/**< True if data changed during an update. */
+		bool _selectionChangePending;								/**< True if the selection changed during an update. */
+		WoopsiString _filter;										/**< Term that visible items must contain. */
+		WoopsiArray<s32> _visibleIndices;							/**< Indices of the items that match the filter. */
+		TrigramIndex* _filterIndex;									/**< Index used to filter large lists; NULL until needed. */
+		bool _filterIndexValid;										/**< False if items have changed, other than by being appended, since the index was built. */
+		s32 _indexedItemCount;										/**< Number of items in the filter index. */
+		s32 _filteredItemCount;										/**< Number of items checked against the filter when the filtered view was built. */
+		bool _dataChangeIsAppend;									/**< True if every change since the filtered view was built appended items to the list. */
 
 		/**
-		 * Quick sort the items using their compareTo() methods.
-		 * @param start The index to start sorting at.
-		 * @param end The index to stop sorting at.
+		 * Merge sort the items using their sort keys and compareTo() methods.
+		 * Items at the start of the list that are known to be sorted already
+		 * are merged with the rest in a single pass rather than being sorted
+		 * again.
+		 * @param sortedCount The number of items at the start of the list that
+		 * are already sorted.
 		 */
-		virtual void quickSort(const s32 start, const s32 end);
+		virtual void mergeSort(const s32 sortedCount);
+
+		/**
+		 * Merge two adjacent sorted runs of entries into a buffer.
+		 * @param source The entries to merge.
+		 * @param dest The buffer to merge the entries into.
+		 * @param start The index of the first entry in the first run.
+		 * @param middle The index of the first entry in the second run.
+		 * @param end The index after the last entry in the second run.
+		 */
+		static void mergeRuns(const SortEntry* source, SortEntry* dest, const s32 start, const s32 middle, const s32 end);
+
+		/**
+		 * Compare two items, using their sort keys where possible and their
+		 * compareTo() methods otherwise.
+		 * @param item1 The first item.
+		 * @param key1 The sort key of the first item.
+		 * @param item2 The second item.
+		 * @param key2 The sort key of the second item.
+		 * @return 0 if the items are equal, a value less than 0 if the first
+		 * item is less than the second, and a value greater than 0 if the
+		 * first item is greater than the second.
+		 */
+		static s8 compareItems(const ListDataItem* item1, const u32 key1, const ListDataItem* item2, const u32 key2);
 
 		/**
 		 * Swap the locations of two items in the array.
@@ -174,16 +369,63 @@ namespace WoopsiUI {
 
 		/**
 		 * Return the index that an item should be inserted at to maintain a
-		 * sorted list of data.
+		 * sorted list of data.  Uses a binary search.  The item is placed
+		 * after any items that compare as equal to it.
 		 * @param item The item to insert.
 		 * @return The index that the item should be imserted into at.
 		 */
 		const s32 getSortedInsertionIndex(const ListDataItem* item) const;
 
 		/**
-		 * Raise a data changed event.
+		 * Rebuild the list of items that match the filter.
+		 * @param narrow True if the new filter contains the previous filter,
+		 * in which case only the items that are already visible can match.
+		 */
+		void applyFilter(const bool narrow);
+
+		/**
+		 * Add any items appended since the filtered view was built to the
+		 * view if they match the filter.
+		 */
+		void filterAppendedItems();
+
+		/**
+		 * Check if an item's text contains a search term.
+		 * @param index The index of the item.
+		 * @param term The search term, already folded to lower case.
+		 * @param termLength The number of bytes in the term.
+		 * @return True if the item contains the term.
+		 */
+		bool itemMatches(const s32 index, const char* term, const s32 termLength) const;
+
+		/**
+		 * Copy the bytes of a string into a new buffer with ASCII letters
+		 * folded to lower case.
+		 * @param text The string to copy.
+		 * @return The new buffer, which is not terminated.  Must be deleted by
+		 * the caller.
+		 */
+		static char* newFoldedText(const WoopsiString& text);
+
+		/**
+		 * Check if a run of bytes contains a search term, ignoring the case of
+		 * ASCII letters.
+		 * @param text The bytes to search.
+		 * @param textLength The number of bytes to search.
+		 * @param term The search term, already folded to lower case.
+		 * @param termLength The number of bytes in the term.
+		 * @return True if the bytes contain the term.
+		 */
+		static bool containsFolded(const char* text, const s32 textLength, const char* term, const s32 termLength);
+
+		/**
+		 * Raise a data changed event.  Brings the filtered view up to date
+		 * first.
+		 * @param isAppend True if the only change is that items have been
+		 * appended to the end of the list, in which case only the new items
+		 * are filtered and indexed.
 		 */
-		void raiseDataChangedEvent();
+		void raiseDataChangedEvent(const bool isAppend = false);
 
 		/**
 		 * Raise a selection changed event.
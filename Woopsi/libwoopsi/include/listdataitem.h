@@ -38,16 +38,17 @@ namespace WoopsiUI {
 		inline const u32 getValue() const { return _value; };
 
 		/**
-		 * Get the item's selection state.
-		 * @return True if the item is selected; false if not.
+		 * Set the item's text.  Allows a ListDataProvider to reuse a single
+		 * item for every index it supplies.
+		 * @param text The new text.
 		 */
-		inline const bool isSelected() const { return _isSelected; };
+		void setText(const WoopsiString& text);
 
 		/**
-		 * Set the item's selection state.
-		 * @param selected True to select the item; false to deselect it.
+		 * Set the item's value.
+		 * @param value The new value.
 		 */
-		inline void setSelected(bool selected) { _isSelected = selected; };
+		inline void setValue(const u32 value) { _value = value; };
 
 		/**
 		 * Compare the item with another.  Comparison is based on the text of
@@ -61,10 +62,41 @@ namespace WoopsiUI {
 		 */
 		virtual s8 compareTo(const ListDataItem* item) const;
 
+		/**
+		 * Get a key that allows most comparisons to be made without calling
+		 * compareTo().  If the key of this item is less than the key of
+		 * another item, compareTo() must report that this item is less than
+		 * the other.  Items with equal keys are compared using compareTo().
+		 *
+		 * The default key is 0 for every item, leaving all comparisons to
+		 * compareTo().  If the text sort key is enabled, the key instead
+		 * packs the first few characters of the text, folded to lower case,
+		 * into an integer.
+		 * @return The sort key.
+		 * @see setTextSortKeyEnabled()
+		 */
+		virtual inline u32 getSortKey() const { return _isTextSortKeyEnabled ? _sortKey : 0; };
+
+		/**
+		 * Enable or disable the text sort key.  The key only matches the
+		 * text comparison made by the default compareTo(), so it is disabled
+		 * by default and should only be enabled for items that do not
+		 * override compareTo() or that override it consistently with the
+		 * text ordering.
+		 * @param enabled True to enable the text sort key.
+		 */
+		inline void setTextSortKeyEnabled(const bool enabled) { _isTextSortKeyEnabled = enabled; };
+
 	private:
 		WoopsiString _text;				/**< Text to display for option. */
 		u32 _value;						/**< Option value. */
-		bool _isSelected;				/**< True if the option is selected. */
+		u32 _sortKey;					/**< Cached sort key derived from the text. */
+		bool _isTextSortKeyEnabled;		/**< True if getSortKey() returns the text key. */
+
+		/**
+		 * Recalculate the cached sort key from the text.
+		 */
+		void updateSortKey();
 	};
 }
 
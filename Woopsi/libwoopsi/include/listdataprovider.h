@@ -0,0 +1,52 @@
+#ifndef _LIST_DATA_PROVIDER_H_
+#define _LIST_DATA_PROVIDER_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	class ListDataItem;
+
+	/**
+	 * Base ListDataProvider class, intended to be subclassed.  Supplies the
+	 * items shown in a ListData object on demand, so that large lists do not
+	 * need to create an item object for every entry up front.
+	 *
+	 * Items are only requested for the rows that are actually used, such as
+	 * the rows visible in a ListBox.  The returned item only needs to remain
+	 * valid until the next call to getItem(), so a provider can fill in and
+	 * return the same item object every time.  Providers used with a ListBox
+	 * must return ListBoxDataItem objects.
+	 *
+	 * Selection state is held by the ListData object, not by the items.  If
+	 * the data changes, the provider's owner must call ListData::refresh().
+	 */
+	class ListDataProvider {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		inline ListDataProvider() { }
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~ListDataProvider() { }
+
+		/**
+		 * Get the total number of items.
+		 * @return The number of items.
+		 */
+		virtual const s32 getItemCount() const = 0;
+
+		/**
+		 * Get the item at the specified index.
+		 * @param index The index of the item.
+		 * @return The item.  Only valid until the next call to getItem().
+		 */
+		virtual const ListDataItem* getItem(const s32 index) = 0;
+	};
+}
+
+#endif
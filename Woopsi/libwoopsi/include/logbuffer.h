@@ -0,0 +1,194 @@
+#ifndef _LOG_BUFFER_H_
+#define _LOG_BUFFER_H_
+
+#include <nds.h>
+#include "woopsistring.h"
+
+namespace WoopsiUI {
+
+	class FontBase;
+
+	/**
+	 * Fixed-capacity ring buffer of wrapped lines of text, intended as the
+	 * data store for log consoles.  Text is wrapped as it is appended and
+	 * only the wrapped lines are kept.  When the buffer is full, appending
+	 * a line discards the oldest.
+	 *
+	 * Unlike Document, appending text never moves or re-wraps existing
+	 * text.  The only exception is the last line when it has not yet been
+	 * terminated by a newline, which is re-wrapped so that text can be
+	 * written to it in several pieces.  Both appending and discarding a
+	 * line are constant-time operations, and the storage for each line is
+	 * reused once the buffer has filled.
+	 */
+	class LogBuffer {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param font The font to use to measure the text.
+		 * @param width The width, in pixels, at which text is wrapped.
+		 * @param capacity The maximum number of lines that the buffer holds.
+		 */
+		LogBuffer(FontBase* font, u16 width, s32 capacity);
+
+		/**
+		 * Destructor.
+		 */
+		~LogBuffer();
+
+		/**
+		 * Append text to the end of the buffer.  Newline characters start new
+		 * lines; text after the final newline is held in an open line that
+		 * subsequent appends continue.
+		 * @param text The text to append.
+		 * @param firstChangedLine Populated with the index of the first line
+		 * that was added or re-wrapped.  Lines before this index are unchanged
+		 * apart from having moved up by the number of discarded lines.
+		 * @param discardedLines Populated with the number of lines discarded
+		 * from the start of the buffer.
+		 */
+		void append(const WoopsiString& text, s32& firstChangedLine, s32& discardedLines);
+
+		/**
+		 * Remove all lines.
+		 */
+		void clear();
+
+		/**
+		 * Set the font used to measure the text and re-wrap all lines.
+		 * @param font The new font.
+		 */
+		void setFont(FontBase* font);
+
+		/**
+		 * Set the wrapping width and re-wrap all lines.
+		 * @param width The new width.
+		 */
+		void setWidth(u16 width);
+
+		/**
+		 * Get the font used to measure the text.
+		 * @return The font.
+		 */
+		inline FontBase* getFont() const { return _font; };
+
+		/**
+		 * Get the wrapping width.
+		 * @return The wrapping width.
+		 */
+		inline const u16 getWidth() const { return _width; };
+
+		/**
+		 * Get the maximum number of lines that the buffer holds.
+		 * @return The capacity of the buffer.
+		 */
+		inline const s32 getCapacity() const { return _capacity; };
+
+		/**
+		 * Get the number of lines in the buffer.
+		 * @return The number of lines.
+		 */
+		inline const s32 getLineCount() const { return _count; };
+
+		/**
+		 * Get the height of a line of text, including the space between
+		 * lines.
+		 * @return The height of a line.
+		 */
+		const u8 getLineHeight() const;
+
+		/**
+		 * Get the text of a line.  Line 0 is the oldest line in the buffer.
+		 * @param index The index of the line.
+		 * @return The text of the line.
+		 */
+		inline const WoopsiString& getLine(const s32 index) const {
+			return _lines[getSlot(index)].text;
+		};
+
+		/**
+		 * Get the number of characters in a line, excluding any blank
+		 * characters at its end.
+		 * @param index The index of the line.
+		 * @return The trimmed length of the line.
+		 */
+		inline const s32 getLineTrimmedLength(const s32 index) const {
+			return _lines[getSlot(index)].trimmedLength;
+		};
+
+	private:
+
+		/**
+		 * A single wrapped line.
+		 */
+		typedef struct {
+			WoopsiString text;				/**< Text of the line. */
+			s32 trimmedLength;				/**< Length of the text without trailing blanks. */
+			bool isContinuation;			/**< True if the line was wrapped from the previous line. */
+		} Line;
+
+		Line* _lines;						/**< Storage for the lines. */
+		FontBase* _font;					/**< Font used to measure the text. */
+		u16 _width;							/**< Width at which text is wrapped. */
+		s32 _capacity;						/**< Maximum number of lines. */
+		s32 _head;							/**< Slot containing the oldest line. */
+		s32 _count;							/**< Number of lines in the buffer. */
+		s32 _discarded;						/**< Lines discarded by the current append. */
+		bool _isLastLineOpen;				/**< True if the last line has not been terminated. */
+
+		/**
+		 * Get the storage slot that holds a line.
+		 * @param index The index of the line.
+		 * @return The slot holding the line.
+		 */
+		inline const s32 getSlot(const s32 index) const {
+			s32 slot = _head + index;
+			return slot >= _capacity ? slot - _capacity : slot;
+		};
+
+		/**
+		 * Remove the lines that make up the open line from the end of the
+		 * buffer and append their text to a string.
+		 * @param text String to append the text to.
+		 */
+		void takeOpenLine(WoopsiString& text);
+
+		/**
+		 * Wrap text and append the resulting lines to the buffer.
+		 * @param text Text to wrap.  Must not contain newlines.
+		 */
+		void appendWrapped(const WoopsiString& text);
+
+		/**
+		 * Append a single line to the buffer, discarding the oldest line if
+		 * the buffer is full.
+		 * @param text Text containing the line.
+		 * @param startIndex Index of the first character of the line.
+		 * @param length Number of characters in the line.
+		 * @param isContinuation True if the line was wrapped from the previous
+		 * line.
+		 */
+		void appendLine(const WoopsiString& text, s32 startIndex, s32 length, bool isContinuation);
+
+		/**
+		 * Wrap the contents of the buffer again.  Called when the font or
+		 * width changes.
+		 */
+		void rewrap();
+
+		/**
+		 * Check if the line can be broken after the specified character.
+		 * @param codePoint The character to check.
+		 * @return True if the line can be broken after the character.
+		 */
+		static bool isBreakPoint(u32 codePoint);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline LogBuffer(const LogBuffer& logBuffer) { };
+	};
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef _LOG_TEXTBOX_H_
+#define _LOG_TEXTBOX_H_
+
+#include <nds.h>
+#include "scrollingpanel.h"
+#include "gadgetstyle.h"
+#include "woopsistring.h"
+#include "logbuffer.h"
+
+namespace WoopsiUI {
+
+	/**
+	 * Read-only textbox designed for log consoles and other displays that
+	 * receive a constant stream of new text.  Text is left- and top-aligned
+	 * and stored in a LogBuffer, so appending is a constant-time operation
+	 * regardless of how much text the textbox remembers.
+	 *
+	 * When text is appended the existing pixels are scrolled with
+	 * Graphics::scroll() and only the new rows are drawn.  If the textbox is
+	 * already waiting to be redrawn, for example because text has already
+	 * been appended in the current frame, the textbox is redrawn instead so
+	 * that several appends cost a single redraw.
+	 *
+	 * If the textbox is showing the newest text it follows new text as it
+	 * arrives; otherwise the rows being viewed stay where they are.
+	 */
+	class LogTextBox : public ScrollingPanel {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param x The x co-ordinate of the text box, relative to its parent.
+		 * @param y The y co-ordinate of the text box, relative to its parent.
+		 * @param width The width of the textbox.
+		 * @param height The height of the textbox.
+		 * @param maxRows The maximum number of rows the textbox can track.
+		 * Adding rows beyond this number discards the oldest rows.  Setting
+		 * this to 0 will make the textbox track only the visible rows.
+		 * @param style The style that the gadget should use.  If this is not
+		 * specified, the gadget will use the values stored in the global
+		 * defaultGadgetStyle object.  The gadget will copy the properties of
+		 * the style into its own internal style object.
+		 */
+		LogTextBox(s16 x, s16 y, u16 width, u16 height, s32 maxRows = 0, GadgetStyle* style = NULL);
+
+		/**
+		 * Append new text to the end of the current text displayed in the
+		 * textbox.
+		 * @param text String to append.
+		 */
+		virtual void appendText(const WoopsiString& text);
+
+		/**
+		 * Remove all text from the textbox.
+		 */
+		virtual void clearText();
+
+		/**
+		 * Set the font used in the textbox.
+		 * @param font Pointer to the new font.
+		 */
+		virtual void setFont(FontBase* font);
+
+		/**
+		 * Get the buffer containing the wrapped text displayed in the
+		 * textbox.
+		 * @return Pointer to the buffer.
+		 */
+		inline const LogBuffer* getBuffer() const { return _buffer; };
+
+		/**
+		 * Get the number of rows of text.
+		 * @return The number of rows.
+		 */
+		inline const s32 getLineCount() const { return _buffer->getLineCount(); };
+
+		/**
+		 * Get the height of a row of text.
+		 * @return The height of a row.
+		 */
+		inline const u8 getLineHeight() const { return _buffer->getLineHeight(); };
+
+	protected:
+		LogBuffer* _buffer;				/**< Wrapped rows of text. */
+
+		/**
+		 * Draw the area of this gadget that falls within the clipping region.
+		 * Called by the redraw() function to draw all visible regions.
+		 * @param port The GraphicsPort to draw to.
+		 * @see redraw()
+		 */
+		virtual void drawContents(GraphicsPort* port);
+
+		/**
+		 * Draw the area of this gadget that falls within the clipping region.
+		 * Called by the redraw() function to draw all visible regions.
+		 * @param port The GraphicsPort to draw to.
+		 * @see redraw()
+		 */
+		virtual void drawBorder(GraphicsPort* port);
+
+		/**
+		 * Resize the textbox to the new dimensions.
+		 * @param width The new width.
+		 * @param height The new height.
+		 */
+		virtual void onResize(u16 width, u16 height);
+
+		/**
+		 * Ensures that the canvas height is the height of the gadget,
+		 * if the gadget exceeds the size of the text, or the height of
+		 * the text if the text exceeds the size of the gadget.
+		 */
+		void limitCanvasHeight();
+
+		/**
+		 * Scroll the displayed pixels after text has been appended and
+		 * mark the rows that need to be drawn as damaged.
+		 * @param dy The distance that unchanged rows have moved.
+		 * @param firstChangedLine The index of the first row that has changed.
+		 */
+		void scrollAppendedText(s32 dy, s32 firstChangedLine);
+
+		/**
+		 * Destructor.
+		 */
+		virtual ~LogTextBox();
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline LogTextBox(const LogTextBox& logTextBox) : ScrollingPanel(logTextBox) { };
+	};
+}
+
+#endif
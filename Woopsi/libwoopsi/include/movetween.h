@@ -0,0 +1,59 @@
+#ifndef _MOVE_TWEEN_H_
+#define _MOVE_TWEEN_H_
+
+#include <nds.h>
+#include "tween.h"
+
+namespace WoopsiUI {
+
+	class Gadget;
+
+	/**
+	 * Tween that moves a gadget from its position when the tween starts to a
+	 * new position.  The gadget is only moved, and therefore only damaged, in
+	 * frames in which its position changes.
+	 */
+	class MoveTween : public Tween {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param gadget The gadget to move.
+		 * @param x The final x co-ordinate, relative to the gadget's parent.
+		 * @param y The final y co-ordinate, relative to the gadget's parent.
+		 * @param frames The number of frames the move takes.
+		 * @param easing The easing curve to use.
+		 */
+		MoveTween(Gadget* gadget, s16 x, s16 y, u16 frames, Easing easing = TWEEN_EASING_LINEAR);
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~MoveTween() { };
+
+		/**
+		 * Start moving the gadget from its current position.
+		 */
+		virtual void start();
+
+	protected:
+		Gadget* _gadget;					/**< Gadget being moved */
+		s16 _fromX;							/**< X co-ordinate when the tween started */
+		s16 _fromY;							/**< Y co-ordinate when the tween started */
+		s16 _toX;							/**< Final x co-ordinate */
+		s16 _toY;							/**< Final y co-ordinate */
+
+		/**
+		 * Move the gadget to the position at the supplied progress.
+		 * @param progress The eased progress, from 0 to PROGRESS_MAX.
+		 */
+		virtual void update(s32 progress);
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline MoveTween(const MoveTween& moveTween) : Tween(moveTween) { };
+	};
+}
+
+#endif
@@ -247,6 +247,33 @@ namespace WoopsiUI {
 		 */
 		s32 getRowContainingCoordinate(s16 y) const;
 
+		/**
+		 * Set the cursor position without redrawing the cursor.  The position
+		 * is limited to the confines of the text.
+		 * @param position The new cursor position.
+		 */
+		void setCursorPosition(const s32 position);
+
+		/**
+		 * Get the rect occupied by the cursor.
+		 * @param rect Populated with the cursor's rect, in gadget
+		 * co-ordinates.
+		 */
+		void getCursorRect(Rect& rect) const;
+
+		/**
+		 * Mark the rows changed by the most recent change to the document as
+		 * damaged, along with the old and new positions of the cursor.  If the
+		 * change has moved every row, the whole textbox is damaged instead.
+		 * Must be called before the canvas is scrolled.
+		 * @param oldCursorRect The rect occupied by the cursor before the
+		 * change.
+		 * @param oldLineCount The number of lines before the change.
+		 * @param linesCulled True if lines were removed from the top of the
+		 * text.
+		 */
+		void markChangedRowsDamaged(const Rect& oldCursorRect, const s32 oldLineCount, const bool linesCulled);
+
 		/**
 		 * Draw the area of this gadget that falls within the clipping region.
 		 * Called by the redraw() function to draw all visible regions.
@@ -365,7 +392,7 @@ namespace WoopsiUI {
 		 * @param row The index of the row.
 		 * @return The x co-ordinate of the row.
 		 */
-		u8 getRowX(s32 row) const;
+		s16 getRowX(s32 row) const;
 
 		/**
 		 * Gets the y position of the specified row of text based on the type of
@@ -127,6 +127,14 @@ public:
 		return value > 0 && value % PAD_REPEAT_TIME == 0;
 	};
 
+	/**
+	 * Check if no keys are held or have just been released.
+	 * @return True if all keys are idle.
+	 */
+	inline bool isIdle() const {
+		return (_up | _down | _left | _right | _a | _b | _x | _y | _l | _r | _start | _select) == 0;
+	};
+
 	/**
 	 * Check if the most recently pressed direction was vertical or horizontal.
 	 * @return True if the most recently-pressed direction was vertical.  False
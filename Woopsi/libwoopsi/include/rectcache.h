@@ -1,7 +1,7 @@
 #ifndef _RECT_CACHE_H_
 #define _RECT_CACHE_H_
 
-#include "woopsiarray.h"
+#include "region.h"
 #include "gadget.h"
 
 namespace WoopsiUI {
@@ -23,10 +23,21 @@ namespace WoopsiUI {
 		/**
 		 * Destructor.
 		 */
-		inline ~RectCache() {
-			delete _foregroundRegions;
-			delete _backgroundRegions;
-		};
+		inline ~RectCache() { };
+
+		/**
+		 * Allocates memory for a rect cache from the gadget slab allocator.
+		 * @param size The size of the object.
+		 * @return Memory for the object.
+		 */
+		static void* operator new(size_t size);
+
+		/**
+		 * Releases memory allocated by operator new.
+		 * @param data The memory to release.
+		 * @param size The size of the object.
+		 */
+		static void operator delete(void* data, size_t size);
 
 		/**
 		 * Rebuild the cache if it is invalid.
@@ -42,44 +53,47 @@ namespace WoopsiUI {
 		};
 
 		/**
-		 * Return the list of background regions.  These are regions that are
-		 * not overlapped by child gadgets.
-		 * @return The list of background regions.
+		 * Invalidates the background cache only.  Should be called when the
+		 * area covered by the gadget's children changes but the gadget itself
+		 * has not been covered or exposed.
+		 */
+		inline void invalidateBackground() { _backgroundInvalid = true; };
+
+		/**
+		 * Return the background region.  This is the area of the gadget that
+		 * is not overlapped by child gadgets.
+		 * @return The background region.
 		 */
-		inline WoopsiArray<Rect>* getBackgroundRegions() { return _backgroundRegions; };
+		inline const Region* getBackgroundRegion() const { return &_backgroundRegion; };
 
 		/**
-		 * Return the list of foreground regions.  These are regions that
-		 * represent the entire visible surface of the gadget - that is, any
-		 * regions not overlapped by ancestors or sublings of the gadget -
-		 * including any regions that are actually overlapped by child gadgets.
-		 * @return The list of foreground regions.
+		 * Return the foreground region.  This represents the entire visible
+		 * surface of the gadget - that is, any area not overlapped by
+		 * ancestors or siblings of the gadget - including any area that is
+		 * actually overlapped by child gadgets.
+		 * @return The foreground region.
 		 */
-		inline WoopsiArray<Rect>* getForegroundRegions() { return _foregroundRegions; };
+		inline const Region* getForegroundRegion() const { return &_foregroundRegion; };
 
 		/**
-		 * Works out which rectangles in the invalidRectangles list overlap this
-		 * gadget, then cuts the rectangles into smaller pieces.  The
-		 * overlapping pieces are pushed into validRects, and the
-		 * non-overlapping pieces are pushed back into the invalidRects vector.
-		 * @param invalidRectangles A vector of regions that need to be tested
-		 * for collisions against this gadget; they represent regions that need
-		 * to be redrawn.
-		 * @param validRects A vector of regions that represents areas of the
-		 * display that do not need to be redrawn.
+		 * Removes the area of the display covered by this gadget from the
+		 * supplied region.  Hidden gadgets do not cover anything.
+		 * @param region The region to remove this gadget from.
 		 */
-		void splitRectangles(WoopsiArray<Rect>* invalidRectangles, WoopsiArray<Rect>* validRects) const;
+		void removeFromRegion(Region& region) const;
 
 		/**
-		 * Move any rectangles from the visibleRects list that overlap this
-		 * gadget into the invisibleRects list.  Used during visible region
-		 * calculations.
-		 * @param visibleRects A vector of regions that are not overlapped.
-		 * @param invisibleRects A vector of regions that are overlapped.
-		 * @param gadget The gadget that requested the lists.
-		 * @see splitRectangles()
+		 * Remove the area covered by any children of the owning gadget that
+		 * are above the specified child from the supplied region.  Used during
+		 * visible region calculations.  Ancestors' siblings are not checked as
+		 * they have already been removed from the owning gadget's foreground
+		 * region.  Non-opaque gadgets are not removed, so damage to the
+		 * gadgets beneath them includes the areas that show through.
+		 * @param visibleRegion The region that is not overlapped.
+		 * @param gadget The child gadget that requested the region.
+		 * @see removeFromRegion()
 		 */
-		void removeOverlappedRects(WoopsiArray<Rect>* visibleRects, WoopsiArray<Rect>* invisibleRects, const Gadget* gadget) const;
+		void removeOverlappedRects(Region& visibleRegion, const Gadget* gadget) const;
 
 		/**
 		 * Marks all foreground rects dirty.  All rects are sent to the
@@ -98,8 +112,8 @@ namespace WoopsiUI {
 		void markRectDamaged(const Rect& rect) const;
 
 	private:
-		WoopsiArray<Rect>* _foregroundRegions;				/**< List of the gadget's visible regions */
-		WoopsiArray<Rect>* _backgroundRegions;				/**< List of the gadget's visible regions with child rects removed */
+		Region _foregroundRegion;							/**< The gadget's visible region */
+		Region _backgroundRegion;							/**< The gadget's visible region with child rects removed */
 		const Gadget* _gadget;								/**< Owning gadget */
 		bool _foregroundInvalid;							/**< True if the foreground cache needs refreshing */
 		bool _backgroundInvalid;							/**< True if the background cache needs refreshing */
@@ -0,0 +1,228 @@
+#ifndef _REGION_H_
+#define _REGION_H_
+
+#include <nds.h>
+#include "rect.h"
+#include "woopsismallarray.h"
+
+namespace WoopsiUI {
+
+	/**
+	 * Class describing an arbitrary area of the display as a set of
+	 * non-overlapping rects.  The rects are stored in Y-X banded form, in the
+	 * same way as X11 and pixman regions:
+	 *
+	 * - Rects are sorted by y, then by x.
+	 * - The display is divided into horizontal bands.  Every rect in a band
+	 *   has the same y co-ordinate and height, and no two bands overlap.
+	 * - Rects within a band never touch or overlap.
+	 * - Vertically adjacent bands with identical horizontal spans are merged
+	 *   into a single band.
+	 *
+	 * The banded form means that the union, intersection and difference of two
+	 * regions can be calculated in a single pass over both rect lists, and
+	 * that the number of rects used to describe an area stays as small as
+	 * possible no matter how many operations are performed on it.
+	 *
+	 * Regions store a handful of rects inline, so creating a region on the
+	 * stack to describe a simple area does not allocate any memory.
+	 */
+	class Region {
+	public:
+
+		/**
+		 * Constructor.  Creates an empty region.
+		 */
+		Region();
+
+		/**
+		 * Constructor.  Creates a region containing a single rect.
+		 * @param rect The rect that the region should contain.
+		 */
+		Region(const Rect& rect);
+
+		/**
+		 * Copy constructor.
+		 * @param region Region to copy.
+		 */
+		Region(const Region& region);
+
+		/**
+		 * Destructor.
+		 */
+		inline ~Region() { };
+
+		/**
+		 * Assignment operator.
+		 * @param region Region to copy.
+		 * @return A reference to this region.
+		 */
+		Region& operator=(const Region& region);
+
+		/**
+		 * Remove all rects from the region.
+		 */
+		void clear();
+
+		/**
+		 * Replace the contents of the region with a single rect.
+		 * @param rect The rect that the region should contain.
+		 */
+		void setRect(const Rect& rect);
+
+		/**
+		 * Check if the region is empty.
+		 * @return True if the region contains no rects.
+		 */
+		inline bool isEmpty() const { return _rects.size() == 0; };
+
+		/**
+		 * Get the number of rects that make up the region.
+		 * @return The number of rects in the region.
+		 */
+		inline const s32 getRectCount() const { return _rects.size(); };
+
+		/**
+		 * Get the rect at the specified index.
+		 * @param index The index of the rect to retrieve.
+		 * @return The rect at the specified index.
+		 */
+		inline const Rect& getRect(s32 index) const { return _rects.at(index); };
+
+		/**
+		 * Get the smallest rect that contains the entire region.  If the region
+		 * is empty the rect has no dimensions.
+		 * @return The bounding rect of the region.
+		 */
+		inline const Rect& getBounds() const { return _bounds; };
+
+		/**
+		 * Get the total number of pixels within the region.
+		 * @return The area of the region.
+		 */
+		const s32 getArea() const;
+
+		/**
+		 * Check if the region contains a point.
+		 * @param x The x co-ordinate of the point.
+		 * @param y The y co-ordinate of the point.
+		 * @return True if the point falls within the region.
+		 */
+		bool contains(s16 x, s16 y) const;
+
+		/**
+		 * Check if the region overlaps a rect.
+		 * @param rect The rect to check.
+		 * @return True if any part of the rect falls within the region.
+		 */
+		bool intersects(const Rect& rect) const;
+
+		/**
+		 * Add a rect to the region.
+		 * @param rect The rect to add.
+		 */
+		void addRect(const Rect& rect);
+
+		/**
+		 * Add another region to this region.
+		 * @param region The region to add.
+		 */
+		void addRegion(const Region& region);
+
+		/**
+		 * Remove all parts of the region that fall outside a rect.
+		 * @param rect The rect to intersect with.
+		 */
+		void intersectRect(const Rect& rect);
+
+		/**
+		 * Remove all parts of the region that fall outside another region.
+		 * @param region The region to intersect with.
+		 */
+		void intersectRegion(const Region& region);
+
+		/**
+		 * Remove a rect from the region.
+		 * @param rect The rect to remove.
+		 */
+		void subtractRect(const Rect& rect);
+
+		/**
+		 * Remove another region from this region.
+		 * @param region The region to remove.
+		 */
+		void subtractRegion(const Region& region);
+
+		/**
+		 * Move the region.
+		 * @param dx The horizontal distance to move.
+		 * @param dy The vertical distance to move.
+		 */
+		void translate(s16 dx, s16 dy);
+
+	private:
+
+		/**
+		 * Set operations that can be performed by combine().
+		 */
+		enum Operation {
+			OPERATION_UNION = 0,			/**< Keep areas in either region. */
+			OPERATION_INTERSECT = 1,		/**< Keep areas in both regions. */
+			OPERATION_SUBTRACT = 2			/**< Keep areas in this region but not the other. */
+		};
+
+		WoopsiSmallArray<Rect, 4> _rects;	/**< Banded list of rects. */
+		Rect _bounds;						/**< Bounding rect of all rects. */
+
+		/**
+		 * Replace the region with the result of a set operation performed on
+		 * this region and another region.  Both rect lists are walked band by
+		 * band, so the operation is linear in the number of rects.
+		 * @param region The other region.
+		 * @param operation The operation to perform.
+		 */
+		void combine(const Region& region, Operation operation);
+
+		/**
+		 * Combine the horizontal spans of a single band from each region and
+		 * append the resulting rects to a list.
+		 * @param rects1 Rect list of the first region.
+		 * @param start1 Index of the first rect in the first region's band.
+		 * @param end1 Index after the last rect in the first region's band.
+		 * @param rects2 Rect list of the second region.
+		 * @param start2 Index of the first rect in the second region's band.
+		 * @param end2 Index after the last rect in the second region's band.
+		 * @param top The y co-ordinate of the output band.
+		 * @param height The height of the output band.
+		 * @param operation The operation to perform.
+		 * @param dest List to append the output band to.
+		 */
+		static void combineBand(const WoopsiArray<Rect>& rects1, s32 start1, s32 end1, const WoopsiArray<Rect>& rects2, s32 start2, s32 end2, s32 top, s32 height, Operation operation, WoopsiArray<Rect>& dest);
+
+		/**
+		 * Merge the band just added to a rect list into the previous band if
+		 * the two bands touch and have identical horizontal spans.
+		 * @param rects The rect list.
+		 * @param previousStart Index of the first rect in the previous band.
+		 * @param currentStart Index of the first rect in the band just added.
+		 * @return True if the bands were merged.
+		 */
+		static bool coalesceBands(WoopsiArray<Rect>& rects, s32 previousStart, s32 currentStart);
+
+		/**
+		 * Get the index after the last rect in the band starting at the
+		 * supplied index.
+		 * @param rects The rect list.
+		 * @param start Index of the first rect in the band.
+		 * @return Index after the last rect in the band.
+		 */
+		static s32 getBandEnd(const WoopsiArray<Rect>& rects, s32 start);
+
+		/**
+		 * Recalculate the bounding rect.
+		 */
+		void updateBounds();
+	};
+}
+
+#endif
@@ -47,6 +47,14 @@ namespace WoopsiUI {
 		 */
 		virtual void addOption(ListBoxDataItem* option);
 
+		/**
+		 * Add a range of options to the gadget.  The gadget is only updated
+		 * once all of the options have been added.
+		 * @param options Array of options to add.
+		 * @param count The number of options in the array.
+		 */
+		virtual void addOptions(ListBoxDataItem* const* options, const s32 count);
+
 		/**
 		 * Add a new option to the gadget.
 		 * @param text Text to show in the option.
@@ -72,6 +80,62 @@ namespace WoopsiUI {
 		 */
 		virtual void removeAllOptions();
 
+		/**
+		 * Use a data provider to supply the options instead of storing them
+		 * in the gadget.  Any existing options are removed.  The provider must
+		 * return ListBoxDataItem objects.
+		 * @param dataProvider The data provider, or NULL to store options in
+		 * the gadget.
+		 */
+		virtual void setDataProvider(ListDataProvider* dataProvider);
+
+		/**
+		 * Update the gadget after the data supplied by its data provider has
+		 * changed.
+		 */
+		virtual void refreshOptions();
+
+		/**
+		 * Show only the options whose text contains the supplied term.
+		 * Matching ignores the case of ASCII letters.  Specify an empty string
+		 * to show all options.  Option indices always refer to the full list
+		 * of options.
+		 * @param filter The term to search for.
+		 */
+		virtual void setFilter(const WoopsiString& filter);
+
+		/**
+		 * Get the current filter.
+		 * @return The term that visible options must contain.
+		 */
+		virtual inline const WoopsiString& getFilter() const {
+			return _listbox->getFilter();
+		};
+
+		/**
+		 * Get the number of options that match the filter.
+		 * @return The number of visible options.
+		 */
+		virtual inline const s32 getVisibleOptionCount() const {
+			return _listbox->getVisibleOptionCount();
+		};
+
+		/**
+		 * Start a batch of changes to the options.  The gadget is not
+		 * resized or redrawn and no events are raised until the matching
+		 * call to endUpdate().  Calls can be nested.
+		 */
+		virtual inline void beginUpdate() {
+			_listbox->beginUpdate();
+		};
+
+		/**
+		 * End a batch of changes started by beginUpdate().  When the outermost
+		 * update ends, the gadget is updated once to reflect all of the
+		 * changes.
+		 */
+		virtual void endUpdate();
+
 		/**
 		 * Select an option by its index.  Does not deselect any other selected
 		 * options.
@@ -101,6 +165,18 @@ namespace WoopsiUI {
 			_listbox->selectAllOptions();
 		};
 
+		/**
+		 * Select a range of options.  Does not deselect any other selected
+		 * options.  Does nothing if the listbox does not allow multiple
+		 * selections.
+		 * Raises a value changed event.
+		 * @param first The index of the first option to select.
+		 * @param last The index of the last option to select.
+		 */
+		virtual inline void selectOptionRange(const s32 first, const s32 last) {
+			_listbox->selectOptionRange(first, last);
+		};
+
 		/**
 		 * Deselect all options.
 		 * Raises a value changed event.
@@ -0,0 +1,188 @@
+#ifndef _SCROLLING_LOG_TEXTBOX_H_
+#define _SCROLLING_LOG_TEXTBOX_H_
+
+#include <nds.h>
+#include "logtextbox.h"
+#include "gadgeteventhandler.h"
+#include "gadgetstyle.h"
+#include "woopsistring.h"
+#include "scrollablebase.h"
+
+namespace WoopsiUI {
+
+	class ScrollbarVertical;
+
+	/**
+	 * Gadget containing a LogTextBox and a vertical scrollbar.  Intended for
+	 * log consoles that receive text at a high rate.
+	 * @see LogTextBox
+	 */
+	class ScrollingLogTextBox : public Gadget, public ScrollableBase, public GadgetEventHandler {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param x The x co-ordinate of the text box, relative to its parent.
+		 * @param y The y co-ordinate of the text box, relative to its parent.
+		 * @param width The width of the textbox.
+		 * @param height The height of the textbox.
+		 * @param maxRows The maximum number of rows the textbox can track.
+		 * Adding rows beyond this number discards the oldest rows.  Setting
+		 * this to 0 will make the textbox track only the visible rows.
+		 * @param style The style that the gadget should use.  If this is not
+		 * specified, the gadget will use the values stored in the global
+		 * defaultGadgetStyle object.  The gadget will copy the properties of
+		 * the style into its own internal style object.
+		 */
+		ScrollingLogTextBox(s16 x, s16 y, u16 width, u16 height, s32 maxRows = 0, GadgetStyle* style = NULL);
+
+		/**
+		 * Append new text to the end of the current text displayed in the
+		 * textbox.
+		 * @param text String to append.
+		 */
+		virtual void appendText(const WoopsiString& text);
+
+		/**
+		 * Remove all text from the textbox.
+		 */
+		virtual void clearText();
+
+		/**
+		 * Set the font used in the textbox.
+		 * @param font Pointer to the new font.
+		 */
+		virtual void setFont(FontBase* font);
+
+		/**
+		 * Get the buffer containing the wrapped text displayed in the
+		 * textbox.
+		 * @return Pointer to the buffer.
+		 */
+		virtual const LogBuffer* getBuffer() const;
+
+		/**
+		 * Handles events raised by its sub-gadgets.
+		 * @param source The gadget that was changed.
+		 */
+		virtual void handleValueChangeEvent(Gadget& source);
+
+		/**
+		 * Handles events raised by its sub-gadgets.
+		 * @param source The gadget that was scrolled.
+		 * @param delta The distance scrolled.
+		 */
+		virtual void handleScrollEvent(Gadget& source, const WoopsiPoint& delta);
+
+		/**
+		 * Gets the x co-ordinate of the virtual canvas.
+		 * @return The x co-ordinate of the virtual canvas.
+		 */
+		virtual const s32 getCanvasX() const;
+		
+		/**
+		 * Gets the y co-ordinate of the virtual canvas.
+		 * @return The y co-ordinate of the virtual canvas.
+		 */
+		virtual const s32 getCanvasY() const;
+
+		/**
+		 * Gets the width of the virtual canvas.
+		 * @return The width of the virtual canvas.
+		 */
+		virtual const s32 getCanvasWidth() const;
+		
+		/**
+		 * Gets the height of the virtual canvas.
+		 * @return The height of the virtual canvas.
+		 */
+		virtual const s32 getCanvasHeight() const;
+
+		/**
+		 * Scroll the panel by the specified amounts.
+		 * @param dx The horizontal distance to scroll.
+		 * @param dy The vertical distance to scroll.
+		 */
+		virtual void scroll(s32 dx, s32 dy);
+		
+		/**
+		 * Reposition the panel's scrolling region to the specified co-ordinates.
+		 * @param x The new x co-ordinate of the scrolling region.
+		 * @param y The new y co-ordinate of the scrolling region.
+		 */
+		virtual void jump(s32 x, s32 y);
+
+		/**
+		 * Set whether or not horizontal scrolling is allowed.
+		 * @param allow True to allow horizontal scrolling; false to deny it.
+		 */
+		virtual void setAllowsVerticalScroll(bool allow);
+
+		/**
+		 * Set whether or not horizontal scrolling is allowed.
+		 * @param allow True to allow horizontal scrolling; false to deny it.
+		 */
+		virtual void setAllowsHorizontalScroll(bool allow);
+
+		/**
+		 * Sets the width of the virtual canvas.
+		 * @param width The width of the virtual canvas.
+		 */
+		virtual void setCanvasWidth(const s32 width);
+		
+		/**
+		 * Sets the height of the virtual canvas.
+		 * @param height The height of the virtual canvas.
+		 */
+		virtual void setCanvasHeight(const s32 height);
+
+		/**
+		 * Returns true if vertical scrolling is allowed.
+		 * @return True if vertical scrolling is allowed.
+		 */
+		virtual bool allowsVerticalScroll() const;
+
+		/**
+		 * Returns true if horizontal scrolling is allowed.
+		 * @return True if horizontal scrolling is allowed.
+		 */
+		virtual bool allowsHorizontalScroll() const;
+
+	protected:
+		LogTextBox* _textbox;							/**< Pointer to the textbox */
+		ScrollbarVertical* _scrollbar;					/**< Pointer to the scrollbar */
+		u8 _scrollbarWidth;								/**< Width of the scrollbar */
+
+		/**
+		 * Updates all scrollbar properties; called when textbox changes.
+		 */
+		void updateScrollbar();
+
+		/**
+		 * Draw the area of this gadget that falls within the clipping region.
+		 * Called by the redraw() function to draw all visible regions.
+		 * @param port The GraphicsPort to draw to.
+		 * @see redraw()
+		 */
+		virtual void drawContents(GraphicsPort* port);
+
+		/**
+		 * Resize the textbox to the new dimensions.
+		 * @param width The new width.
+		 * @param height The new height.
+		 */
+		virtual void onResize(u16 width, u16 height);
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~ScrollingLogTextBox() { };
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline ScrollingLogTextBox(const ScrollingLogTextBox& scrollingLogTextBox) : Gadget(scrollingLogTextBox) { };
+	};
+}
+
+#endif
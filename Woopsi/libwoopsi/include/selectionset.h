@@ -0,0 +1,151 @@
+#ifndef _SELECTION_SET_H_
+#define _SELECTION_SET_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	/**
+	 * Set of selected indices within a list, stored as a packed bitset with
+	 * one bit per item.  The number of selected items and the index of the
+	 * first selected item are cached, so the common queries made by list
+	 * gadgets are constant-time:
+	 *
+	 * - Checking, selecting and deselecting a single index.
+	 * - Getting the first selected index and the number of selected items.
+	 * - Clearing a set that contains a single index, which is always the
+	 *   case for single-selection lists.
+	 *
+	 * Ranges are selected and deselected a word at a time.  Inserting and
+	 * removing indices shifts the bits above them, again a word at a time.
+	 */
+	class SelectionSet {
+	public:
+
+		/**
+		 * Constructor.  Creates an empty set covering no indices.
+		 */
+		SelectionSet();
+
+		/**
+		 * Destructor.
+		 */
+		~SelectionSet();
+
+		/**
+		 * Get the number of indices covered by the set.
+		 * @return The number of indices.
+		 */
+		inline const s32 getSize() const { return _size; };
+
+		/**
+		 * Get the number of selected indices.
+		 * @return The number of selected indices.
+		 */
+		inline const s32 getCount() const { return _count; };
+
+		/**
+		 * Get the first selected index.
+		 * @return The first selected index, or -1 if nothing is selected.
+		 */
+		inline const s32 getFirst() const { return _first; };
+
+		/**
+		 * Check if an index is selected.
+		 * @param index The index to check.
+		 * @return True if the index is selected.
+		 */
+		inline const bool isSelected(const s32 index) const {
+			return (_words[index >> 5] & ((u32)1 << (index & 31))) != 0;
+		};
+
+		/**
+		 * Get the first selected index after the supplied index.
+		 * @param index The index to search after.  Use -1 to search from the
+		 * start of the set.
+		 * @return The next selected index, or -1 if there are no more.
+		 */
+		const s32 getNext(const s32 index) const;
+
+		/**
+		 * Change the number of indices covered by the set.  Indices beyond the
+		 * new size are discarded; new indices are not selected.
+		 * @param size The new number of indices.
+		 */
+		void setSize(const s32 size);
+
+		/**
+		 * Select or deselect an index.
+		 * @param index The index to change.
+		 * @param selected True to select the index; false to deselect it.
+		 */
+		void setSelected(const s32 index, const bool selected);
+
+		/**
+		 * Select or deselect a range of indices.
+		 * @param first The first index in the range.
+		 * @param last The last index in the range.
+		 * @param selected True to select the range; false to deselect it.
+		 */
+		void setRangeSelected(const s32 first, const s32 last, const bool selected);
+
+		/**
+		 * Deselect all indices.
+		 */
+		void clear();
+
+		/**
+		 * Insert a new, unselected index.  Indices at and above the insertion
+		 * point move up by one.
+		 * @param index The index to insert.
+		 */
+		void insert(const s32 index);
+
+		/**
+		 * Remove an index.  Indices above it move down by one.
+		 * @param index The index to remove.
+		 */
+		void erase(const s32 index);
+
+		/**
+		 * Swap the selection state of two indices.
+		 * @param index1 The first index.
+		 * @param index2 The second index.
+		 */
+		void swap(const s32 index1, const s32 index2);
+
+	private:
+		u32* _words;						/**< Packed selection bits. */
+		s32 _wordCapacity;					/**< Number of words allocated. */
+		s32 _size;							/**< Number of indices covered. */
+		s32 _count;							/**< Number of selected indices. */
+		s32 _first;							/**< First selected index, or -1. */
+
+		/**
+		 * Ensure that enough words are allocated to hold the supplied number
+		 * of indices.
+		 * @param size The number of indices.
+		 */
+		void reserve(const s32 size);
+
+		/**
+		 * Count the bits set in a word.
+		 * @param word The word to examine.
+		 * @return The number of bits set.
+		 */
+		static s32 countBits(u32 word);
+
+		/**
+		 * Recalculate the selected count and first selected index by
+		 * examining every word.
+		 */
+		void recount();
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline SelectionSet(const SelectionSet& selectionSet) { };
+	};
+}
+
+#endif
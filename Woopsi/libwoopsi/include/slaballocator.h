@@ -0,0 +1,112 @@
+#ifndef _SLAB_ALLOCATOR_H_
+#define _SLAB_ALLOCATOR_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	/**
+	 * Pool allocator for large numbers of small objects.  Requests are rounded
+	 * up to a multiple of the allocator's granularity and served from a free
+	 * list for that size class.  When a free list is empty a new slab is
+	 * allocated from the heap and carved into objects of that size.  Released
+	 * objects are pushed back onto their free list for reuse rather than
+	 * returned to the heap, so allocating and deleting objects of the same
+	 * size costs a couple of pointer operations.
+	 *
+	 * The first slab for a size class holds only a few objects.  Each
+	 * subsequent slab for that class is twice the size of the last, up to a
+	 * limit, so sizes that are rarely used do not waste memory whilst sizes
+	 * that are used heavily quickly settle into large slabs.
+	 *
+	 * Requests larger than the maximum object size are passed straight through
+	 * to the heap.  The size supplied to release() must match the size
+	 * supplied to allocate().
+	 */
+	class SlabAllocator {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param granularity Size classes are multiples of this value.  Must
+		 * be a multiple of 8 to ensure that objects are correctly aligned.
+		 * @param maxObjectSize The size of the largest object served from a
+		 * slab.
+		 */
+		SlabAllocator(u32 granularity, u32 maxObjectSize);
+
+		/**
+		 * Destructor.  Frees all slabs.  All objects allocated from the
+		 * allocator must have been released before it is destroyed.
+		 */
+		~SlabAllocator();
+
+		/**
+		 * Allocate memory for an object.
+		 * @param size The size of the object in bytes.
+		 * @return A pointer to the memory.
+		 */
+		void* allocate(u32 size);
+
+		/**
+		 * Release memory previously obtained from allocate().
+		 * @param data The memory to release.
+		 * @param size The size that was passed to allocate().
+		 */
+		void release(void* data, u32 size);
+
+		/**
+		 * Get the number of objects currently allocated from slabs.
+		 * @return The number of live objects.
+		 */
+		inline const u32 getObjectCount() const { return _objectCount; };
+
+		/**
+		 * Get the number of bytes allocated from the heap for slabs.
+		 * @return The total size of all slabs.
+		 */
+		inline const u32 getSlabMemory() const { return _slabMemory; };
+
+	private:
+
+		/**
+		 * An unused object slot.  Free slots are chained together using the
+		 * memory of the slots themselves.
+		 */
+		typedef struct FreeSlot {
+			struct FreeSlot* next;			/**< Next free slot of the same size. */
+		} FreeSlot;
+
+		/**
+		 * Header at the start of each slab.  Slabs are chained together so
+		 * that they can be freed when the allocator is destroyed.
+		 */
+		typedef struct Slab {
+			struct Slab* next;				/**< Next slab. */
+			u32 padding;					/**< Keeps object slots 8-byte aligned. */
+		} Slab;
+
+		u32 _granularity;					/**< Size classes are multiples of this. */
+		u32 _maxObjectSize;					/**< Largest object served from slabs. */
+		u32 _sizeClassCount;				/**< Number of size classes. */
+		FreeSlot** _freeSlots;				/**< Free slot list for each size class. */
+		u8* _nextSlabObjectCounts;			/**< Number of objects the next slab for each size class will hold. */
+		Slab* _slabs;						/**< All allocated slabs. */
+		u32 _objectCount;					/**< Number of live objects. */
+		u32 _slabMemory;					/**< Total size of all slabs. */
+
+		/**
+		 * Allocate a new slab for the supplied size class and add its slots
+		 * to the class' free list.
+		 * @param sizeClass The size class that needs more slots.
+		 */
+		void allocateSlab(u32 sizeClass);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline SlabAllocator(const SlabAllocator& slabAllocator) { };
+	};
+}
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef _SPATIAL_GRID_H_
+#define _SPATIAL_GRID_H_
+
+#include <nds.h>
+#include "rect.h"
+#include "woopsiarray.h"
+
+namespace WoopsiUI {
+
+	class Gadget;
+
+	/**
+	 * Uniform grid of cells used to find the children of a gadget that lie at
+	 * a point or within a rect without examining every child.  Each cell
+	 * stores the indices of all children whose rects overlap the cell, in
+	 * ascending z-order.  Children are stored using their co-ordinates
+	 * relative to their parent, so queries must also use relative
+	 * co-ordinates.
+	 *
+	 * The grid does not track changes to the children.  The owning gadget
+	 * must call invalidate() whenever a child is added, removed, moved,
+	 * resized or changes depth, and must call rebuild() before querying an
+	 * invalid grid.  Rebuilding is linear in the number of children.
+	 *
+	 * The grid covers the bounding box of all children.  If that would need
+	 * more cells than the grid allows, the cell size is doubled until it fits.
+	 */
+	class SpatialGrid {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param cellSize The preferred width and height of each cell.
+		 * @param maxCells The maximum number of cells in the grid.
+		 */
+		SpatialGrid(u16 cellSize, s32 maxCells);
+
+		/**
+		 * Destructor.
+		 */
+		~SpatialGrid();
+
+		/**
+		 * Mark the grid as out of date.
+		 */
+		inline void invalidate() { _isValid = false; };
+
+		/**
+		 * Check if the grid is up to date.
+		 * @return True if the grid is up to date.
+		 */
+		inline bool isValid() const { return _isValid; };
+
+		/**
+		 * Rebuild the grid from a list of gadgets.
+		 * @param gadgets The gadgets to index.
+		 */
+		void rebuild(const WoopsiArray<Gadget*>& gadgets);
+
+		/**
+		 * Get the indices of all gadgets whose rects may contain the supplied
+		 * point.  Indices are returned in descending z-order (topmost first).
+		 * @param x The relative x co-ordinate of the point.
+		 * @param y The relative y co-ordinate of the point.
+		 * @param indices Array to append the indices to.
+		 */
+		void getGadgetsAt(s16 x, s16 y, WoopsiArray<s32>& indices) const;
+
+		/**
+		 * Get the indices of all gadgets whose rects may intersect the supplied
+		 * rect.  Indices are returned in descending z-order (topmost first).
+		 * If the rect covers so much of the grid that using the grid would be
+		 * slower than examining every gadget, the method returns false and
+		 * does not populate the array.
+		 * @param rect The rect to check, in relative co-ordinates.
+		 * @param indices Array to append the indices to.
+		 * @return True if the array was populated; false if the caller should
+		 * examine every gadget instead.
+		 */
+		bool getGadgetsIntersecting(const Rect& rect, WoopsiArray<s32>& indices);
+
+	private:
+		u16 _preferredCellSize;				/**< Preferred size of each cell. */
+		s32 _maxCells;						/**< Maximum number of cells. */
+		u16 _cellSize;						/**< Current size of each cell. */
+		s16 _originX;						/**< X co-ordinate of the top-left cell. */
+		s16 _originY;						/**< Y co-ordinate of the top-left cell. */
+		s32 _columns;						/**< Number of columns of cells. */
+		s32 _rows;							/**< Number of rows of cells. */
+		s32* _cellStarts;					/**< Index into _entries of the first entry for each cell, plus a final end index. */
+		s32 _cellStartsSize;				/**< Allocated size of _cellStarts. */
+		s32* _entries;						/**< Gadget indices for all cells, stored cell by cell. */
+		s32 _entriesSize;					/**< Allocated size of _entries. */
+		u32* _marks;						/**< Used to remove duplicate indices from rect queries. */
+		s32 _marksSize;						/**< Allocated size of _marks. */
+		u32 _markStamp;						/**< Value marking indices seen by the current query. */
+		bool _isValid;						/**< True if the grid is up to date. */
+
+		/**
+		 * Get the range of cells that a rect overlaps.
+		 * @param rect The rect, in relative co-ordinates.
+		 * @param column1 Populated with the first column.
+		 * @param row1 Populated with the first row.
+		 * @param column2 Populated with the last column.
+		 * @param row2 Populated with the last row.
+		 * @return False if the rect lies outside the grid.
+		 */
+		bool getCellRange(const Rect& rect, s32& column1, s32& row1, s32& column2, s32& row2) const;
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline SpatialGrid(const SpatialGrid& spatialGrid) { };
+	};
+}
+
+#endif
@@ -62,6 +62,13 @@ public:
 	 */
 	inline bool isDoubleClick() const { return _isDoubleClick; };
 
+	/**
+	 * Check if the stylus is not held, has not just been released, and
+	 * cannot produce a double-click if it is pressed again.
+	 * @return True if the stylus is idle.
+	 */
+	inline bool isIdle() const { return (_touchedTime == 0) && (_doubleClickTimeout == 0); };
+
 	/**
 	 * Get the x co-ordinate of the stylus.
 	 * @return The x co-ordinate of the stylus.
@@ -0,0 +1,177 @@
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <nds.h>
+#include "wheeltimer.h"
+
+namespace WoopsiUI {
+
+	/**
+	 * Hierarchical timing wheel that schedules WheelTimer objects.  Time is
+	 * measured in frames; Woopsi owns an instance and advances it once per
+	 * VBL.
+	 *
+	 * The wheel consists of several levels of slots.  Each slot holds a
+	 * linked list of timers.  Level 0 has one slot per frame; each slot in
+	 * the levels above covers as many frames as an entire revolution of the
+	 * level below.  Timers are placed in the lowest level that can hold
+	 * their deadline.  Whenever a level completes a revolution, the next slot
+	 * of the level above is emptied and its timers are redistributed into
+	 * the lower levels.  This is the same scheme used by the Linux kernel's
+	 * classic timer implementation.
+	 *
+	 * Scheduling and cancelling a timer are constant-time operations, and
+	 * advancing the wheel only examines timers that have expired or that are
+	 * moving down a level.  Timers that are not scheduled cost nothing.
+	 *
+	 * The longest delay that can be scheduled is 2^24 - 1 frames (around three
+	 * days).  Longer delays are clamped.
+	 */
+	class TimerWheel {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		TimerWheel();
+
+		/**
+		 * Destructor.  Any timers that are still scheduled are cancelled
+		 * without notifying their handlers.
+		 */
+		~TimerWheel();
+
+		/**
+		 * Schedule a timer.  If the timer is already scheduled it is
+		 * rescheduled.
+		 * @param timer The timer to schedule.
+		 * @param frames The number of frames until the timer expires.  A value
+		 * of 0 is treated as 1.
+		 * @param interval The number of frames between repeats once the timer
+		 * has expired, or 0 if the timer should only expire once.
+		 */
+		void schedule(WheelTimer* timer, u32 frames, u32 interval = 0);
+
+		/**
+		 * Schedule a timer using a delay measured in milliseconds.  The delay
+		 * is rounded up to the next whole frame.
+		 * @param timer The timer to schedule.
+		 * @param milliseconds The time until the timer expires.
+		 * @param interval The time between repeats once the timer has expired,
+		 * or 0 if the timer should only expire once.
+		 */
+		void scheduleMilliseconds(WheelTimer* timer, u32 milliseconds, u32 interval = 0);
+
+		/**
+		 * Remove a timer from the wheel without notifying its handler.  Does
+		 * nothing if the timer is not scheduled in this wheel.
+		 * @param timer The timer to cancel.
+		 */
+		void cancel(WheelTimer* timer);
+
+		/**
+		 * Advance the wheel, notifying the handlers of all timers that expire.
+		 * @param frames The number of frames to advance by.
+		 */
+		void advance(u32 frames);
+
+		/**
+		 * Get the current wheel time.  Deadlines are expressed in wheel time.
+		 * The value will eventually overflow and reset to 0.
+		 * @return The number of frames that the wheel has advanced by.
+		 */
+		inline u32 getTime() const { return _time; };
+
+		/**
+		 * Get the number of scheduled timers.
+		 * @return The number of scheduled timers.
+		 */
+		inline s32 getTimerCount() const { return _timerCount; };
+
+		/**
+		 * Get the number of frames until the wheel next needs to be advanced
+		 * to do any work.  The value is exact for timers that will expire
+		 * within the current revolution of the lowest level; otherwise the
+		 * time until timers next move down a level is reported, so the value
+		 * is never later than the next deadline.
+		 * @param frames Populated with the number of frames.
+		 * @return False if no timers are scheduled.
+		 */
+		bool getFramesUntilNextExpiry(u32& frames) const;
+
+		/**
+		 * Convert a time in milliseconds into frames, rounding up.
+		 * @param milliseconds The time to convert.
+		 * @return The number of frames.
+		 */
+		static u32 millisecondsToFrames(u32 milliseconds);
+
+	private:
+
+		/**
+		 * Dimensions of the wheel.
+		 */
+		enum {
+			LEVEL_COUNT = 4,							/**< Number of levels. */
+			SLOT_BITS = 6,								/**< Bits of the deadline used to index each level. */
+			SLOT_COUNT = 1 << SLOT_BITS,				/**< Number of slots in each level. */
+			SLOT_MASK = SLOT_COUNT - 1,					/**< Mask to extract a slot index. */
+			MAX_DELAY = (1 << (LEVEL_COUNT * SLOT_BITS)) - 1	/**< Longest delay that can be scheduled. */
+		};
+
+		WheelTimer* _slots[LEVEL_COUNT][SLOT_COUNT];	/**< Lists of timers in each slot. */
+		WheelTimer* _expiring;							/**< Timers expiring in the current frame. */
+		u32 _time;										/**< Current wheel time. */
+		s32 _timerCount;								/**< Number of scheduled timers. */
+
+		/**
+		 * Advance the wheel by a single frame.
+		 */
+		void tick();
+
+		/**
+		 * Add a timer to the slot matching its deadline.
+		 * @param timer The timer to add.
+		 */
+		void insert(WheelTimer* timer);
+
+		/**
+		 * Redistribute all timers in a slot into the levels below.
+		 * @param level The level containing the slot.
+		 * @param index The index of the slot.
+		 */
+		void cascade(s32 level, u32 index);
+
+		/**
+		 * Notify the handlers of all timers in a level 0 slot.
+		 * @param index The index of the slot.
+		 */
+		void expire(u32 index);
+
+		/**
+		 * Add a timer to the front of a list.
+		 * @param timer The timer to add.
+		 * @param head The head of the list.
+		 */
+		static void link(WheelTimer* timer, WheelTimer** head);
+
+		/**
+		 * Remove a timer from the list containing it.
+		 * @param timer The timer to remove.
+		 */
+		static void unlink(WheelTimer* timer);
+
+		/**
+		 * Detach every timer in a list from the wheel.
+		 * @param head The first timer in the list.
+		 */
+		static void detachAll(WheelTimer* head);
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline TimerWheel(const TimerWheel& timerWheel) { };
+	};
+}
+
+#endif
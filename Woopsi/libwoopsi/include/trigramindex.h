@@ -0,0 +1,102 @@
+#ifndef _TRIGRAM_INDEX_H_
+#define _TRIGRAM_INDEX_H_
+
+#include <nds.h>
+#include "woopsiarray.h"
+
+namespace WoopsiUI {
+
+	/**
+	 * Index of the three-character sequences (trigrams) that appear in a set
+	 * of strings, used to find the strings that might contain a search term
+	 * without examining every string.  Each string is identified by an ID
+	 * supplied when it is added.
+	 *
+	 * Trigrams are hashed into a fixed number of buckets, and each bucket
+	 * holds the IDs of the strings containing any trigram that hashes to it.
+	 * The strings listed for a term's rarest trigram are therefore a superset
+	 * of the strings containing the term, and must be checked by the caller.
+	 *
+	 * Comparisons are made on the raw UTF-8 bytes of each string with ASCII
+	 * letters folded to lower case, so searches are case-insensitive for
+	 * ASCII text.
+	 */
+	class TrigramIndex {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		TrigramIndex();
+
+		/**
+		 * Destructor.
+		 */
+		~TrigramIndex();
+
+		/**
+		 * Remove all strings from the index.
+		 */
+		void clear();
+
+		/**
+		 * Add a string to the index.  Strings must be added in ascending ID
+		 * order so that the lists of candidates are sorted.
+		 * @param id The ID of the string.
+		 * @param text The UTF-8 bytes of the string.
+		 * @param length The number of bytes in the string.
+		 */
+		void add(const s32 id, const char* text, const s32 length);
+
+		/**
+		 * Get the IDs of the strings that might contain a search term.  The
+		 * IDs are in ascending order.
+		 * @param term The UTF-8 bytes of the search term, already folded to
+		 * lower case.
+		 * @param length The number of bytes in the term.
+		 * @return The candidate IDs, or NULL if the term is too short to be
+		 * looked up in the index.
+		 */
+		const WoopsiArray<s32>* getCandidates(const char* term, const s32 length) const;
+
+		/**
+		 * Fold an ASCII letter to lower case.  Other bytes are unchanged.
+		 * @param c The byte to fold.
+		 * @return The folded byte.
+		 */
+		static inline char fold(const char c) {
+			return ((c >= 'A') && (c <= 'Z')) ? c + ('a' - 'A') : c;
+		};
+
+	private:
+
+		/**
+		 * Dimensions of the hash table.
+		 */
+		enum {
+			BUCKET_BITS = 12,							/**< Number of bits in a bucket index. */
+			BUCKET_COUNT = 1 << BUCKET_BITS				/**< Number of buckets. */
+		};
+
+		WoopsiArray<s32>* _buckets[BUCKET_COUNT];		/**< IDs of the strings containing each trigram; NULL if empty. */
+		WoopsiArray<s32> _empty;						/**< Empty list returned for trigrams that appear nowhere. */
+
+		/**
+		 * Get the bucket that a trigram hashes to.
+		 * @param text Pointer to the first of the three bytes.  The bytes must
+		 * already be folded.
+		 * @return The index of the bucket.
+		 */
+		static inline u32 getBucket(const char* text) {
+			u32 trigram = ((u8)text[0] << 16) | ((u8)text[1] << 8) | (u8)text[2];
+			return ((trigram * 2654435761u) >> (32 - BUCKET_BITS)) & (BUCKET_COUNT - 1);
+		};
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline TrigramIndex(const TrigramIndex& trigramIndex) { };
+	};
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef _TWEEN_H_
+#define _TWEEN_H_
+
+#include <nds.h>
+#include "animatable.h"
+
+namespace WoopsiUI {
+
+	class TweenEventHandler;
+
+	/**
+	 * Class that moves a value from one number to another over a fixed number
+	 * of frames.  Tweens are run by Woopsi's Animator, so they cost nothing
+	 * once they have completed.
+	 *
+	 * The base class tweens a plain value and raises events through its
+	 * TweenEventHandler whenever the value changes.  Subclasses such as
+	 * MoveTween and ColourTween apply the tween directly to a gadget and only
+	 * damage the gadget when the displayed value actually changes.
+	 *
+	 * The tween does not own any gadget it changes.  A running tween must be
+	 * stopped before its gadget is deleted.
+	 */
+	class Tween : public Animatable {
+	public:
+
+		/**
+		 * Easing curves that control how the value accelerates.
+		 */
+		enum Easing {
+			TWEEN_EASING_LINEAR = 0,		/**< Constant speed */
+			TWEEN_EASING_IN = 1,			/**< Accelerates from the start value */
+			TWEEN_EASING_OUT = 2,			/**< Decelerates into the end value */
+			TWEEN_EASING_IN_OUT = 3			/**< Accelerates then decelerates */
+		};
+
+		/**
+		 * Constructor.
+		 * @param from The start value.
+		 * @param to The end value.
+		 * @param frames The number of frames the tween runs for.  A value of 0
+		 * is treated as 1.
+		 * @param easing The easing curve to use.
+		 */
+		Tween(s32 from, s32 to, u16 frames, Easing easing = TWEEN_EASING_LINEAR);
+
+		/**
+		 * Destructor.  Stops the tween if it is running.
+		 */
+		virtual ~Tween();
+
+		/**
+		 * Get the current value.
+		 * @return The current value.
+		 */
+		inline const s32 getValue() const { return _value; };
+
+		/**
+		 * Get the number of frames the tween runs for.
+		 * @return The duration of the tween in frames.
+		 */
+		inline const u16 getDuration() const { return _duration; };
+
+		/**
+		 * Get the number of frames that have elapsed since the tween started.
+		 * @return The number of elapsed frames.
+		 */
+		inline const u16 getElapsed() const { return _elapsed; };
+
+		/**
+		 * Check if the tween is running.
+		 * @return True if the tween is running.
+		 */
+		inline const bool isRunning() const { return _isRunning; };
+
+		/**
+		 * Set the tween event handler.
+		 * @param eventHandler The handler to notify of tween events.
+		 */
+		inline void setTweenEventHandler(TweenEventHandler* eventHandler) { _eventHandler = eventHandler; };
+
+		/**
+		 * Start the tween from the beginning.
+		 */
+		virtual void start();
+
+		/**
+		 * Stop the tween, leaving the value at its current position.
+		 */
+		void stop();
+
+		/**
+		 * Advance the tween by one frame.  Called by the Animator.
+		 * @return False once the tween has completed.
+		 */
+		virtual bool animate();
+
+	protected:
+
+		/**
+		 * Range of the progress value passed to update().
+		 */
+		enum {
+			PROGRESS_MAX = 4096				/**< Progress value at the end of the tween */
+		};
+
+		TweenEventHandler* _eventHandler;	/**< Handler notified of tween events */
+		s32 _from;							/**< Start value */
+		s32 _to;							/**< End value */
+		s32 _value;							/**< Current value */
+		u16 _duration;						/**< Number of frames the tween runs for */
+		u16 _elapsed;						/**< Number of frames run so far */
+		Easing _easing;						/**< Easing curve */
+		bool _isRunning;					/**< True if the tween is in the animator */
+
+		/**
+		 * Apply the tween at the supplied progress.  The base implementation
+		 * updates the value and raises a value change event if it changed.
+		 * Subclasses should call the base implementation.
+		 * @param progress The eased progress, from 0 to PROGRESS_MAX.
+		 */
+		virtual void update(s32 progress);
+
+		/**
+		 * Get the value a given proportion of the way between two values.
+		 * @param from The start value.
+		 * @param to The end value.
+		 * @param progress The progress, from 0 to PROGRESS_MAX.
+		 * @return The interpolated value.
+		 */
+		static s32 interpolate(s32 from, s32 to, s32 progress);
+
+		/**
+		 * Apply the easing curve to the elapsed time.
+		 * @return The eased progress, from 0 to PROGRESS_MAX.
+		 */
+		s32 getEasedProgress() const;
+
+		/**
+		 * Copy constructor is protected to prevent usage.
+		 */
+		inline Tween(const Tween& tween) { };
+	};
+}
+
+#endif
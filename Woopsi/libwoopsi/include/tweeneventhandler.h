@@ -0,0 +1,43 @@
+#ifndef _TWEEN_EVENTHANDLER_H_
+#define _TWEEN_EVENTHANDLER_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	class Tween;
+
+	/**
+	 * Base TweenEventHandler class, intended to be subclassed.  Any class that
+	 * needs to listen for tween events should inherit from this class.
+	 */
+	class TweenEventHandler {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		inline TweenEventHandler() { }
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~TweenEventHandler() { }
+
+		/**
+		 * Handle a change to the tween's value.  Only raised when the value
+		 * differs from its value in the previous frame.
+		 * @param source The tween that changed.
+		 */
+		virtual void handleTweenValueChangeEvent(Tween& source) { };
+
+		/**
+		 * Handle a tween reaching its final value.  The tween may safely be
+		 * deleted or restarted by the handler.
+		 * @param source The tween that completed.
+		 */
+		virtual void handleTweenCompleteEvent(Tween& source) { };
+	};
+}
+
+#endif
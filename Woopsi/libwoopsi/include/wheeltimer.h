@@ -0,0 +1,89 @@
+#ifndef _WHEEL_TIMER_H_
+#define _WHEEL_TIMER_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	class TimerWheel;
+	class WheelTimerHandler;
+
+	/**
+	 * Lightweight timer scheduled by a TimerWheel.  Unlike the WoopsiTimer
+	 * gadget, a WheelTimer costs nothing while it is waiting to expire and
+	 * can be embedded in any class.  The timer notifies its handler when it
+	 * expires.
+	 *
+	 * Timers are scheduled with TimerWheel::schedule().  The timer
+	 * automatically cancels itself when it is destroyed.
+	 */
+	class WheelTimer {
+	public:
+
+		/**
+		 * Constructor.
+		 * @param handler The handler to notify when the timer expires.
+		 */
+		WheelTimer(WheelTimerHandler* handler = NULL);
+
+		/**
+		 * Destructor.  Cancels the timer if it is scheduled.
+		 */
+		~WheelTimer();
+
+		/**
+		 * Set the handler to notify when the timer expires.
+		 * @param handler The handler to notify when the timer expires.
+		 */
+		inline void setHandler(WheelTimerHandler* handler) { _handler = handler; };
+
+		/**
+		 * Get the handler that is notified when the timer expires.
+		 * @return The timer's handler.
+		 */
+		inline WheelTimerHandler* getHandler() const { return _handler; };
+
+		/**
+		 * Check if the timer is waiting to expire.
+		 * @return True if the timer is scheduled.
+		 */
+		inline bool isScheduled() const { return _wheel != NULL; };
+
+		/**
+		 * Get the wheel time at which the timer will next expire.  Only
+		 * valid while the timer is scheduled.
+		 * @return The wheel time at which the timer will next expire.
+		 */
+		inline u32 getDeadline() const { return _deadline; };
+
+		/**
+		 * Get the number of frames between repeats.
+		 * @return The repeat interval, or 0 if the timer does not repeat.
+		 */
+		inline u32 getInterval() const { return _interval; };
+
+		/**
+		 * Remove the timer from its wheel without notifying the handler.
+		 * Does nothing if the timer is not scheduled.
+		 */
+		void cancel();
+
+	private:
+		friend class TimerWheel;
+
+		TimerWheel* _wheel;					/**< Wheel the timer is scheduled in, or NULL. */
+		WheelTimerHandler* _handler;		/**< Handler notified when the timer expires. */
+		WheelTimer** _head;					/**< Head of the list containing the timer. */
+		WheelTimer* _previous;				/**< Previous timer in the list. */
+		WheelTimer* _next;					/**< Next timer in the list. */
+		u32 _deadline;						/**< Wheel time at which the timer expires. */
+		u32 _interval;						/**< Frames between repeats, or 0. */
+
+		/**
+		 * Copy constructor is private to prevent usage.
+		 */
+		inline WheelTimer(const WheelTimer& wheelTimer) { };
+	};
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef _WHEEL_TIMER_HANDLER_H_
+#define _WHEEL_TIMER_HANDLER_H_
+
+#include <nds.h>
+
+namespace WoopsiUI {
+
+	class WheelTimer;
+
+	/**
+	 * Base WheelTimerHandler class, intended to be subclassed.  Any class that
+	 * needs to be notified when a WheelTimer expires should inherit from this
+	 * class.
+	 */
+	class WheelTimerHandler {
+	public:
+
+		/**
+		 * Constructor.
+		 */
+		inline WheelTimerHandler() { }
+
+		/**
+		 * Destructor.
+		 */
+		virtual inline ~WheelTimerHandler() { }
+
+		/**
+		 * Handle a timer expiring.  The handler may reschedule, cancel or
+		 * delete the timer.
+		 * @param source The timer that expired.
+		 */
+		virtual void handleTimerExpired(WheelTimer& source) = 0;
+	};
+}
+
+#endif
@@ -9,9 +9,17 @@
 
 namespace WoopsiUI {
 
+	class BackingStore;
+
 	/**
 	 * Class representing a basic, empty window.  Intended to be subclassed, but can be used
 	 * as-is if necessary.
+	 *
+	 * By default, dragging a window draws an outline that follows the stylus
+	 * and the window is moved when the stylus is released.  If the window has
+	 * a backing store, the window itself follows the stylus.  Each step of the
+	 * drag copies the window from the backing store and only redraws the
+	 * areas that the window has uncovered.
 	 */
 	class Window : public Gadget {
 
@@ -42,8 +50,23 @@ namespace WoopsiUI {
 		 */
 		const WoopsiString& getTitle() { return _title; };
 
+		/**
+		 * Enable or disable the window's backing store.  The store holds an
+		 * off-screen copy of the window that is used when the window is
+		 * dragged, and uses as much memory as a bitmap the size of the window.
+		 * @param isEnabled True to enable the backing store.
+		 */
+		void setBackingStoreEnabled(bool isEnabled);
+
+		/**
+		 * Check if the window has a backing store.
+		 * @return True if the window has a backing store.
+		 */
+		inline bool isBackingStoreEnabled() const { return _backingStore != NULL; };
+
 	protected:
 		WoopsiString _title;							/**< Title of the window */
+		BackingStore* _backingStore;					/**< Off-screen copy of the window used when dragging. */
 
 		/**
 		 * Draw the area of this gadget that falls within the clipping region.
@@ -54,12 +77,14 @@ namespace WoopsiUI {
 		virtual void drawBorder(GraphicsPort* port);
 
 		/**
-		 * Draws a XOR rect around the window.
+		 * Draws a XOR rect around the window, or brings the backing store up
+		 * to date if the window has one.
 		 */
 		virtual void onDragStart();
 		
 		/**
-		 * Draws the dragging XOR rect at the new co-ordinates.
+		 * Draws the dragging XOR rect at the new co-ordinates, or moves the
+		 * window if it has a backing store.
 		 * @param x The x co-ordinate of the stylus.
 		 * @param y The y co-ordinate of the stylus.
 		 * @param vX The horizontal distance dragged.
@@ -72,10 +97,18 @@ namespace WoopsiUI {
 		 */
 		virtual void onDragStop();
 
+		/**
+		 * Move the window to the specified co-ordinates by copying it from
+		 * the backing store.
+		 * @param x The new x co-ordinate of the window, relative to its parent.
+		 * @param y The new y co-ordinate of the window, relative to its parent.
+		 */
+		void moveFromBackingStore(s16 x, s16 y);
+
 		/**
 		 * Destructor.
 		 */
-		virtual inline ~Window() { };
+		virtual ~Window();
 
 		/**
 		 * Copy constructor is protected to prevent usage.
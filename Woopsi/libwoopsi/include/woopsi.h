@@ -9,10 +9,13 @@ namespace WoopsiUI {
 
 	class Screen;
 	class ContextMenu;
-	class WoopsiTimer;
 	class WoopsiKeyboardScreen;
 	class KeyboardEventHandler;
 	class DamagedRectManager;
+	class FrameArena;
+	class Animator;
+	class TimerWheel;
+	class DirectoryCache;
 
 	/**
 	 * Class providing a top-level gadget and an interface to the Woopsi gadget
@@ -58,22 +61,6 @@ namespace WoopsiUI {
 		 */
 		virtual bool flipScreens(Gadget* gadget);
 
-		/**
-		 * Add the supplied timer to the list of timers that receive VBL
-		 * notifications.  This is handled automatically by the WoopsiTimer
-		 * constructor and should not be used in user code.
-		 * @param timer A pointer to the timer to add to the VBL list.
-		 */
-		void registerForVBL(WoopsiTimer* timer);
-
-		/**
-		 * Remove the supplied timer from the list of timers that receive VBL
-		 * notifications.  This is handled automatically by the WoopsiTimer
-		 * destructor and should not be used in user code.
-		 * @param timer A pointer to the timer to remove from the VBL list.
-		 */
-		void unregisterFromVBL(WoopsiTimer* timer);
-
 		/**
 		 * Add a gadget to the list of gadgets to be deleted.  Must never be
 		 * called by anything other than the framework itself.
@@ -89,6 +76,16 @@ namespace WoopsiUI {
 		 */
 		inline u32 getVBLCount() { return _vblCount; };
 
+		/**
+		 * Check if nothing will change until the next input event or timer
+		 * deadline.  Woopsi is idle if there is no damage waiting to be
+		 * redrawn, no gadgets waiting to be deleted, nothing animating, no
+		 * keys held and the stylus is not in use.  processOneVBL() sleeps until the next input
+		 * event or timer deadline when Woopsi is idle.
+		 * @return True if Woopsi is idle.
+		 */
+		bool isIdle();
+
 		/**
 		 * Get a pointer to the context menu.
 		 * @return Pointer to the context menu.
@@ -146,16 +143,47 @@ namespace WoopsiUI {
 		 */
 		DamagedRectManager* getDamagedRectManager() { return _damagedRectManager; };
 
+		/**
+		 * Get a pointer to the frame arena.  Memory allocated from the arena
+		 * is only valid until the end of the current VBL.
+		 * @return A pointer to the frame arena.
+		 */
+		inline FrameArena* getFrameArena() { return _frameArena; };
+
+		/**
+		 * Get a pointer to the timer wheel.  The wheel advances by one frame
+		 * every VBL and drives all WoopsiTimer gadgets.
+		 * @return A pointer to the timer wheel.
+		 */
+		inline TimerWheel* getTimerWheel() { return _timerWheel; };
+
+		/**
+		 * Get a pointer to the animator.  The animator advances all running
+		 * animations and tweens every VBL.
+		 * @return A pointer to the animator.
+		 */
+		inline Animator* getAnimator() { return _animator; };
+
+		/**
+		 * Get a pointer to the directory cache.  The cache holds recently
+		 * read directory listings shared by all FileListBox gadgets.
+		 * @return A pointer to the directory cache.
+		 */
+		inline DirectoryCache* getDirectoryCache() { return _directoryCache; };
+
 	protected:
 		bool _lidClosed;									/**< Remembers the current state of the lid. */
 		
-		WoopsiArray<WoopsiTimer*> _vblListeners;			/**< Array of timers that receive VBL events. */
 		WoopsiArray<Gadget*> _deleteQueue;					/**< Array of gadgets awaiting deletion. */
 		u32 _vblCount;										/**< Count of VBLs since Woopsi was first run. */
 		ContextMenu* _contextMenu;							/**< Pointer to the context menu. */
 		Gadget* _clickedGadget;								/**< Pointer to the gadget that is clicked. */
 		WoopsiKeyboardScreen* _keyboardScreen;				/**< Screen containing the popup keyboard. */
 		DamagedRectManager* _damagedRectManager;			/**< Maintains damaged rect list and controls redraws. */
+		FrameArena* _frameArena;							/**< Allocator for objects that only live for one VBL. */
+		TimerWheel* _timerWheel;							/**< Schedules all timers. */
+		Animator* _animator;								/**< Runs all animations and tweens. */
+		DirectoryCache* _directoryCache;					/**< Caches recently read directory listings. */
 
 		/**
 		 * Initialise the application.  All initial GUI creation, hardware
@@ -87,8 +87,20 @@ public:
 	 */
 	T& operator[](const s32 index) const;
 
+protected:
+
+	/**
+	 * Constructor used by subclasses that supply their own initial storage.
+	 * The array does not take ownership of the buffer.  If the array grows
+	 * beyond the capacity of the buffer its data is moved to the heap.
+	 * @param buffer Initial storage for the array.
+	 * @param bufferSize Capacity of the buffer.
+	 */
+	inline WoopsiArray(T* buffer, s32 bufferSize);
+
 private:
 	T* _data;								/**< Internal array of data items */
+	T* _buffer;								/**< Storage supplied by a subclass; never deleted by the array */
 	s32 _size;								/**< Number of items in the array */
 	s32 _reservedSize;						/**< Total size of the array including unpopulated slots */
 
@@ -103,11 +115,20 @@ WoopsiArray<T>::WoopsiArray(s32 initialReservedSize) {
 	_size = 0;
 	_reservedSize = initialReservedSize > 0 ? initialReservedSize : DYNAMIC_ARRAY_SIZE;
 	_data = new T[_reservedSize];
+	_buffer = NULL;
+}
+
+template <class T>
+WoopsiArray<T>::WoopsiArray(T* buffer, s32 bufferSize) {
+	_size = 0;
+	_reservedSize = bufferSize;
+	_data = buffer;
+	_buffer = buffer;
 }
 
 template <class T>
 WoopsiArray<T>::~WoopsiArray() {
-	delete [] _data;
+	if (_data != _buffer) delete [] _data;
 }
 
 template <class T>
@@ -194,8 +215,8 @@ void WoopsiArray<T>::resize() {
 
 		//memcpy(newData, _data, sizeof(T) * _reservedSize);
 
-		// Delete the old array
-		delete [] _data;
+		// Delete the old array unless it is storage supplied by a subclass
+		if (_data != _buffer) delete [] _data;
 
 		// Update values
 		_data = newData;
@@ -5,8 +5,11 @@
 #include "alert.h"
 #include "amigascreen.h"
 #include "amigawindow.h"
+#include "animatable.h"
 #include "animation.h"
+#include "animator.h"
 #include "animbutton.h"
+#include "backingstore.h"
 #include "bitmap.h"
 #include "bitmapbase.h"
 #include "bitmapbutton.h"
@@ -15,6 +18,7 @@
 #include "calendar.h"
 #include "checkbox.h"
 #include "colourpicker.h"
+#include "colourtween.h"
 #include "contextmenu.h"
 #include "cyclebutton.h"
 #include "damagedrectmanager.h"
@@ -22,6 +26,8 @@
 #include "debug.h"
 #include "decorationglyphbutton.h"
 #include "defines.h"
+#include "directorycache.h"
+#include "directoryreader.h"
 #include "dmafuncs.h"
 #include "document.h"
 #include "filelistbox.h"
@@ -29,6 +35,7 @@
 #include "filepath.h"
 #include "filerequester.h"
 #include "fontbase.h"
+#include "framearena.h"
 #include "framebuffer.h"
 #include "hardware.h"
 #include "gadget.h"
@@ -46,6 +53,10 @@
 #include "listdata.h"
 #include "listdataeventhandler.h"
 #include "listdataitem.h"
+#include "listdataprovider.h"
+#include "logbuffer.h"
+#include "logtextbox.h"
+#include "movetween.h"
 #include "multilinetextbox.h"
 #include "mutablebitmapbase.h"
 #include "packedfont1.h"
@@ -58,6 +69,7 @@
 #include "range.h"
 #include "rect.h"
 #include "rectcache.h"
+#include "region.h"
 #include "requester.h"
 #include "screen.h"
 #include "scrollablebase.h"
@@ -65,8 +77,11 @@
 #include "scrollbarpanel.h"
 #include "scrollbarvertical.h"
 #include "scrollinglistbox.h"
+#include "scrollinglogtextbox.h"
 #include "scrollingpanel.h"
 #include "scrollingtextbox.h"
+#include "selectionset.h"
+#include "slaballocator.h"
 #include "sliderbase.h"
 #include "sliderhorizontal.h"
 #include "sliderhorizontalgrip.h"
@@ -78,6 +93,12 @@
 #include "superbitmap.h"
 #include "textbox.h"
 #include "textboxbase.h"
+#include "timerwheel.h"
+#include "trigramindex.h"
+#include "tween.h"
+#include "tweeneventhandler.h"
+#include "wheeltimer.h"
+#include "wheeltimerhandler.h"
 #include "window.h"
 #include "windowborderbutton.h"
 #include "woopsi.h"
@@ -87,6 +108,7 @@
 #include "woopsikeyboard.h"
 #include "woopsikeyboardscreen.h"
 #include "woopsipoint.h"
+#include "woopsismallarray.h"
 #include "woopsistring.h"
 #include "woopsitimer.h"
 
@@ -0,0 +1,46 @@
+#ifndef _WOOPSI_SMALL_ARRAY_H_
+#define _WOOPSI_SMALL_ARRAY_H_
+
+#include <nds.h>
+#include "woopsiarray.h"
+
+/**
+ * Dynamic array that stores its first N items inline rather than on the heap.
+ * Only when the array grows beyond N items does it allocate memory.  Ideal for
+ * short-lived lists that are usually small, such as the rect lists used when
+ * clipping and splitting damaged regions, as creating and destroying the array
+ * on the stack costs nothing.
+ *
+ * As the class inherits from WoopsiArray it can be passed to any function
+ * that expects a pointer or reference to a WoopsiArray.
+ */
+template <class T, s32 N>
+class WoopsiSmallArray : public WoopsiArray<T> {
+public:
+
+	/**
+	 * Constructor.
+	 */
+	inline WoopsiSmallArray() : WoopsiArray<T>(_inlineData, N) { };
+
+	/**
+	 * Destructor.
+	 */
+	inline ~WoopsiSmallArray() { };
+
+	/**
+	 * Get the number of items that can be stored without allocating memory.
+	 * @return The inline capacity of the array.
+	 */
+	inline const s32 getInlineCapacity() const { return N; };
+
+private:
+	T _inlineData[N];						/**< Inline storage for the first N items */
+
+	/**
+	 * Copy constructor is private to prevent usage.
+	 */
+	inline WoopsiSmallArray(const WoopsiSmallArray<T, N>& array) : WoopsiArray<T>(_inlineData, N) { };
+};
+
+#endif
@@ -165,6 +165,14 @@ namespace WoopsiUI {
 		 */
 		virtual const s32 getByteCount() const { return _dataLength; };
 
+		/**
+		 * Returns a pointer to the raw char array data.  The data is UTF-8
+		 * encoded and is not terminated; use getByteCount() to find its
+		 * length.
+		 * @return Pointer to the char array.
+		 */
+		virtual inline const char* getCharArray() const { return _text; };
+
 		/**
 		 * Get the character at the specified index.  This function is useful
 		 * for finding the occasional character at an index, but for iterating
@@ -511,12 +519,6 @@ namespace WoopsiUI {
 		 */
 		s32 filterString(char* dest, const char* src, s32 sourceBytes, s32* totalUnicodeChars) const;
 
-		/**
-		 * Returns a pointer to the raw char array data.
-		 * @return Pointer to the char array.
-		 */
-		virtual inline const char* getCharArray() const { return _text; };
-
 		/**
 		 * Return a pointer to the specified UTF-8 token.
 		 * @param index Index of the UTF-8 token to retrieve.
@@ -3,7 +3,8 @@
 
 #include <nds.h>
 #include "gadget.h"
-#include "woopsi.h"
+#include "wheeltimer.h"
+#include "wheeltimerhandler.h"
 
 namespace WoopsiUI {
 
@@ -19,8 +20,12 @@ namespace WoopsiUI {
 	 *  - Catch the timer's action event and call any code that should run.
 	 *
 	 * The maximum speed for timer-driven code is one iteration per vertical blank.  
+	 *
+	 * Timers are scheduled in Woopsi's TimerWheel, so a timer that is not running
+	 * costs nothing per frame.  Code that does not need a gadget can use a
+	 * WheelTimer directly.
 	 */
-	class WoopsiTimer : public Gadget {
+	class WoopsiTimer : public Gadget, public WheelTimerHandler {
 	public:
 
 		/**
@@ -42,65 +47,63 @@ namespace WoopsiUI {
 		 * last event fired.
 		 * @return Frame count since the last event fired.
 		 */
-		inline const u32 getFrameCount() const { return _frameCount; };
+		const u32 getFrameCount() const;
 
 		/**
 		 * Resets the frame count back to 0.
 		 */
-		inline void reset() { _frameCount = 0; };
+		void reset();
 
 		/**
 		 * Starts the timer.
 		 */
-		inline void start() { _isRunning = true; };
+		void start();
 
 		/**
 		 * Stops the timer and resets the frame count.
 		 */
-		inline void stop() {
-			_isRunning = false;
-			_frameCount = 0;
-		};
+		void stop();
 
 		/**
 		 * Stops the timer but does not reset the frame count.
 		 */
-		inline void pause() { _isRunning = false; }
+		void pause();
 
 		/**
 		 * Set the timeout of this timer.
 		 * @param timeout The number of frames that this timer will run before firing an event.
 		 */
-		inline void setTimeout(u32 timeout) { _timeout = timeout; };
+		void setTimeout(u32 timeout);
 
 		/**
-		 * Run any code that should execute every VBL.
-		 * @return True if the function ran succesfully.
+		 * Check if the timer is running or not.
+		 * @return True if the timer is running; false if not.
 		 */
-		virtual bool run();
+		inline bool isRunning() const { return _wheelTimer.isScheduled(); };
 
 		/**
-		 * Check if the timer is running or not.
-		 * @return True if the timer is running; false if not.
+		 * Handle the underlying wheel timer expiring.
+		 * @param source The wheel timer that expired.
 		 */
-		inline bool isRunning() { return _isRunning; };
+		virtual void handleTimerExpired(WheelTimer& source);
 
 	protected:
-		u32 _frameCount;			/**< Number of frames run so far */
+		WheelTimer _wheelTimer;		/**< Schedules the timer's events */
+		u32 _frameCount;			/**< Number of frames run before the timer was last paused */
+		u32 _startTime;				/**< Wheel time at which the timer last started counting */
 		u32 _timeout;				/**< Number of frames to run before firing an event */
-		bool _isRunning;			/**< Indicates whether or not the timer is running */
 		bool _isRepeater;			/**< Indicates whether or not the timer repeats */
 
 		/**
 		 * Destructor.
 		 */
-		virtual inline ~WoopsiTimer() {
-			if (woopsiApplication != NULL) {
+		virtual inline ~WoopsiTimer() { };
 
-				// Prevent gadget from receiving VBLs
-				woopsiApplication->unregisterFromVBL(this);
-			}
-		};
+		/**
+		 * Schedule the wheel timer to fire once the remaining frames of the
+		 * current timeout have elapsed.
+		 */
+		void schedule();
 
 		/**
 		 * Copy constructor is protected to prevent usage.
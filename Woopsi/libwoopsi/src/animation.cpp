@@ -28,7 +28,9 @@ void Animation::addFrame(const BitmapBase* bitmap, const u8 delay) {
 }
 
 // Main function - should be called every VBL for animation to work properly
-void Animation::run() {
+bool Animation::run() {
+
+	u16 previousFrame = _currentFrame;
 	
 	// Is the animation playing?
 	if (_status == ANIMATION_STATUS_PLAYING) {
@@ -50,6 +52,8 @@ void Animation::run() {
 			}
 		}
 	}
+
+	return _currentFrame != previousFrame;
 }
 
 // Loop the animation if possible
@@ -0,0 +1,66 @@
+#include "animator.h"
+#include "animatable.h"
+
+using namespace WoopsiUI;
+
+Animator::Animator() {
+	_isRunning = false;
+}
+
+void Animator::add(Animatable* animatable) {
+	if (contains(animatable)) return;
+
+	_animatables.push_back(animatable);
+}
+
+void Animator::remove(Animatable* animatable) {
+	for (s32 i = 0; i < _animatables.size(); ++i) {
+		if (_animatables[i] == animatable) {
+
+			// Removing the object while running would disturb the loop in
+			// run(), so clear the entry and let run() erase it
+			if (_isRunning) {
+				_animatables[i] = NULL;
+			} else {
+				_animatables.erase(i);
+			}
+
+			return;
+		}
+	}
+}
+
+bool Animator::contains(const Animatable* animatable) const {
+	for (s32 i = 0; i < _animatables.size(); ++i) {
+		if (_animatables[i] == animatable) return true;
+	}
+
+	return false;
+}
+
+void Animator::run() {
+	_isRunning = true;
+
+	// Objects added by an animate() call are not run until the next frame
+	s32 size = _animatables.size();
+
+	for (s32 i = 0; i < size; ++i) {
+		if (_animatables[i] == NULL) continue;
+
+		if (!_animatables[i]->animate()) _animatables[i] = NULL;
+	}
+
+	_isRunning = false;
+
+	// Close the gaps left by finished and removed objects
+	s32 count = 0;
+
+	for (s32 i = 0; i < _animatables.size(); ++i) {
+		if (_animatables[i] != NULL) {
+			_animatables[count] = _animatables[i];
+			count++;
+		}
+	}
+
+	while (_animatables.size() > count) _animatables.pop_back();
+}
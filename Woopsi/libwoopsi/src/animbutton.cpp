@@ -1,7 +1,7 @@
 #include "animbutton.h"
+#include "animator.h"
 #include "graphicsport.h"
 #include "woopsi.h"
-#include "woopsitimer.h"
 #include "woopsipoint.h"
 
 using namespace WoopsiUI;
@@ -20,13 +20,12 @@ AnimButton::AnimButton(s16 x, s16 y, u16 width, u16 height, u16 animX, u16 animY
 
 	_initialised = false;
 
-	_timer = new WoopsiTimer(1, true);
-	addGadget(_timer);
-	_timer->setGadgetEventHandler(this);
-	_timer->start();
+	startAnimating();
 }
 
 AnimButton::~AnimButton() {
+	stopAnimating();
+
 	delete _animClicked;
 	delete _animNormal;
 }
@@ -76,24 +75,32 @@ Animation* const AnimButton::getClickedAnimation() {
 	return _animClicked;
 }
 
-void AnimButton::handleActionEvent(Gadget& source) {
-	if (&source == _timer) {
+bool AnimButton::animate() {
 
-		// Ensure the animations are running
-		if (!_initialised) {
-			_animNormal->play();
-			_initialised = true;
-		}
+	// Ensure the animations are running
+	if (!_initialised) {
+		_animNormal->play();
+		_initialised = true;
+	}
 
-		// Run the animations
-		if (_flags.clicked) {
-			_animClicked->run();
-		} else {
-			_animNormal->run();
-		}
+	Animation* anim = _flags.clicked ? _animClicked : _animNormal;
 
-		markRectsDamaged();
-	}
+	// Only redraw if the animation has moved to a new frame
+	if (anim->run()) markRectsDamaged();
+
+	return anim->getStatus() == Animation::ANIMATION_STATUS_PLAYING;
+}
+
+void AnimButton::startAnimating() {
+	if (woopsiApplication == NULL) return;
+
+	woopsiApplication->getAnimator()->add(this);
+}
+
+void AnimButton::stopAnimating() {
+	if (woopsiApplication == NULL) return;
+
+	woopsiApplication->getAnimator()->remove(this);
 }
 
 void AnimButton::onClick(s16 x, s16 y) {
@@ -101,6 +108,9 @@ void AnimButton::onClick(s16 x, s16 y) {
 	// Swap animations
 	_animNormal->stop();
 	_animClicked->play();
+
+	startAnimating();
+	markRectsDamaged();
 }
 
 void AnimButton::onRelease(s16 x, s16 y) {
@@ -111,6 +121,9 @@ void AnimButton::onRelease(s16 x, s16 y) {
 	// Swap animations
 	_animNormal->play();
 	_animClicked->stop();
+
+	startAnimating();
+	markRectsDamaged();
 }
 
 void AnimButton::onReleaseOutside(s16 x, s16 y) {
@@ -118,6 +131,9 @@ void AnimButton::onReleaseOutside(s16 x, s16 y) {
 	// Swap animations
 	_animNormal->play();
 	_animClicked->stop();
+
+	startAnimating();
+	markRectsDamaged();
 }
 
 // Get the preferred dimensions of the gadget
@@ -157,7 +173,9 @@ void AnimButton::onDisable() {
 	// Pause running animations
 	_animNormal->pause();
 	_animClicked->pause();
-	_timer->pause();
+
+	stopAnimating();
+	markRectsDamaged();
 }
 
 void AnimButton::onEnable() {
@@ -169,5 +187,6 @@ void AnimButton::onEnable() {
 		_animNormal->play();
 	}
 
-	_timer->start();
+	startAnimating();
+	markRectsDamaged();
 }
@@ -0,0 +1,215 @@
+#include "backingstore.h"
+#include "damagedrectmanager.h"
+#include "defines.h"
+#include "framebuffer.h"
+#include "gadget.h"
+#include "graphicsport.h"
+#include "hardware.h"
+#include "woopsi.h"
+
+using namespace WoopsiUI;
+
+BackingStore::BackingStore(Gadget* gadget, bool isTrackingDisplay) {
+	_gadget = gadget;
+	_data = NULL;
+	_bitmap = NULL;
+	_isTrackingDisplay = isTrackingDisplay;
+
+	resizeBitmap();
+
+	if (_isTrackingDisplay) {
+		woopsiApplication->getDamagedRectManager()->addBackingStore(this);
+	}
+}
+
+BackingStore::~BackingStore() {
+
+	// The damaged rect manager is deleted before the gadget hierarchy when
+	// Woopsi shuts down
+	if ((_isTrackingDisplay) && (woopsiApplication != NULL)) {
+		woopsiApplication->getDamagedRectManager()->removeBackingStore(this);
+	}
+
+	delete _bitmap;
+	delete [] _data;
+}
+
+void BackingStore::markDamaged(const Region& region) {
+	if (_validRegion.isEmpty()) return;
+
+	Region damagedRegion(region);
+	damagedRegion.translate(-_gadget->getX(), -_gadget->getY());
+
+	_validRegion.subtractRegion(damagedRegion);
+}
+
+void BackingStore::invalidate() {
+	_validRegion.clear();
+}
+
+void BackingStore::resizeBitmap() {
+	if ((_bitmap != NULL) && (_bitmap->getWidth() == _gadget->getWidth()) && (_bitmap->getHeight() == _gadget->getHeight())) return;
+
+	delete _bitmap;
+	delete [] _data;
+
+	_data = new u16[_gadget->getWidth() * _gadget->getHeight()];
+	_bitmap = new FrameBuffer(_data, _gadget->getWidth(), _gadget->getHeight());
+
+	_validRegion.clear();
+}
+
+FrameBuffer* BackingStore::getFrameBuffer() const {
+	return _gadget->getPhysicalScreenNumber() == 1 ? Hardware::getTopBuffer() : Hardware::getBottomBuffer();
+}
+
+s16 BackingStore::getFrameBufferY() const {
+	return ((_gadget->getY() >= TOP_SCREEN_Y_OFFSET) && (SCREEN_COUNT > 1)) ? TOP_SCREEN_Y_OFFSET : 0;
+}
+
+void BackingStore::capture() {
+
+	resizeBitmap();
+
+	if (!_gadget->isDrawingEnabled()) return;
+
+	_gadget->cacheVisibleRects();
+
+	const Region* visibleRegion = _gadget->getForegroundRegion();
+	const FrameBuffer* frameBuffer = getFrameBuffer();
+
+	s16 x = _gadget->getX();
+	s16 y = _gadget->getY();
+
+	// Framebuffer co-ordinates are relative to the top of the display
+	s16 displayY = getFrameBufferY();
+
+	for (s32 i = 0; i < visibleRegion->getRectCount(); ++i) {
+		const Rect& rect = visibleRegion->getRect(i);
+
+		for (s16 row = rect.y; row < rect.y + rect.height; ++row) {
+			frameBuffer->copy(rect.x, row - displayY, rect.width, _data + ((row - y) * _bitmap->getWidth()) + (rect.x - x));
+		}
+	}
+
+	Region capturedRegion(*visibleRegion);
+	capturedRegion.translate(-x, -y);
+
+	_validRegion.addRegion(capturedRegion);
+}
+
+void BackingStore::update() {
+
+	resizeBitmap();
+
+	if (!_gadget->isDrawingEnabled()) return;
+
+	s16 x = _gadget->getX();
+	s16 y = _gadget->getY();
+
+	// Work out which parts of the gadget are out of date.  We can only
+	// render the parts that fall within the gadget's ancestors.
+	Rect rect;
+	_gadget->getRectClippedToHierarchy(rect);
+
+	Region staleRegion(rect);
+	staleRegion.translate(-x, -y);
+	staleRegion.subtractRegion(_validRegion);
+
+	if (staleRegion.isEmpty()) return;
+
+	// Render the out of date parts into the bitmap
+	Region drawRegion(staleRegion);
+	drawRegion.translate(x, y);
+
+	// Layers within the gadget render themselves into their own stores, so
+	// we need to restore the previous render target afterwards
+	FrameBuffer* renderTarget = Gadget::getRenderTarget();
+	s16 renderTargetX = Gadget::getRenderTargetX();
+	s16 renderTargetY = Gadget::getRenderTargetY();
+
+	Gadget::setRenderTarget(_bitmap, x, y);
+	woopsiApplication->getDamagedRectManager()->drawRegion(_gadget, drawRegion);
+	Gadget::setRenderTarget(renderTarget, renderTargetX, renderTargetY);
+
+	_validRegion.addRegion(staleRegion);
+}
+
+void BackingStore::draw() {
+
+	if (!_gadget->isDrawingEnabled()) return;
+
+	_gadget->cacheVisibleRects();
+
+	s16 x = _gadget->getX();
+	s16 y = _gadget->getY();
+
+	// Copy the up to date parts of the store that are visible
+	Region blitRegion(_validRegion);
+	blitRegion.translate(x, y);
+	blitRegion.intersectRegion(*_gadget->getForegroundRegion());
+
+	if (!blitRegion.isEmpty()) {
+		GraphicsPort port(x, y, _gadget->getWidth(), _gadget->getHeight(), true, getFrameBuffer(), &blitRegion, NULL);
+		port.drawBitmap(0, 0, _bitmap->getWidth(), _bitmap->getHeight(), _bitmap, 0, 0);
+	}
+
+	// Anything else must be redrawn
+	Region missingRegion(*_gadget->getForegroundRegion());
+	missingRegion.subtractRegion(blitRegion);
+
+	if (!missingRegion.isEmpty()) {
+		woopsiApplication->getDamagedRectManager()->addDamagedRegion(missingRegion);
+	}
+}
+
+void BackingStore::composite(const Region& region, u8 alpha) {
+
+	if (alpha == 0) return;
+
+	s16 x = _gadget->getX();
+	s16 y = _gadget->getY();
+
+	// Work out where the target bitmap is in Woopsi-space
+	FrameBuffer* target = Gadget::getRenderTarget();
+	s16 targetX = Gadget::getRenderTargetX();
+	s16 targetY = Gadget::getRenderTargetY();
+
+	if (target == NULL) {
+		target = getFrameBuffer();
+		targetX = 0;
+		targetY = getFrameBufferY();
+	}
+
+	u16 width = _bitmap->getWidth();
+
+	for (s32 i = 0; i < region.getRectCount(); ++i) {
+		const Rect& rect = region.getRect(i);
+
+		for (s16 row = rect.y; row < rect.y + rect.height; ++row) {
+			const u16* source = _data + ((row - y) * width) + (rect.x - x);
+
+			if (alpha == 255) {
+				target->blit(rect.x - targetX, row - targetY, source, rect.width);
+				continue;
+			}
+
+			for (s16 column = 0; column < rect.width; ++column) {
+				s16 destX = rect.x + column - targetX;
+				s16 destY = row - targetY;
+
+				target->setPixel(destX, destY, blend(source[column], target->getPixel(destX, destY), alpha));
+			}
+		}
+	}
+}
+
+u16 BackingStore::blend(u16 source, u16 dest, u8 alpha) {
+	u16 inverse = 255 - alpha;
+
+	u16 r = (((source & 31) * alpha) + ((dest & 31) * inverse)) / 255;
+	u16 g = ((((source >> 5) & 31) * alpha) + (((dest >> 5) & 31) * inverse)) / 255;
+	u16 b = ((((source >> 10) & 31) * alpha) + (((dest >> 10) & 31) * inverse)) / 255;
+
+	return woopsiRGB(r, g, b);
+}
@@ -0,0 +1,33 @@
+#include "colourtween.h"
+#include "gadget.h"
+#include "graphics.h"
+
+using namespace WoopsiUI;
+
+ColourTween::ColourTween(Gadget* gadget, u16 colour, u16 frames, Easing easing) : Tween(0, PROGRESS_MAX, frames, easing) {
+	_gadget = gadget;
+	_fromColour = gadget->getBackColour();
+	_toColour = colour;
+}
+
+void ColourTween::start() {
+	_fromColour = _gadget->getBackColour();
+
+	Tween::start();
+}
+
+void ColourTween::update(s32 progress) {
+	u16 r = interpolate(_fromColour & 31, _toColour & 31, progress);
+	u16 g = interpolate((_fromColour >> 5) & 31, (_toColour >> 5) & 31, progress);
+	u16 b = interpolate((_fromColour >> 10) & 31, (_toColour >> 10) & 31, progress);
+
+	u16 colour = woopsiRGB(r, g, b);
+
+	// Only redraw when the fade reaches a new colour
+	if (colour != _gadget->getBackColour()) {
+		_gadget->setBackColour(colour);
+		_gadget->markRectsDamaged();
+	}
+
+	Tween::update(progress);
+}
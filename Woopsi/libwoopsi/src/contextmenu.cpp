@@ -78,6 +78,10 @@ void ContextMenu::reset() {
 	_rect.setY(0);
 	_rect.setWidth(0);
 	_rect.setHeight(0);
+
+	invalidateCachedState();
+
+	if (_parent != NULL) _parent->invalidateSpatialIndex();
 }
 
 // Get the preferred dimensions of the gadget
@@ -21,7 +21,10 @@ CycleButton::CycleButton(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style
 }
 
 void CycleButton::addOption(const WoopsiString& text, const u32 value) {
-	_options.addItem(new ListDataItem(text, value));
+	ListDataItem* item = new ListDataItem(text, value);
+	item->setTextSortKeyEnabled(true);
+
+	_options.addItem(item);
 
 	// Select the option if this is the first option added
 	if (_options.getItemCount() == 1) {
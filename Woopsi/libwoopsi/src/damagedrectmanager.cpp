@@ -1,108 +1,237 @@
 #include "damagedrectmanager.h"
+#include "backingstore.h"
 #include "gadget.h"
+#include "defines.h"
+#include "woopsismallarray.h"
 
 using namespace WoopsiUI;
 
 DamagedRectManager::DamagedRectManager(Gadget* gadget) {
 	_gadget = gadget;
-	_damagedRects = new WoopsiArray<Rect>(4);
+	_rectCost = DAMAGED_RECT_COST;
+
+	_redrawStats.damagedArea = 0;
+	_redrawStats.drawnArea = 0;
+	_redrawStats.damagedRectCount = 0;
+	_redrawStats.drawnRectCount = 0;
+	_redrawStats.paintedArea = 0;
 }
 
 DamagedRectManager::~DamagedRectManager() {
-	delete _damagedRects;
 }
 
 void DamagedRectManager::addDamagedRect(const Rect& rect) {
 
-	WoopsiArray<Rect> newRects(4);
-	WoopsiArray<Rect> remainingRects(4);
-	Rect intersection;
+	// The region ensures that the new rect does not overlap any existing
+	// rects - we only want to draw each region once
+	_damagedRegion.addRect(rect);
+}
 
-	newRects.push_back(rect);
+void DamagedRectManager::addDamagedRegion(const Region& region) {
+	_damagedRegion.addRegion(region);
+}
 
-	// Ensure that the new rect does not overlap any existing rects - we only
-	// want to draw each region once
-	for (s32 i = 0; i < _damagedRects->size(); ++i) {
-		for (s32 j = 0; j < newRects.size(); ++j) {
+void DamagedRectManager::removeDamagedRegion(const Region& region) {
+	_damagedRegion.subtractRegion(region);
+}
 
-			if (_damagedRects->at(i).splitIntersection(newRects[j], intersection, &remainingRects)) {
-				// Intersection contains the part of the new rect that is already known to be damaged
-				// and can be discarded.  remainingRects contains the rects that still need to be examined
+void DamagedRectManager::drawRegion(Gadget* gadget, Region& region) {
+	
+	if (!gadget->isDrawingEnabled()) return;
 
-				newRects.erase(j);
-				j--;
+	Rect gadgetRect;
+	gadget->getRectClippedToHierarchy(gadgetRect);
 
-				// Insert non-overlapping rects to the front of the array so that they are not
-				// examined again for this particular damaged rect
-				for (s32 k = 0; k < remainingRects.size(); ++k) {
-					newRects.insert(0, remainingRects[k]);
-					j++;
-				}
+	Region subRegion(region);
+	subRegion.intersectRect(gadgetRect);
 
-				remainingRects.clear();
-			}
+	region.subtractRect(gadgetRect);
+
+	// Draw the gadget itself rather than compositing it if it is a layer -
+	// this is how layers render their surfaces
+	drawGadget(gadget, subRegion);
+}
+
+void DamagedRectManager::addBackingStore(BackingStore* backingStore) {
+	_backingStores.push_back(backingStore);
+}
+
+void DamagedRectManager::removeBackingStore(BackingStore* backingStore) {
+	for (s32 i = 0; i < _backingStores.size(); ++i) {
+		if (_backingStores[i] == backingStore) {
+			_backingStores.erase(i);
+			return;
 		}
 	}
+}
 
-	// Add any non-overlapping rects into the damaged rect array
-	for (s32 i = 0; i < newRects.size(); ++i) {
-		_damagedRects->push_back(newRects[i]);
+void DamagedRectManager::redraw() {
+
+	// Any backing stores that hold copies of the damaged areas are now out
+	// of date
+	for (s32 i = 0; i < _backingStores.size(); ++i) {
+		_backingStores[i]->markDamaged(_damagedRegion);
 	}
+
+	_redrawStats.damagedArea = _damagedRegion.getArea();
+	_redrawStats.damagedRectCount = _damagedRegion.getRectCount();
+
+	coalesce();
+
+	_redrawStats.drawnArea = _damagedRegion.getArea();
+	_redrawStats.drawnRectCount = _damagedRegion.getRectCount();
+	_redrawStats.paintedArea = 0;
+
+	drawRects(_gadget, _damagedRegion);
 }
 
-void DamagedRectManager::redraw() {
-	drawRects(_gadget, _damagedRects);
+void DamagedRectManager::coalesce() {
+
+	if (_damagedRegion.getRectCount() < 2) return;
+
+	WoopsiSmallArray<Rect, 8> rects;
+	Rect box;
+	Rect overlap;
+	bool merged = false;
+
+	for (s32 i = 0; i < _damagedRegion.getRectCount(); ++i) {
+		rects.push_back(_damagedRegion.getRect(i));
+	}
+
+	// Greedily merge each rect with any later rect that it can absorb
+	// cheaply.  The merged box may now be able to absorb rects that it
+	// previously could not, so keep going until no more merges happen.
+	bool mergedThisPass = true;
+
+	while (mergedThisPass) {
+		mergedThisPass = false;
+
+		for (s32 i = 0; i < rects.size(); ++i) {
+			for (s32 j = i + 1; j < rects.size(); ++j) {
+
+				rects[i].getAddition(rects[j], box);
+
+				// Work out how many pixels the box covers that neither rect
+				// covers
+				s32 overdraw = (box.width * box.height) - (rects[i].width * rects[i].height) - (rects[j].width * rects[j].height);
+
+				if (rects[i].intersects(rects[j])) {
+					rects[i].getIntersect(rects[j], overlap);
+					overdraw += overlap.width * overlap.height;
+				}
+
+				if (overdraw <= _rectCost) {
+					rects[i] = box;
+					rects.erase(j);
+
+					// Re-examine every later rect against the larger box
+					j = i;
+
+					merged = true;
+					mergedThisPass = true;
+				}
+			}
+		}
+	}
+
+	if (!merged) return;
+
+	// Rebuild the region from the merged rects
+	_damagedRegion.clear();
+
+	for (s32 i = 0; i < rects.size(); ++i) {
+		_damagedRegion.addRect(rects[i]);
+	}
 }
 			
-void DamagedRectManager::drawRects(Gadget* gadget, WoopsiArray<Rect>* damagedRects) {
+void DamagedRectManager::drawRects(Gadget* gadget, Region& damagedRegion) {
 	
 	if (!gadget->isDrawingEnabled()) return;
 	
 	Rect gadgetRect;
-	Rect damagedRect;
-	Rect intersection;
-	
 	gadget->getRectClippedToHierarchy(gadgetRect);
+
+	if (!damagedRegion.intersects(gadgetRect)) return;
 	
-	WoopsiArray<Rect> remainingRects(4);
-	WoopsiArray<Rect> subRects(4);
+	// Work out which part of the damaged region intersects the current gadget
+	// and remove it from the region of undrawn rects
+	Region subRegion(damagedRegion);
+	subRegion.intersectRect(gadgetRect);
+
+	damagedRegion.subtractRect(gadgetRect);
+
+	// If this gadget does not cover everything beneath it, the gadgets below
+	// it must paint the intersection first
+	if ((!gadget->isOpaque()) && (gadget->getParent() != NULL)) {
+		Region beneathRegion(subRegion);
+		drawBeneath(gadget, beneathRegion);
+	}
+
+	if (gadget->isLayer()) {
+		compositeLayer(gadget, subRegion);
+	} else {
+		drawGadget(gadget, subRegion);
+	}
+}
+
+void DamagedRectManager::compositeLayer(Gadget* gadget, const Region& region) {
 	
-	// Work out which of the damaged rects collide with the current gadget
-	for (s32 i = 0; i < damagedRects->size(); ++i) {
-		damagedRect = damagedRects->at(i);
-		
-		// Work out which part of the damaged rect intersects the current gadget
-		if (gadgetRect.splitIntersection(damagedRect, intersection, &remainingRects)) {
-			damagedRects->erase(i);
-			i--;
-			
-			// Add the non-intersecting parts of the damaged rect back into the
-			// list of undrawn rects
-			for (s32 j = 0; j < remainingRects.size(); ++j) {
-				damagedRects->insert(0, remainingRects[j]);
-				i++;
-			}
-			
-			remainingRects.clear();
-			
-			// Get children to draw all parts of themselves that intersect the
-			// intersection we've found.
-			subRects.push_back(intersection);
-			
-			for (s32 j = gadget->getGadgetCount() - 1; j >= 0; --j) {
-				drawRects(gadget->getGadget(j), &subRects);
-				
-				// Abort if all rects have been drawn
-				if (subRects.size() == 0) break;
-			}
-			
-			// Children have drawn themselves; anything left in the subRects
-			// array must overlap this gadget
-			for (s32 j = 0; j < subRects.size(); ++j) {
-				gadget->redraw(subRects[j]);
-			}
+	// Bring the out of date parts of the layer's surface up to date, then
+	// copy the damaged region from the surface
+	gadget->getLayer()->update();
+	gadget->getLayer()->composite(region, gadget->getLayerAlpha());
+
+	_redrawStats.paintedArea += region.getArea();
+}
+
+void DamagedRectManager::drawGadget(Gadget* gadget, Region& subRegion) {
+	
+	// Get children to draw all parts of themselves that intersect the
+	// intersection we've found.  If the gadget has a spatial index we only
+	// need to visit the children that overlap the intersection.
+	WoopsiSmallArray<s32, 8> candidates;
+
+	if (gadget->getGadgetsIntersecting(subRegion.getBounds(), candidates)) {
+		for (s32 i = 0; i < candidates.size(); ++i) {
+			drawRects(gadget->getGadget(candidates[i]), subRegion);
+
+			// Abort if all rects have been drawn
+			if (subRegion.isEmpty()) break;
+		}
+	} else {
+		for (s32 i = gadget->getGadgetCount() - 1; i >= 0; --i) {
+			drawRects(gadget->getGadget(i), subRegion);
 			
-			subRects.clear();
+			// Abort if all rects have been drawn
+			if (subRegion.isEmpty()) break;
 		}
 	}
-}		
+	
+	// Children have drawn themselves; anything left in the subregion must
+	// overlap this gadget
+	paintRegion(gadget, subRegion);
+}
+
+void DamagedRectManager::drawBeneath(Gadget* gadget, Region& damagedRegion) {
+
+	Gadget* parent = gadget->getParent();
+
+	for (s32 i = parent->getGadgetIndex(gadget) - 1; i >= 0; --i) {
+		drawRects(parent->getGadget(i), damagedRegion);
+
+		if (damagedRegion.isEmpty()) return;
+	}
+
+	// Anything left lies over the parent.  We do not need to draw beneath the
+	// parent if it is non-opaque as that has already been done before its
+	// children were drawn.
+	paintRegion(parent, damagedRegion);
+}
+
+void DamagedRectManager::paintRegion(Gadget* gadget, const Region& region) {
+	for (s32 i = 0; i < region.getRectCount(); ++i) {
+		gadget->redraw(region.getRect(i));
+	}
+
+	_redrawStats.paintedArea += region.getArea();
+}
@@ -3,7 +3,7 @@
 #include "debug.h"
 #include "hardware.h"
 #include "pad.h"
-#include "scrollingtextbox.h"
+#include "scrollinglogtextbox.h"
 #include "tinyfont.h"
 #include "woopsi.h"
 #include "woopsifuncs.h"
@@ -40,9 +40,12 @@ void Debug::output(const WoopsiString& text) {
 		if (woopsiApplication != NULL) {
 			createDebug();
 
-			_debug->_textBox->appendText(">");
-			_debug->_textBox->appendText(text);
-			_debug->_textBox->appendText("\n");
+			// Append the whole line at once so that it is only drawn once
+			WoopsiString line(">");
+			line.append(text);
+			line.append("\n");
+
+			_debug->_textBox->appendText(line);
 		}
 	}
 }
@@ -104,10 +107,8 @@ void Debug::createGUI() {
 		Rect rect;
 		_window->getClientRect(rect);
 
-		_textBox = new ScrollingTextBox(rect.x, rect.y, rect.width, rect.height, "", 50, _style);
+		_textBox = new ScrollingLogTextBox(rect.x, rect.y, rect.width, rect.height, 50, _style);
 		_window->addGadget(_textBox);
-		_textBox->setTextAlignmentHoriz(MultiLineTextBox::TEXT_ALIGNMENT_HORIZ_LEFT);
-		_textBox->setTextAlignmentVert(MultiLineTextBox::TEXT_ALIGNMENT_VERT_TOP);
 		_textBox->appendText("Woopsi Version ");
 		_textBox->appendText(WOOPSI_VERSION);
 		_textBox->appendText("\n");
@@ -0,0 +1,170 @@
+#include "directorycache.h"
+
+#if defined(USING_SDL) && defined(__linux__)
+#define DIRECTORY_CACHE_USES_INOTIFY
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace WoopsiUI;
+
+DirectoryCache::DirectoryCache(const s32 capacity) {
+	_capacity = capacity;
+	_inotifyFd = -1;
+
+#ifdef DIRECTORY_CACHE_USES_INOTIFY
+	_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+DirectoryCache::~DirectoryCache() {
+	clear();
+
+#ifdef DIRECTORY_CACHE_USES_INOTIFY
+	if (_inotifyFd >= 0) close(_inotifyFd);
+#endif
+}
+
+const WoopsiArray<DirectoryReader::Entry>* DirectoryCache::getListing(const WoopsiString& path) {
+	if (_inotifyFd < 0) return NULL;
+
+	processEvents();
+
+	s32 index = findListing(path);
+
+	if ((index < 0) || (!_listings[index]->isComplete)) return NULL;
+
+	// Move the listing to the front of the list as it is now the most
+	// recently used
+	Listing* listing = _listings[index];
+	_listings.erase(index);
+	_listings.insert(0, listing);
+
+	return &listing->entries;
+}
+
+void DirectoryCache::beginListing(const WoopsiString& path) {
+	if (_inotifyFd < 0) return;
+
+	processEvents();
+
+	s32 index = findListing(path);
+	if (index > -1) removeListing(index);
+
+#ifdef DIRECTORY_CACHE_USES_INOTIFY
+
+	char* buffer = new char[path.getByteCount() + 1];
+	path.copyToCharArray(buffer);
+
+	// Watch for anything that would change the listing, including the
+	// directory itself being deleted or moved
+	s32 watch = inotify_add_watch(_inotifyFd, buffer, IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR);
+
+	delete[] buffer;
+
+	if (watch < 0) return;
+
+	// Make room by discarding the least recently used listings
+	while ((_listings.size() > 0) && (_listings.size() >= _capacity)) {
+		removeListing(_listings.size() - 1);
+	}
+
+	Listing* listing = new Listing;
+	listing->path = path;
+	listing->watch = watch;
+	listing->isComplete = false;
+
+	_listings.insert(0, listing);
+
+#endif
+}
+
+void DirectoryCache::storeListing(const WoopsiString& path, const WoopsiArray<DirectoryReader::Entry>& entries) {
+	if (_inotifyFd < 0) return;
+
+	// Any changes since beginListing() was called will remove the listing
+	processEvents();
+
+	s32 index = findListing(path);
+
+	if ((index < 0) || (_listings[index]->isComplete)) return;
+
+	Listing* listing = _listings[index];
+
+	for (s32 i = 0; i < entries.size(); ++i) {
+		listing->entries.push_back(entries[i]);
+	}
+
+	listing->isComplete = true;
+}
+
+void DirectoryCache::invalidate(const WoopsiString& path) {
+	s32 index = findListing(path);
+
+	if (index > -1) removeListing(index);
+}
+
+void DirectoryCache::clear() {
+	while (_listings.size() > 0) {
+		removeListing(_listings.size() - 1);
+	}
+}
+
+s32 DirectoryCache::findListing(const WoopsiString& path) const {
+	for (s32 i = 0; i < _listings.size(); ++i) {
+
+		// Paths are case-sensitive
+		if (_listings[i]->path.compareTo(path, true) == 0) return i;
+	}
+
+	return -1;
+}
+
+void DirectoryCache::removeListing(const s32 index) {
+	s32 watch = _listings[index]->watch;
+
+	delete _listings[index];
+	_listings.erase(index);
+
+	// Different paths to the same directory share a watch descriptor, so the
+	// watch can only be removed once no listings use it
+	for (s32 i = 0; i < _listings.size(); ++i) {
+		if (_listings[i]->watch == watch) return;
+	}
+
+#ifdef DIRECTORY_CACHE_USES_INOTIFY
+	inotify_rm_watch(_inotifyFd, watch);
+#endif
+}
+
+void DirectoryCache::processEvents() {
+
+#ifdef DIRECTORY_CACHE_USES_INOTIFY
+
+	char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	// The descriptor is non-blocking, so this stops as soon as there are no
+	// more events waiting
+	while (true) {
+		ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+
+		if (length <= 0) break;
+
+		for (char* ptr = buffer; ptr < buffer + length; ) {
+			const struct inotify_event* event = (const struct inotify_event*)ptr;
+			ptr += sizeof(struct inotify_event) + event->len;
+
+			// Events were lost, so nothing can be trusted
+			if (event->mask & IN_Q_OVERFLOW) {
+				clear();
+				continue;
+			}
+
+			for (s32 i = _listings.size() - 1; i > -1; --i) {
+				if (_listings[i]->watch == event->wd) removeListing(i);
+			}
+		}
+	}
+
+#endif
+}
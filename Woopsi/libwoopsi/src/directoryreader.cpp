@@ -0,0 +1,236 @@
+#include <string.h>
+#include <sys/stat.h>
+#include "directoryreader.h"
+#include "defines.h"
+
+using namespace WoopsiUI;
+
+DirectoryReader::DirectoryReader() {
+	_pathBuffer = NULL;
+	_pathLength = 0;
+
+#ifdef USING_SDL
+	_thread = NULL;
+	_mutex = SDL_CreateMutex();
+	_threadComplete = true;
+	_cancelled = false;
+#else
+	_dir = NULL;
+#endif
+}
+
+DirectoryReader::~DirectoryReader() {
+	close();
+
+#ifdef USING_SDL
+	SDL_DestroyMutex(_mutex);
+#endif
+}
+
+void DirectoryReader::open(const WoopsiString& path) {
+	close();
+
+	// Leave room for a separator, the longest possible entry name and a
+	// terminator so that the full path of each entry can be built in place
+	_pathLength = path.getByteCount();
+	_pathBuffer = new char[_pathLength + sizeof(((struct dirent*)NULL)->d_name) + 2];
+	path.copyToCharArray(_pathBuffer);
+
+	if ((_pathLength == 0) || (_pathBuffer[_pathLength - 1] != '/')) {
+		_pathBuffer[_pathLength++] = '/';
+		_pathBuffer[_pathLength] = '\0';
+	}
+
+#ifdef USING_SDL
+
+	_threadComplete = false;
+	_cancelled = false;
+
+	_thread = SDL_CreateThread(threadEntry, "DirectoryReader", this);
+
+	// Fall back to reading the whole directory immediately if no thread
+	// could be created
+	if (_thread == NULL) readAll();
+
+#else
+
+	_dir = opendir(_pathBuffer);
+
+#endif
+}
+
+void DirectoryReader::close() {
+
+#ifdef USING_SDL
+
+	if (_thread != NULL) {
+		_cancelled = true;
+		SDL_WaitThread(_thread, NULL);
+		_thread = NULL;
+	}
+
+	_queue.clear();
+	_threadComplete = true;
+
+#else
+
+	if (_dir != NULL) {
+		closedir(_dir);
+		_dir = NULL;
+	}
+
+#endif
+
+	delete[] _pathBuffer;
+	_pathBuffer = NULL;
+	_pathLength = 0;
+}
+
+s32 DirectoryReader::read(WoopsiArray<Entry>& entries) {
+
+#ifdef USING_SDL
+
+	SDL_LockMutex(_mutex);
+
+	s32 count = _queue.size();
+
+	for (s32 i = 0; i < count; ++i) {
+		entries.push_back(_queue[i]);
+	}
+
+	_queue.clear();
+
+	SDL_UnlockMutex(_mutex);
+
+	return count;
+
+#else
+
+	if (_dir == NULL) return 0;
+
+	s32 count = 0;
+	struct dirent* ent;
+
+	while (count < DIRECTORY_READ_BATCH_SIZE) {
+		ent = readdir(_dir);
+
+		if (ent == NULL) {
+
+			// Reached the end of the directory
+			closedir(_dir);
+			_dir = NULL;
+			break;
+		}
+
+		if (strcmp(ent->d_name, ".") == 0) continue;
+
+		Entry entry;
+		if (!getIsDirectory(ent, entry.isDirectory)) continue;
+
+		entry.name = ent->d_name;
+		entries.push_back(entry);
+		count++;
+	}
+
+	return count;
+
+#endif
+}
+
+bool DirectoryReader::isComplete() {
+
+#ifdef USING_SDL
+
+	SDL_LockMutex(_mutex);
+	bool complete = _threadComplete && (_queue.size() == 0);
+	SDL_UnlockMutex(_mutex);
+
+	return complete;
+
+#else
+
+	return _dir == NULL;
+
+#endif
+}
+
+#ifdef USING_SDL
+
+int DirectoryReader::threadEntry(void* data) {
+	((DirectoryReader*)data)->readAll();
+	return 0;
+}
+
+void DirectoryReader::readAll() {
+	DIR* dir = opendir(_pathBuffer);
+
+	if (dir != NULL) {
+		WoopsiArray<Entry> batch;
+		struct dirent* ent;
+
+		while ((!_cancelled) && ((ent = readdir(dir)) != NULL)) {
+
+			if (strcmp(ent->d_name, ".") == 0) continue;
+
+			Entry entry;
+			if (!getIsDirectory(ent, entry.isDirectory)) continue;
+
+			entry.name = ent->d_name;
+			batch.push_back(entry);
+
+			// Publish in batches to keep contention on the mutex low
+			if (batch.size() >= DIRECTORY_READ_BATCH_SIZE) publish(batch);
+		}
+
+		publish(batch);
+
+		closedir(dir);
+	}
+
+	SDL_LockMutex(_mutex);
+	_threadComplete = true;
+	SDL_UnlockMutex(_mutex);
+}
+
+void DirectoryReader::publish(WoopsiArray<Entry>& batch) {
+	SDL_LockMutex(_mutex);
+
+	for (s32 i = 0; i < batch.size(); ++i) {
+		_queue.push_back(batch[i]);
+	}
+
+	SDL_UnlockMutex(_mutex);
+
+	batch.clear();
+}
+
+#endif
+
+bool DirectoryReader::getIsDirectory(const struct dirent* ent, bool& isDirectory) {
+
+#ifdef DT_DIR
+
+	// Use the type reported by the directory listing if there is one.
+	// Symbolic links are resolved with stat() below so that links to
+	// directories can be followed.
+	if (ent->d_type == DT_DIR) {
+		isDirectory = true;
+		return true;
+	}
+
+	if ((ent->d_type != DT_UNKNOWN) && (ent->d_type != DT_LNK)) {
+		isDirectory = false;
+		return true;
+	}
+
+#endif
+
+	struct stat st;
+
+	strcpy(_pathBuffer + _pathLength, ent->d_name);
+
+	if (stat(_pathBuffer, &st) != 0) return false;
+
+	isDirectory = (st.st_mode & S_IFDIR) != 0;
+	return true;
+}
@@ -1,13 +1,86 @@
 #include "document.h"
-#include "stringiterator.h"
 
 using namespace WoopsiUI;
 
+/**
+ * Ways in which a line can be broken at a character.
+ */
+enum BreakClass {
+	BREAK_CLASS_NONE = 0,			/**< Line cannot be broken at the character */
+	BREAK_CLASS_AFTER = 1,			/**< Line can be broken after the character */
+	BREAK_CLASS_NEWLINE = 2			/**< Line must be broken at the character */
+};
+
+/**
+ * Break class of each ASCII character.  Lines cannot be broken after any
+ * character beyond ASCII.
+ */
+static const u8 BREAK_CLASSES[128] = {
+	1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0,		// '\0', '\n'
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,		// ' ', '!', '+', ',', '-', '.', '/'
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 0, 1,		// ':', ';', '=', '?'
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/**
+ * Decode the UTF-8 token at the supplied position.  As in WoopsiString, tokens
+ * may be up to 6 bytes long.  A token that would extend past the end of the
+ * data is treated as a single byte so that the data is never overrun.
+ * @param text Pointer to the first byte of the token.
+ * @param remaining The number of bytes of data from the start of the token.
+ * @param bytes Populated with the number of bytes in the token.
+ * @return The codepoint.
+ */
+static inline u32 decodeCodePoint(const u8* text, s32 remaining, u8& bytes) {
+	if (text[0] < 0x80) {
+		bytes = 1;
+		return text[0];
+	}
+	
+	s32 size = text[0] < 0xE0 ? 2 : text[0] < 0xF0 ? 3 : text[0] < 0xF8 ? 4 : text[0] < 0xFC ? 5 : 6;
+	
+	if (size > remaining) {
+		bytes = 1;
+		return text[0];
+	}
+	
+	if (text[0] < 0xE0) {
+		bytes = 2;
+		return ((text[0] & 0x1F) << 6) | (text[1] & 0x3F);
+	}
+	
+	if (text[0] < 0xF0) {
+		bytes = 3;
+		return ((text[0] & 0x0F) << 12) | ((text[1] & 0x3F) << 6) | (text[2] & 0x3F);
+	}
+	
+	if (text[0] < 0xF8) {
+		bytes = 4;
+		return ((text[0] & 0x07) << 18) | ((text[1] & 0x3F) << 12) | ((text[2] & 0x3F) << 6) | (text[3] & 0x3F);
+	}
+	
+	if (text[0] < 0xFC) {
+		bytes = 5;
+		return ((text[0] & 0x03) << 24) | ((text[1] & 0x3F) << 18) | ((text[2] & 0x3F) << 12) | ((text[3] & 0x3F) << 6) | (text[4] & 0x3F);
+	}
+	
+	bytes = 6;
+	return ((text[0] & 0x01) << 30) | ((text[1] & 0x3F) << 24) | ((text[2] & 0x3F) << 18) | ((text[3] & 0x3F) << 12) | ((text[4] & 0x3F) << 6) | (text[5] & 0x3F);
+}
+
 Document::Document(FontBase* font, const WoopsiString& text, u16 width) {
 	_font = font;
 	_width = width;
 	_lineSpacing = 1;
+	_wrappedTextLength = 0;
+	_firstChangedLine = 0;
+	_lastChangedLine = -1;
 	_text.setText(text);
+	buildWidthTable();
 	wrap();
 }
 
@@ -16,7 +89,7 @@ FontBase* Document::getFont() const {
 }
 
 // Calculate the length of an individual line
-const u8 Document::getLineLength(const s32 lineNumber) const {
+const s32 Document::getLineLength(const s32 lineNumber) const {
 	if (lineNumber < getLineCount() - 1) {
 		return _linePositions[lineNumber + 1] - _linePositions[lineNumber];
 	}
@@ -24,32 +97,58 @@ const u8 Document::getLineLength(const s32 lineNumber) const {
 	return _text.getLength() - _linePositions[lineNumber];
 }
 
-// Calculate the length of an individual line sans right-hand spaces
-const s16 Document::getLineTrimmedLength(const s32 lineNumber) const {
-	s16 length = getLineLength(lineNumber);
-	
-	// Loop through string until the end
-	StringIterator* iterator = _text.newStringIterator();
-	
-	// Get char at the end of the line
-	if (iterator->moveTo(_linePositions[lineNumber] + length - 1)) {
-		do{
-			if (!_font->isCharBlank(iterator->getCodePoint())) break;
-			length--;
-		} while (iterator->moveToPrevious() && (length > 0));
+const s32 Document::getLineEndOffset(const s32 lineNumber) const {
+	if (lineNumber < getLineCount() - 1) {
+		return _lineOffsets[lineNumber + 1];
 	}
 	
-	delete iterator;
+	return _text.getByteCount();
+}
+
+// Calculate the length of an individual line sans right-hand spaces
+const s32 Document::getLineTrimmedLength(const s32 lineNumber) const {
+	s32 length = getLineLength(lineNumber);
+	
+	// Step backwards from the end of the line, skipping continuation bytes to
+	// find the start of each char
+	const u8* start = (const u8*)_text.getCharArray() + _lineOffsets[lineNumber];
+	const u8* end = (const u8*)_text.getCharArray() + getLineEndOffset(lineNumber);
+	const u8* current = end;
+	u8 bytes;
+	
+	while ((length > 0) && (current > start)) {
+		do {
+			current--;
+		} while ((current > start) && (*current >= 0x80) && (*current < 0xC0));
+		
+		if (!_font->isCharBlank(decodeCodePoint(current, end - current, bytes))) break;
+		length--;
+	}
 
 	return length;
 }
 
-const s16 Document::getLinePixelLength(const s32 lineNumber) const {
-	return _font->getStringWidth(_text, getLineStartIndex(lineNumber), getLineLength(lineNumber));
+const s32 Document::getLinePixelLength(const s32 lineNumber) const {
+	return getTextWidth(_lineOffsets[lineNumber], getLineLength(lineNumber));
 }
 
-const s16 Document::getLineTrimmedPixelLength(const s32 lineNumber) const {
-	return _font->getStringWidth(_text, getLineStartIndex(lineNumber), getLineTrimmedLength(lineNumber));
+const s32 Document::getLineTrimmedPixelLength(const s32 lineNumber) const {
+	return getTextWidth(_lineOffsets[lineNumber], getLineTrimmedLength(lineNumber));
+}
+
+const s32 Document::getTextWidth(s32 offset, s32 length) const {
+	const u8* text = (const u8*)_text.getCharArray();
+	s32 byteCount = _text.getByteCount();
+	s32 width = 0;
+	u8 bytes;
+	
+	while ((length > 0) && (offset < byteCount)) {
+		width += getCharWidth(decodeCodePoint(text + offset, byteCount - offset, bytes));
+		offset += bytes;
+		length--;
+	}
+	
+	return width;
 }
 
 void Document::setText(const WoopsiString& text) {
@@ -98,19 +197,44 @@ void Document::setWidth(u16 width) {
 }
 
 void Document::wrap() {
+	s32 oldLineCount = getLineCount();
+
 	wrap(0);
+
+	// The whole text may have changed, so every line needs to be reported
+	_firstChangedLine = 0;
+	_lastChangedLine = (oldLineCount > getLineCount() ? oldLineCount : getLineCount()) - 1;
 }
 
 void Document::wrap(s32 charIndex) {
 	
 	// Declare vars in advance of loop
 	s32 pos = 0;
-	s32 lineWidth;
-	s32 breakIndex;
-	bool endReached = false;
+	s32 offset = 0;
 	
 	if (_linePositions.size() == 0) charIndex = 0;
 	
+	s32 firstLine = 0;
+	
+	if (charIndex > 0) {
+		firstLine = getLineContainingCharIndex(charIndex);
+		
+		// A line's break depends on the text up to the first char of the line
+		// after next, as that is as far as the search for a breakpoint can
+		// reach.  The two lines before the changed line must therefore be
+		// re-wrapped too.
+		firstLine -= 2;
+		if (firstLine < 0) firstLine = 0;
+	}
+	
+	// Remember where the lines after the re-wrapped line started so that we
+	// can tell which lines the change has affected
+	WoopsiArray<s32> oldPositions;
+	
+	for (s32 i = firstLine + 1; i < _linePositions.size(); ++i) {
+		oldPositions.push_back(_linePositions[i]);
+	}
+	
 	// If we're wrapping from an offset in the text, ensure that any existing
 	// data after the offset gets removed
 	if (charIndex > 0) {
@@ -118,7 +242,7 @@ void Document::wrap(s32 charIndex) {
 		// Remove wrapping data past this point
 		
 		// Get the index of the line in which the char index appears
-		s32 lineIndex = getLineContainingCharIndex(charIndex);
+		s32 lineIndex = firstLine;
 		
 		// Remove any longest line records that occur from the line index
 		// onwards
@@ -138,12 +262,14 @@ void Document::wrap(s32 charIndex) {
 		// Remove any wrapping data from after this line index onwards
 		while ((_linePositions.size() > 0) && (_linePositions.size() - 1 > (s32)lineIndex)) {
 			_linePositions.pop_back();
+			_lineOffsets.pop_back();
 		}
 		
 		// Adjust start position of wrapping loop so that it starts with the
 		// current line index
 		if (_linePositions.size() > 0) {
 			pos = _linePositions[_linePositions.size() - 1];
+			offset = _lineOffsets[_lineOffsets.size() - 1];
 		}
 	} else {
 		
@@ -157,85 +283,85 @@ void Document::wrap(s32 charIndex) {
 		
 		// Empty existing line positions
 		_linePositions.clear();
+		_lineOffsets.clear();
 		
 		// Push first line start into vector
 		_linePositions.push_back(0);
+		_lineOffsets.push_back(0);
 	}
 	
-	// Loop through string until the end
-	StringIterator* iterator = _text.newStringIterator();
+	// Work through the raw UTF-8 data rather than using a StringIterator so
+	// that each char is decoded and measured exactly once; pos tracks the
+	// char index and offset tracks the matching byte offset
+	const u8* text = (const u8*)_text.getCharArray();
+	s32 length = _text.getLength();
+	s32 byteCount = _text.getByteCount();
 	
-	while (!endReached) {
-		breakIndex = 0;
-		lineWidth = 0;
+	while ((pos < length) && (offset < byteCount)) {
+		s32 index = pos;
+		s32 lineWidth = 0;
+		s32 nextPos = -1;
+		s32 nextOffset = 0;
+		u8 bytes = 0;
+		bool endReached = false;
 		
-		if (iterator->moveTo(pos)) {
+		// Search for line breaks and valid breakpoints until we exceed the
+		// width of the text field or we run out of string to process
+		while (true) {
+			u32 codePoint = decodeCodePoint(text + offset, byteCount - offset, bytes);
+			u8 charWidth = getCharWidth(codePoint);
+			
+			if (lineWidth + charWidth > _width) break;
+			
+			lineWidth += charWidth;
+			
+			u8 breakClass = codePoint < 128 ? BREAK_CLASSES[codePoint] : (u8)BREAK_CLASS_NONE;
 			
-			// Search for line breaks and valid breakpoints until we exceed the
-			// width of the text field or we run out of string to process
-			while (lineWidth + _font->getCharWidth(iterator->getCodePoint()) <= _width) {
-				lineWidth += _font->getCharWidth(iterator->getCodePoint());
+			if (breakClass != BREAK_CLASS_NONE) {
+				
+				// Remember the most recent breakpoint
+				nextPos = index + 1;
+				nextOffset = offset + bytes;
 				
 				// Check for line return
-				if (iterator->getCodePoint() == '\n') {
-					
-					// Remember this breakpoint
-					breakIndex = iterator->getIndex();
-					break;
-				} else if ((iterator->getCodePoint() == ' ') ||
-						   (iterator->getCodePoint() == ',') ||
-						   (iterator->getCodePoint() == '.') ||
-						   (iterator->getCodePoint() == '-') ||
-						   (iterator->getCodePoint() == ':') ||
-						   (iterator->getCodePoint() == ';') ||
-						   (iterator->getCodePoint() == '?') ||
-						   (iterator->getCodePoint() == '!') ||
-						   (iterator->getCodePoint() == '+') ||
-						   (iterator->getCodePoint() == '=') ||
-						   (iterator->getCodePoint() == '/') ||
-						   (iterator->getCodePoint() == '\0')) {
-					
-					// Remember the most recent breakpoint
-					breakIndex = iterator->getIndex();
-				}
+				if (breakClass == BREAK_CLASS_NEWLINE) break;
+			}
+			
+			if ((index == length - 1) || (offset + bytes >= byteCount)) {
 				
-				// Move to the next character
-				if (!iterator->moveToNext()) {
-					
-					// No more text; abort loop
-					endReached = true;
-					break;
-				}
+				// No more text; abort loop
+				endReached = true;
+				break;
 			}
-		} else {
-			endReached = true;
+			
+			// Move to the next character
+			index++;
+			offset += bytes;
 		}
 		
-		if ((!endReached) && (iterator->getIndex() > pos)) {
+		if (endReached) break;
+		
+		if (index > pos) {
 			
 			// Process any found data
 			
 			// If we didn't find a breakpoint split at the current position
-			if (breakIndex == 0) breakIndex = iterator->getIndex() - 1;
+			if (nextPos == -1) {
+				nextPos = index;
+				nextOffset = offset;
+			}
 			
 			// Trim blank space from the start of the next line
-			StringIterator* breakIterator = _text.newStringIterator();
-			
-			if (breakIterator->moveTo(breakIndex + 1)) {
-				while (breakIterator->getCodePoint() == ' ') {
-					if (breakIterator->moveToNext()) {
-						breakIndex++;
-					} else {
-						break;
-					}
-				}
+			while ((nextPos < length - 1) && (nextOffset < byteCount - 1) && (text[nextOffset] == ' ')) {
+				nextPos++;
+				nextOffset++;
 			}
 			
-			delete breakIterator;
-			
 			// Add the start of the next line to the vector
-			pos = breakIndex + 1;
+			pos = nextPos;
+			offset = nextOffset;
 			_linePositions.push_back(pos);
+			_lineOffsets.push_back(offset);
 			
 			// Is this the longest line observed so far?
 			if (lineWidth > _textPixelWidth) {
@@ -250,11 +376,13 @@ void Document::wrap(s32 charIndex) {
 				line.width = lineWidth;
 				_longestLines.push_back(line);
 			}
-		} else if (!endReached) {
+		} else {
 			
 			// Add a blank row if we're not at the end of the string
 			pos++;
+			offset += bytes;
 			_linePositions.push_back(pos);
+			_lineOffsets.push_back(offset);
 		}
 	}
 	
@@ -262,25 +390,68 @@ void Document::wrap(s32 charIndex) {
 	// If we reached the end of the text, append the stopping point
 	if (_linePositions[_linePositions.size() - 1] != _text.getLength() + 1) {
 		_linePositions.push_back(_text.getLength());
+		_lineOffsets.push_back(_text.getByteCount());
 	}
 	
-	delete iterator;
-	
 	// Calculate the total height of the text
 	_textPixelHeight = getLineCount() * (_font->getHeight() + _lineSpacing);
 	
 	// Ensure height is always at least one row
 	if (_textPixelHeight == 0) _textPixelHeight = _font->getHeight() + _lineSpacing;
+	
+	// Lines are wrapped using only the text that follows their start, so
+	// once a line beyond the change starts where it did before (allowing for
+	// the change in length), it and every following line are unchanged
+	s32 delta = _text.getLength() - _wrappedTextLength;
+	s32 changeEnd = delta > 0 ? charIndex + delta : charIndex;
+	s32 oldLineCount = firstLine + oldPositions.size();
+	
+	_wrappedTextLength = _text.getLength();
+	_firstChangedLine = firstLine;
+	_lastChangedLine = (oldLineCount > getLineCount() ? oldLineCount : getLineCount()) - 1;
+	
+	// Lines that end where they did before and before the change are
+	// unchanged
+	for (s32 i = 0; (i < oldPositions.size()) && (firstLine + 1 + i < _linePositions.size()); ++i) {
+		s32 position = _linePositions[firstLine + 1 + i];
+		
+		if ((position > charIndex) || (position != oldPositions[i])) break;
+		
+		_firstChangedLine = firstLine + 1 + i;
+	}
+	
+	for (s32 i = 0; (i < oldPositions.size()) && (firstLine + 1 + i < _linePositions.size()); ++i) {
+		s32 position = _linePositions[firstLine + 1 + i];
+		
+		// The last position marks the end of the text rather than the start
+		// of a line, so it can only match the old end of the text
+		bool isEnd = firstLine + 1 + i == _linePositions.size() - 1;
+		bool wasEnd = i == oldPositions.size() - 1;
+		
+		if (isEnd != wasEnd) continue;
+		
+		if ((position >= changeEnd) && (position - delta == oldPositions[i])) {
+			_lastChangedLine = firstLine + i;
+			break;
+		}
+	}
 }
 
 void Document::setFont(FontBase* font) {
 	_font = font;
+	buildWidthTable();
 	wrap();
 }
 
+void Document::buildWidthTable() {
+	for (s32 i = 0; i < DOCUMENT_WIDTH_TABLE_SIZE; ++i) {
+		_charWidths[i] = _font->getCharWidth(i);
+	}
+}
+
 void Document::stripTopLines(const s32 lines) {
 	// Get the start point of the text we want to keep
-	u16 textStart = 0;
+	s32 textStart = 0;
 	
 	for (s32 i = 0; i < lines; i++) {
 		textStart += getLineLength(i);
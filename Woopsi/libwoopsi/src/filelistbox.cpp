@@ -3,13 +3,9 @@
 #include "button.h"
 #include "filepath.h"
 #include "graphicsport.h"
-
-#ifndef USING_SDL
-
-#include <fcntl.h>
-#include <dirent.h>
-
-#endif
+#include "animator.h"
+#include "directorycache.h"
+#include "woopsi.h"
 
 using namespace WoopsiUI;
 
@@ -28,6 +24,8 @@ FileListBox::FileListBox(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style
 }
 
 FileListBox::~FileListBox() {
+	stopReading();
+
 	if (_path) delete _path;
 }
 
@@ -81,100 +79,91 @@ void FileListBox::handleDoubleClickEvent(Gadget& source, const WoopsiPoint& poin
 
 void FileListBox::readDirectory() {
 
+	// Stop reading the previous directory
+	stopReading();
+
 	// Clear current options
 	_listbox->removeAllOptions();
 
-#ifdef USING_SDL
+	DirectoryCache* cache = woopsiApplication != NULL ? woopsiApplication->getDirectoryCache() : NULL;
 
-	// Build file list using SDL
-	// We build a dummy list.  Most OSes use different
-	// methods for accessing the file system.  We could
-	// target POSIX, but then we cut out Windows; or we
-	// could target Windows and POSIX, but then we cut
-	// out any number of other OSes.  Simplest solution
-	// is just to present a list of imaginary files.
+	// Use the cached listing if the directory has not changed since it was
+	// last read
+	if (cache != NULL) {
+		const WoopsiArray<DirectoryReader::Entry>* listing = cache->getListing(_path->getPath());
 
-	// Which path are we building?
-	if (_path->getPath().compareTo("/") == 0) {
-
-		// Root path
+		if (listing != NULL) {
+			addEntries(*listing, 0);
+			return;
+		}
 
-		// Directories
-		_listbox->addOption(new FileListBoxDataItem("Directory1", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
-		_listbox->addOption(new FileListBoxDataItem("Directory2", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
-		_listbox->addOption(new FileListBoxDataItem("Directory3", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
-		_listbox->addOption(new FileListBoxDataItem("Directory4", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
+		cache->beginListing(_path->getPath());
+	}
 
-		// Files
-		_listbox->addOption(new FileListBoxDataItem("File1", 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
-		_listbox->addOption(new FileListBoxDataItem("File2", 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
-		_listbox->addOption(new FileListBoxDataItem("File3", 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
-		_listbox->addOption(new FileListBoxDataItem("File4", 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
-	} else if (_path->getPath().compareTo("/Directory1/") == 0) {
+	// Entries are streamed into the list by animate() as they are read, so
+	// the list appears immediately even for very large directories
+	_entries.clear();
+	_reader.open(_path->getPath());
+	startReading();
+}
 
-		// Directory 1
+bool FileListBox::animate() {
+	DirectoryCache* cache = woopsiApplication != NULL ? woopsiApplication->getDirectoryCache() : NULL;
+	bool isCaching = (cache != NULL) && (cache->isEnabled());
 
-		// Directories
-		_listbox->addOption(new FileListBoxDataItem("..", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
-		_listbox->addOption(new FileListBoxDataItem("Subdir1", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
-		_listbox->addOption(new FileListBoxDataItem("Subdir2", 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
+	// Only keep the entries that have already been added if the complete
+	// listing will be cached; otherwise they would be held twice
+	if (!isCaching) _entries.clear();
 
-		// Files
-		_listbox->addOption(new FileListBoxDataItem("Subfile1", 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
-	}
+	s32 first = _entries.size();
 
-#else
+	if (_reader.read(_entries) > 0) addEntries(_entries, first);
 
-	// Build file list using libfat
-	struct stat st;
+	if (!_reader.isComplete()) return true;
 
-	// Get a copy of the path char array so that it can be used with libfat
-	char* path = new char[_path->getPath().getByteCount() + 1];
-	_path->getPath().copyToCharArray(path);
+	// Remember the complete listing so that it can be reused
+	if (isCaching) {
+		cache->storeListing(_path->getPath(), _entries);
+	}
 
-	DIR* dir = opendir(path);
+	_entries.clear();
 
-	delete [] path;
+	return false;
+}
 
-	// Did we get the dir successfully?
-	if (dir == NULL) return;
-	
-	// Read data into options list
-	struct dirent* ent;
+void FileListBox::addEntries(const WoopsiArray<DirectoryReader::Entry>& entries, const s32 first) {
 
-	while ((ent = readdir(dir)) != 0) {
-		
-		// Bypass "." directory
-		if (strcmp(ent->d_name, ".") == 0) continue;
-
-		char* newPath = new char[strlen(ent->d_name) + _path->getPath().getByteCount() + 2];
-		_path->getPath().copyToCharArray(newPath);
-		strcat(newPath, "/");
-		strcat(newPath, ent->d_name);
-		int result = stat(newPath, &st);
-		delete [] newPath;
-		if (result) {
-			continue;
-		}
+	// Add the entries as a single update so that the list is only sorted and
+	// redrawn once
+	_listbox->beginUpdate();
 
-		// st.st_mode & S_IFDIR indicates a directory
-		if (st.st_mode & S_IFDIR) {
+	for (s32 i = first; i < entries.size(); ++i) {
+		if (entries[i].isDirectory) {
 
 			// Directory
-			_listbox->addOption(new FileListBoxDataItem(ent->d_name, 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
+			_listbox->addOption(new FileListBoxDataItem(entries[i].name, 0, getShineColour(), getBackColour(), getShineColour(), getHighlightColour(), true));
 		} else {
 
 			// File
-			_listbox->addOption(new FileListBoxDataItem(ent->d_name, 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
+			_listbox->addOption(new FileListBoxDataItem(entries[i].name, 0, getShadowColour(), getBackColour(), getShadowColour(), getHighlightColour(), false));
 		}
 	}
 
-	// Close the directory
-	closedir(dir);
+	_listbox->endUpdate();
+}
+
+void FileListBox::startReading() {
+	if (woopsiApplication == NULL) return;
+
+	woopsiApplication->getAnimator()->add(this);
+}
+
+void FileListBox::stopReading() {
+	_reader.close();
+
+	if (woopsiApplication == NULL) return;
 
-#endif
-	
-	markRectsDamaged();
+	woopsiApplication->getAnimator()->remove(this);
 }
 
 void FileListBox::setPath(const WoopsiString& path) {
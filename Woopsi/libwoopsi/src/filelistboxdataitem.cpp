@@ -2,7 +2,7 @@
 
 using namespace WoopsiUI;
 
-FileListBoxDataItem::FileListBoxDataItem(const char* text, const u32 value,
+FileListBoxDataItem::FileListBoxDataItem(const WoopsiString& text, const u32 value,
 		const u16 normalTextColour,
 		const u16 normalBackColour,
 		const u16 selectedTextColour,
@@ -16,6 +16,9 @@ FileListBoxDataItem::FileListBoxDataItem(const char* text, const u32 value,
 						   selectedBackColour) {
 
 	_isDirectory = isDirectory;
+
+	// compareTo() falls back to the text comparison, so the text key applies
+	setTextSortKeyEnabled(true);
 }
 
 s8 FileListBoxDataItem::compareTo(const ListDataItem* item) const {
@@ -30,3 +33,10 @@ s8 FileListBoxDataItem::compareTo(const ListDataItem* item) const {
 	// Fall back to standard comparison if both items are of the same type
 	return ListBoxDataItem::compareTo(item);
 }
+
+u32 FileListBoxDataItem::getSortKey() const {
+
+	// Dropping the lowest bit of the text key keeps its ordering intact; keys
+	// that become equal are resolved by compareTo()
+	return (_isDirectory ? 0 : 0x80000000) | (ListBoxDataItem::getSortKey() >> 1);
+}
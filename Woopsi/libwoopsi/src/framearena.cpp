@@ -0,0 +1,103 @@
+#include "framearena.h"
+
+using namespace WoopsiUI;
+
+FrameArena::FrameArena(u32 blockSize) {
+	_head = newBlock(blockSize);
+	_current = _head;
+	_usedSize = 0;
+}
+
+FrameArena::~FrameArena() {
+	deleteBlocks(_head);
+}
+
+void* FrameArena::allocate(u32 size) {
+
+	// Keep all allocations 8-byte aligned
+	size = (size + 7) & ~7;
+
+	// Move to the next block if the current one cannot satisfy the request
+	while (_current->offset + size > _current->size) {
+		if (_current->next == NULL) {
+			_current->next = newBlock(size > _head->size ? size : _head->size);
+		}
+
+		_current = _current->next;
+	}
+
+	void* data = _current->data + _current->offset;
+
+	_current->offset += size;
+	_usedSize += size;
+
+	return data;
+}
+
+void FrameArena::reset() {
+
+	// If the last frame overflowed the first block, replace the chain with a
+	// single block large enough to hold everything it needed
+	if (_head->next != NULL) {
+		u32 capacity = getCapacity();
+
+		deleteBlocks(_head);
+		_head = newBlock(capacity);
+	}
+
+	_head->offset = 0;
+	_current = _head;
+	_usedSize = 0;
+}
+
+FrameArena::Marker FrameArena::getMarker() const {
+	Marker marker;
+	marker.block = _current;
+	marker.offset = _current->offset;
+	marker.usedSize = _usedSize;
+
+	return marker;
+}
+
+void FrameArena::rewind(const Marker& marker) {
+
+	// Reset any blocks moved into since the marker was taken
+	for (Block* block = ((Block*)marker.block)->next; block != NULL; block = block->next) {
+		block->offset = 0;
+	}
+
+	_current = (Block*)marker.block;
+	_current->offset = marker.offset;
+	_usedSize = marker.usedSize;
+}
+
+const u32 FrameArena::getCapacity() const {
+	u32 capacity = 0;
+
+	for (Block* block = _head; block != NULL; block = block->next) {
+		capacity += block->size;
+	}
+
+	return capacity;
+}
+
+FrameArena::Block* FrameArena::newBlock(u32 size) {
+	Block* block = new Block;
+	block->next = NULL;
+	block->data = new u8[size];
+	block->size = size;
+	block->offset = 0;
+
+	return block;
+}
+
+void FrameArena::deleteBlocks(Block* block) {
+	while (block != NULL) {
+		Block* next = block->next;
+
+		delete [] block->data;
+		delete block;
+
+		block = next;
+	}
+}
@@ -8,6 +8,145 @@ FrameBuffer::FrameBuffer(u16* data, u16 width, u16 height) {
 	_width = width;
 	_height = height;
 	_bitmap = data;
+	_dirtyLeft = NULL;
+	_dirtyRight = NULL;
+	_dirtyTop = 0;
+	_dirtyBottom = 0;
+}
+
+FrameBuffer::~FrameBuffer() {
+	delete [] _dirtyLeft;
+	delete [] _dirtyRight;
+}
+
+void FrameBuffer::setDirtyTrackingEnabled(bool isEnabled) {
+	if (isEnabled == (_dirtyLeft != NULL)) return;
+
+	if (isEnabled) {
+		_dirtyLeft = new s16[_height];
+		_dirtyRight = new s16[_height];
+		markAllDirty();
+	} else {
+		delete [] _dirtyLeft;
+		delete [] _dirtyRight;
+		_dirtyLeft = NULL;
+		_dirtyRight = NULL;
+		_dirtyTop = 0;
+		_dirtyBottom = 0;
+	}
+}
+
+void FrameBuffer::clearDirty() {
+	_dirtyTop = 0;
+	_dirtyBottom = 0;
+}
+
+void FrameBuffer::markAllDirty() {
+	if (_dirtyLeft == NULL) return;
+
+	for (s16 i = 0; i < _height; ++i) {
+		_dirtyLeft[i] = 0;
+		_dirtyRight[i] = _width;
+	}
+
+	_dirtyTop = 0;
+	_dirtyBottom = _height;
+}
+
+void FrameBuffer::markRowDirty(s16 y, s16 x1, s16 x2) {
+	if ((y < 0) || (y >= _height)) return;
+
+	if (x1 < 0) x1 = 0;
+	if (x2 > _width) x2 = _width;
+	if (x1 >= x2) return;
+
+	// Rows outside the current dirty range contain stale spans, so they are
+	// reset rather than extended
+	bool isRowDirty = (y >= _dirtyTop) && (y < _dirtyBottom) && (_dirtyLeft[y] < _dirtyRight[y]);
+
+	if (!isRowDirty) {
+		_dirtyLeft[y] = x1;
+		_dirtyRight[y] = x2;
+	} else {
+		if (x1 < _dirtyLeft[y]) _dirtyLeft[y] = x1;
+		if (x2 > _dirtyRight[y]) _dirtyRight[y] = x2;
+	}
+
+	// Extend the dirty row range, marking any rows that it swallows as clean
+	if (_dirtyTop >= _dirtyBottom) {
+		_dirtyTop = y;
+		_dirtyBottom = y + 1;
+	} else if (y < _dirtyTop) {
+		for (s16 i = y + 1; i < _dirtyTop; ++i) {
+			_dirtyLeft[i] = 0;
+			_dirtyRight[i] = 0;
+		}
+
+		_dirtyTop = y;
+	} else if (y >= _dirtyBottom) {
+		for (s16 i = _dirtyBottom; i < y; ++i) {
+			_dirtyLeft[i] = 0;
+			_dirtyRight[i] = 0;
+		}
+
+		_dirtyBottom = y + 1;
+	}
+}
+
+void FrameBuffer::markDirty(s16 x, s16 y, u32 size) {
+	if (_dirtyLeft == NULL) return;
+	if (size == 0) return;
+
+	s32 end = x + size;
+
+	if (end <= _width) {
+		markRowDirty(y, x, end);
+		return;
+	}
+
+	// The write wraps onto subsequent rows
+	markRowDirty(y, x, _width);
+
+	s32 lastRow = y + ((end - 1) / _width);
+
+	for (s32 row = y + 1; row <= lastRow; ++row) {
+		markRowDirty(row, 0, _width);
+	}
+}
+
+void FrameBuffer::getDirtyRects(WoopsiArray<Rect>& rects) const {
+
+	Rect rect;
+	bool hasRect = false;
+
+	for (s16 y = _dirtyTop; y < _dirtyBottom; ++y) {
+
+		// Clean rows end the current rect
+		if (_dirtyLeft[y] >= _dirtyRight[y]) {
+			if (hasRect) rects.push_back(rect);
+			hasRect = false;
+			continue;
+		}
+
+		if (!hasRect) {
+			rect.x = _dirtyLeft[y];
+			rect.y = y;
+			rect.width = _dirtyRight[y] - _dirtyLeft[y];
+			rect.height = 1;
+			hasRect = true;
+			continue;
+		}
+
+		// Merge the row into the current rect
+		s16 x1 = _dirtyLeft[y] < rect.x ? _dirtyLeft[y] : rect.x;
+		s16 x2 = _dirtyRight[y] > rect.x + rect.width ? _dirtyRight[y] : rect.x + rect.width;
+
+		rect.x = x1;
+		rect.width = x2 - x1;
+		rect.height++;
+	}
+
+	if (hasRect) rects.push_back(rect);
 }
 
 // Get a single pixel from the bitmap
@@ -32,6 +171,8 @@ void FrameBuffer::setPixel(s16 x, s16 y, u16 colour) {
 	// Plot the pixel
 	u32 pos = (y * _width) + x;
 	_bitmap[pos] = colour;
+
+	markDirty(x, y, 1);
 }
 
 const u16* FrameBuffer::getData(s16 x, s16 y) const {
@@ -48,11 +189,15 @@ const u16* FrameBuffer::getData(s16 x, s16 y) const {
 void FrameBuffer::blit(const s16 x, const s16 y, const u16* data, const u32 size) {
 	u16* pos = _bitmap + (y * _width) + x;
 	woopsiDmaCopy(data, pos, size);
+
+	markDirty(x, y, size);
 }
 
 void FrameBuffer::blitFill(const s16 x, const s16 y, const u16 colour, const u32 size) {
 	u16* pos = _bitmap + (y * _width) + x;
 	woopsiDmaFill(colour, pos, size);
+
+	markDirty(x, y, size);
 }
 
 void FrameBuffer::copy(s16 x, s16 y, u32 size, u16* dest) const {
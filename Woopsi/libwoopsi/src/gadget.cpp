@@ -1,18 +1,26 @@
+#include "backingstore.h"
 #include "contextmenu.h"
 #include "gadgetstyle.h"
 #include "gadget.h"
 #include "gadgeteventhandler.h"
 #include "graphicsport.h"
 #include "fontbase.h"
+#include "framearena.h"
 #include "framebuffer.h"
 #include "listdataitem.h"
 #include "rectcache.h"
+#include "spatialgrid.h"
 #include "woopsi.h"
 #include "woopsifuncs.h"
 #include "woopsipoint.h"
 
 using namespace WoopsiUI;
 
+u32 Gadget::_stateGeneration = 1;
+FrameBuffer* Gadget::_renderTarget = NULL;
+s16 Gadget::_renderTargetX = 0;
+s16 Gadget::_renderTargetY = 0;
+
 Gadget::Gadget(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style) {
 
 	// Set properties from parameters
@@ -73,6 +81,7 @@ Gadget::Gadget(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style) {
 	_flags.permeable = false;
 	_flags.shelved = false;
 	_flags.raisesEvents = true;
+	_flags.opaque = true;
 
 	// Set hierarchy pointers
 	_parent = NULL;
@@ -95,6 +104,14 @@ Gadget::Gadget(s16 x, s16 y, u16 width, u16 height, GadgetStyle* style) {
 	_borderSize.left = 1;
 
 	_rectCache = new RectCache(this);
+	_spatialGrid = NULL;
+	_layer = NULL;
+	_layerAlpha = 255;
+
+	// Force cached hierarchy state to be calculated on first use
+	_cachedStateGeneration = 0;
+	_cachedX = 0;
+	_cachedY = 0;
 
 	_gadgetEventHandler = NULL;
 }
@@ -106,6 +123,7 @@ Gadget::~Gadget() {
 	if (!_flags.deleted) {
 
 		_flags.deleted = true;
+		invalidateCachedState();
 
 		if (woopsiApplication != NULL) {
 
@@ -136,22 +154,36 @@ Gadget::~Gadget() {
 	}
 
 	delete _rectCache;
+	delete _spatialGrid;
+	delete _layer;
+}
+
+void* Gadget::operator new(size_t size) {
+	return getAllocator().allocate(size);
+}
+
+void Gadget::operator delete(void* data, size_t size) {
+	getAllocator().release(data, size);
+}
+
+SlabAllocator& Gadget::getAllocator() {
+
+	// Created on first use so that gadgets can safely be constructed during
+	// static initialisation
+	static SlabAllocator allocator(GADGET_SLAB_GRANULARITY, GADGET_SLAB_MAX_OBJECT_SIZE);
+	return allocator;
 }
 
 const s16 Gadget::getX() const {
-	if (_parent != NULL) {
-		return _parent->getX() + _rect.getX();
-	}
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
 
-	return _rect.getX();
+	return _cachedX;
 }
 
 const s16 Gadget::getY() const {
-	if (_parent != NULL) {
-		return _parent->getY() + _rect.getY();
-	}
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
 
-	return _rect.getY();
+	return _cachedY;
 }
 
 const s16 Gadget::getRelativeX() const {
@@ -163,56 +195,69 @@ const s16 Gadget::getRelativeY() const {
 }
 
 const bool Gadget::isDeleted() const {
-	if (_parent != NULL) {
-		if (_parent->isDeleted()) {
-			return true;
-		}
-	}
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
 
-	return _flags.deleted;
+	return _cachedState.deleted;
 }
 
 const bool Gadget::isDrawingEnabled() const {
-	if (_parent != NULL) {
-		if (_parent->isDrawingEnabled()) {
-
-			// Drawing is enabled if the gadget is drawable, not deleted, and
-			// not shelved
-			return ((!_flags.deleted) && (!_flags.shelved) && (!_flags.hidden));
-		}
-	} else {
-		return ((!_flags.deleted) && (!_flags.shelved) && (!_flags.hidden));
-	}
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
 
-	return false;
+	return _cachedState.drawingEnabled;
 }
 
 const bool Gadget::isHidden() const {
-	if (_parent != NULL) {
-		if (!_parent->isHidden()) {
-
-			// Hidden if the gadget is deleted, shelved or hidden
-			return (_flags.deleted || _flags.shelved || _flags.hidden);
-		}
-	} else {
-		return (_flags.deleted || _flags.shelved || _flags.hidden);
-	}
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
 
-	return true;
+	return _cachedState.hidden;
 }
 
 const bool Gadget::isEnabled() const {
+	if (_cachedStateGeneration != _stateGeneration) updateCachedState();
+
+	return _cachedState.enabled;
+}
+
+void Gadget::updateCachedState() const {
+
+	// The gadget is visible if it is not deleted, shelved or hidden
+	bool isShown = (!_flags.deleted) && (!_flags.shelved) && (!_flags.hidden);
+
 	if (_parent != NULL) {
-		if (_parent->isEnabled()) {
-			// Enabled if the gadget is enabled, not deleted, not shelved and
-			// not hidden
-			return (_flags.enabled && (!_flags.deleted) && (!_flags.shelved) && (!_flags.hidden));
-		}
+
+		// The parent's values are themselves cached, so each ancestor is only
+		// recalculated once per generation
+		_cachedX = _parent->getX() + _rect.getX();
+		_cachedY = _parent->getY() + _rect.getY();
+
+		_cachedState.deleted = _parent->isDeleted() || _flags.deleted;
+		_cachedState.drawingEnabled = _parent->isDrawingEnabled() && isShown;
+		_cachedState.hidden = _parent->isHidden() || (!isShown);
+		_cachedState.enabled = _parent->isEnabled() && _flags.enabled && isShown;
 	} else {
-		return (_flags.enabled && (!_flags.deleted) && (!_flags.shelved) && (!_flags.hidden));
+		_cachedX = _rect.getX();
+		_cachedY = _rect.getY();
+
+		_cachedState.deleted = _flags.deleted;
+		_cachedState.drawingEnabled = isShown;
+		_cachedState.hidden = !isShown;
+		_cachedState.enabled = _flags.enabled && isShown;
 	}
 
-	return false;
+	_cachedStateGeneration = _stateGeneration;
+}
+
+void Gadget::invalidateCachedState() {
+	_stateGeneration++;
+
+	// Zero is reserved for gadgets that have never been cached
+	if (_stateGeneration == 0) _stateGeneration = 1;
+}
+
+void Gadget::setParent(Gadget* parent) {
+	_parent = parent;
+
+	invalidateCachedState();
 }
 
 const bool Gadget::isModal() const {
@@ -243,6 +288,22 @@ void Gadget::setBorderless(bool isBorderless) {
 	invalidateVisibleRectCache();
 }
 
+void Gadget::setOpaque(const bool isOpaque) {
+	if (_flags.opaque == isOpaque) return;
+
+	bool wasOpaque = this->isOpaque();
+
+	_flags.opaque = isOpaque;
+
+	// Gadgets below this one can now see through it, or can no longer see
+	// through it
+	if ((this->isOpaque() != wasOpaque) && (_parent != NULL)) {
+		_parent->invalidateLowerGadgetsVisibleRectCache(this);
+	}
+
+	markRectsDamaged();
+}
+
 void Gadget::setDecoration(bool isDecoration) {
 	if (_flags.decoration == isDecoration) return;
 
@@ -329,15 +390,7 @@ bool Gadget::checkCollisionWithForegroundRects(s16 x, s16 y) const {
 
 	cacheVisibleRects();
 
-	Rect* rect;
-
-	for (s32 i = 0; i < _rectCache->getForegroundRegions()->size(); ++i) {
-		rect = &(_rectCache->getForegroundRegions()->at(i));
-
-		if (rect->contains(x, y)) return true;
-	}
-
-	return false;
+	return _rectCache->getForegroundRegion()->contains(x, y);
 }
 
 // Check for collisions with another rectangle
@@ -370,20 +423,32 @@ bool Gadget::checkCollision(const Gadget* gadget) const {
 
 void Gadget::redraw(const Rect& rect) {
 
+	// The ports only live until the end of this method, so allocate them from
+	// the frame arena instead of the heap and rewind the arena once they have
+	// been destroyed
+	FrameArena* arena = woopsiApplication->getFrameArena();
+	FrameArena::Marker marker = arena->getMarker();
+
 	// Create internal and standard graphics ports
-	GraphicsPort* internalPort = newInternalGraphicsPort(rect);
-	GraphicsPort* port = newGraphicsPort(rect);
+	GraphicsPort* internalPort = newInternalGraphicsPort(rect, arena);
+	GraphicsPort* port = newGraphicsPort(rect, arena);
 
 	drawBorder(internalPort);
 	drawContents(port);
 
-	delete internalPort;
-	delete port;
+	internalPort->~GraphicsPort();
+	port->~GraphicsPort();
+
+	arena->rewind(marker);
 }
 
 void Gadget::markRectsDamaged() {
 	cacheVisibleRects();
 	_rectCache->markRectsDamaged();
+
+	Rect rect;
+	getRectClippedToHierarchy(rect);
+	markLayersDamaged(rect);
 }
 
 void Gadget::markRectDamaged(const Rect& rect) {
@@ -399,7 +464,56 @@ void Gadget::markRectDamaged(const Rect& rect) {
 	// clip the rect to the visible portions of the gadget so we
 	// don't need to
 	_rectCache->markRectDamaged(adjustedRect);
-}	
+
+	Rect rectClippedToHierarchy;
+	getRectClippedToHierarchy(rectClippedToHierarchy);
+
+	if (rectClippedToHierarchy.intersects(adjustedRect)) {
+		rectClippedToHierarchy.getIntersect(adjustedRect, adjustedRect);
+		markLayersDamaged(adjustedRect);
+	}
+}
+
+void Gadget::markLayersDamaged(const Rect& rect) const {
+
+	// Parts of layers hidden behind other gadgets still need re-rendering,
+	// so we mark the whole rect rather than just the visible region
+	if (!rect.hasDimensions()) return;
+
+	Region region(rect);
+
+	for (const Gadget* gadget = this; gadget != NULL; gadget = gadget->_parent) {
+		if (gadget->_layer != NULL) gadget->_layer->markDamaged(region);
+	}
+}
+
+void Gadget::setLayerEnabled(bool isEnabled) {
+	if (isEnabled == isLayer()) return;
+
+	if (isEnabled) {
+		_layer = new BackingStore(this, false);
+	} else {
+		delete _layer;
+		_layer = NULL;
+	}
+
+	markRectsDamaged();
+}
+
+void Gadget::setLayerAlpha(u8 alpha) {
+	if (alpha == _layerAlpha) return;
+
+	bool wasOpaque = isOpaque();
+
+	_layerAlpha = alpha;
+
+	// Translucent layers cannot hide the gadgets below them
+	if ((isOpaque() != wasOpaque) && (_parent != NULL)) {
+		_parent->invalidateLowerGadgetsVisibleRectCache(this);
+	}
+
+	markRectsDamaged();
+}
 
 // Marks the gadget as deleted and adds it to the deletion queue
 void Gadget::close() {
@@ -417,6 +531,7 @@ void Gadget::close() {
 	markRectsDamaged();
 
 	_flags.deleted = true;
+	invalidateCachedState();
 	
 	// Unset clicked gadget if necessary
 	Gadget* clickedGadget = woopsiApplication->getClickedGadget();
@@ -448,6 +563,7 @@ bool Gadget::shelve() {
 	markRectsDamaged();
 
 	_flags.shelved = true;
+	invalidateCachedState();
 
 	// Unset clicked gadget if necessary
 	Gadget* clickedGadget = woopsiApplication->getClickedGadget();
@@ -476,6 +592,7 @@ bool Gadget::unshelve() {
 	}
 
 	_flags.shelved = false;
+	invalidateCachedState();
 
 	if (_parent != NULL) {
 		_parent->moveShelvedToGadgetList(this);
@@ -500,6 +617,7 @@ void Gadget::moveGadgetToDeleteQueue(Gadget* gadget) {
 
 			// Remove gadget from main vector
 			_gadgets.erase(i);
+			invalidateSpatialIndex();
 
 			break;
 		}
@@ -518,6 +636,7 @@ bool Gadget::moveGadgetToShelvedList(Gadget* gadget) {
 
 			// Remove gadget from main vector
 			_gadgets.erase(i);
+			invalidateSpatialIndex();
 
 			return true;
 		}
@@ -548,6 +667,8 @@ bool Gadget::moveShelvedToGadgetList(Gadget* gadget) {
 			// Remove gadget from shelved vector
 			_shelvedGadgets.erase(i);
 
+			invalidateSpatialIndex();
+
 			return true;
 		}
 	}
@@ -692,11 +813,16 @@ bool Gadget::changeGadgetDepth(s32 sourceIndex, s32 destinationIndex) {
 
 	_gadgets.erase(sourceIndex);
 	_gadgets.insert(destinationIndex, gadget);
+	invalidateSpatialIndex();
+
+	// Invalidate rect cache of all parts of other gadgets that collide with
+	// the swapped gadget
+	Rect gadgetRect;
+	gadget->getRectClippedToHierarchy(gadgetRect);
 
-	// Invalidate rect cache of all gadgets that collide with the swapped gadget
 	for (s32 i = 0; i < _gadgets.size(); ++i) {
-		if (_gadgets[i]->checkCollision(gadget)) {
-			_gadgets[i]->invalidateVisibleRectCache();
+		if (_gadgets[i] != gadget) {
+			_gadgets[i]->invalidateVisibleRectCache(gadgetRect);
 		}
 	}
 
@@ -743,6 +869,7 @@ bool Gadget::enable() {
 	if (_flags.enabled) return false;
 
 	_flags.enabled = true;
+	invalidateCachedState();
 	
 	onEnable();
 
@@ -761,6 +888,7 @@ bool Gadget::disable() {
 	if (!_flags.enabled) return false;
 
 	_flags.enabled = false;
+	invalidateCachedState();
 	
 	onDisable();
 
@@ -826,13 +954,28 @@ bool Gadget::moveTo(s16 x, s16 y) {
 		s16 oldX = _rect.getX();
 		s16 oldY = _rect.getY();
 
+		Rect oldRect;
+		getRectClippedToHierarchy(oldRect);
+
 		_rect.setX(x);
 		_rect.setY(y);
 
+		invalidateCachedState();
+
+		// Only the gadgets below this one that overlap its old or new
+		// positions can have had their visible regions changed
 		if (_parent != NULL) {
-			_parent->invalidateVisibleRectCache();
+			Rect newRect;
+			getRectClippedToHierarchy(newRect);
+
+			_parent->invalidateSpatialIndex();
+			_parent->getRectCache()->invalidateBackground();
+			_parent->invalidateLowerGadgetsVisibleRectCache(this, oldRect);
+			_parent->invalidateLowerGadgetsVisibleRectCache(this, newRect);
 		}
 
+		invalidateVisibleRectCache();
+
 		markRectsDamaged();
 
 		if (raisesEvents()) {
@@ -875,14 +1018,26 @@ bool Gadget::resize(u16 width, u16 height) {
 	
 		markRectsDamaged();
 
+		Rect oldRect;
+		getRectClippedToHierarchy(oldRect);
+
 		_rect.setWidth(width);
 		_rect.setHeight(height);
 
-		// Handle visible region caching
+		// Handle visible region caching.  Only the gadgets below this one
+		// that overlap its old or new dimensions are affected.
 		if (_parent != NULL) {
-			_parent->invalidateVisibleRectCache();
+			Rect newRect;
+			getRectClippedToHierarchy(newRect);
+
+			_parent->invalidateSpatialIndex();
+			_parent->getRectCache()->invalidateBackground();
+			_parent->invalidateLowerGadgetsVisibleRectCache(this, oldRect);
+			_parent->invalidateLowerGadgetsVisibleRectCache(this, newRect);
 		}
 
+		invalidateVisibleRectCache();
+
 		onResize(width, height);
 		
 		// Reset the permeable value
@@ -938,9 +1093,19 @@ bool Gadget::click(s16 x, s16 y) {
 	if (isDoubleClick(x, y)) return doubleClick(x, y);
 
 	// Work out which child was clicked
-	for (s32 i = _gadgets.size() - 1; i > -1; i--) {
-		if (_gadgets[i]->click(x, y)) {
-			return true;
+	WoopsiSmallArray<s32, 8> candidates;
+
+	if (getGadgetsAt(x, y, candidates)) {
+		for (s32 i = 0; i < candidates.size(); i++) {
+			if ((candidates[i] < _gadgets.size()) && (_gadgets[candidates[i]]->click(x, y))) {
+				return true;
+			}
+		}
+	} else {
+		for (s32 i = _gadgets.size() - 1; i > -1; i--) {
+			if (_gadgets[i]->click(x, y)) {
+				return true;
+			}
 		}
 	}
 
@@ -988,9 +1153,19 @@ bool Gadget::doubleClick(s16 x, s16 y) {
 	// child to determine if it has been double-clicked or not
 	// in case the second click has fallen on a different
 	// child to the first.
-	for (s32 i = _gadgets.size() - 1; i > -1; i--) {
-		if (_gadgets[i]->click(x, y)) {
-			return true;
+	WoopsiSmallArray<s32, 8> candidates;
+
+	if (getGadgetsAt(x, y, candidates)) {
+		for (s32 i = 0; i < candidates.size(); i++) {
+			if ((candidates[i] < _gadgets.size()) && (_gadgets[candidates[i]]->click(x, y))) {
+				return true;
+			}
+		}
+	} else {
+		for (s32 i = _gadgets.size() - 1; i > -1; i--) {
+			if (_gadgets[i]->click(x, y)) {
+				return true;
+			}
 		}
 	}
 
@@ -1033,9 +1208,19 @@ bool Gadget::shiftClick(s16 x, s16 y) {
 	if (!checkCollision(x, y)) return false;
 
 	// Work out which child was clicked
-	for (s32 i = _gadgets.size() - 1; i > -1; i--) {
-		if (_gadgets[i]->shiftClick(x, y)) {
-			return true;
+	WoopsiSmallArray<s32, 8> candidates;
+
+	if (getGadgetsAt(x, y, candidates)) {
+		for (s32 i = 0; i < candidates.size(); i++) {
+			if ((candidates[i] < _gadgets.size()) && (_gadgets[candidates[i]]->shiftClick(x, y))) {
+				return true;
+			}
+		}
+	} else {
+		for (s32 i = _gadgets.size() - 1; i > -1; i--) {
+			if (_gadgets[i]->shiftClick(x, y)) {
+				return true;
+			}
 		}
 	}
 
@@ -1303,16 +1488,14 @@ bool Gadget::raiseGadgetToTop(Gadget* gadget) {
 	if ((index > -1) && (index < _gadgets.size() - 1)) {
 		_gadgets.erase(index);
 		_gadgets.push_back(gadget);
+		invalidateSpatialIndex();
 
 		gadget->invalidateVisibleRectCache();
 		gadget->markRectsDamaged();
 
-		// Invalidate all gadgets that collide with the depth-swapped gadget
-		for (s32 i = 0; i < _gadgets.size(); i++) {
-			if (_gadgets[i]->checkCollision(gadget)) {
-				_gadgets[i]->invalidateVisibleRectCache();
-			}
-		}
+		// Invalidate the parts of all gadgets that collide with the
+		// depth-swapped gadget.  All other gadgets are now below it.
+		invalidateLowerGadgetsVisibleRectCache(gadget);
 
 		return true;
 	}
@@ -1334,6 +1517,7 @@ bool Gadget::lowerGadgetToBottom(Gadget* gadget) {
 
 		_gadgets.erase(index);
 		_gadgets.insert(_decorationCount, gadget);
+		invalidateSpatialIndex();
 
 		return true;
 	}
@@ -1357,6 +1541,8 @@ void Gadget::addGadget(Gadget* gadget) {
 		_gadgets.push_back(gadget);
 	}
 
+	invalidateSpatialIndex();
+
 	// Should the gadget steal the focus?
 	if (gadget->hasFocus()) {
 		setFocusedGadget(gadget);
@@ -1382,6 +1568,7 @@ void Gadget::insertGadget(Gadget* gadget) {
 		_gadgets.insert(_decorationCount, gadget);
 	}
 
+	invalidateSpatialIndex();
 	invalidateVisibleRectCache();
 	gadget->markRectsDamaged();
 }
@@ -1389,14 +1576,24 @@ void Gadget::insertGadget(Gadget* gadget) {
 // Invalidate any gadgets below the supplied index
 void Gadget::invalidateLowerGadgetsVisibleRectCache(Gadget* gadget) {
 
+	Rect rect;
+	gadget->getRectClippedToHierarchy(rect);
+
+	invalidateLowerGadgetsVisibleRectCache(gadget, rect);
+}
+
+// Invalidate any parts of gadgets below the supplied index that overlap the
+// rect
+void Gadget::invalidateLowerGadgetsVisibleRectCache(Gadget* gadget, const Rect& rect) {
+
+	if (!rect.hasDimensions()) return;
+
 	// Find the gadget
 	s32 gadgetIndex = getGadgetIndex(gadget);	
 
 	// Invalidate lower gadgets
 	for (s32 i = gadgetIndex - 1; i > -1; i--) {
-		if (_gadgets[i]->checkCollision(gadget)) {
-			_gadgets[i]->invalidateVisibleRectCache();
-		}
+		_gadgets[i]->invalidateVisibleRectCache(rect);
 	}
 }
 
@@ -1468,6 +1665,23 @@ void Gadget::invalidateVisibleRectCache() {
 	}
 }
 
+void Gadget::invalidateVisibleRectCache(const Rect& rect) {
+
+	// Our visible regions can only change within our clipped rect, and our
+	// children are all clipped to it, so we can ignore the entire hierarchy
+	// if the rect does not overlap us
+	Rect gadgetRect;
+	getRectClippedToHierarchy(gadgetRect);
+
+	if (!gadgetRect.intersects(rect)) return;
+
+	_rectCache->invalidate();
+
+	for (s32 i = 0; i < _gadgets.size(); i++) {
+		_gadgets[i]->invalidateVisibleRectCache(rect);
+	}
+}
+
 // Return the client graphics port
 GraphicsPort* Gadget::newGraphicsPort(bool isForeground) {
 
@@ -1479,10 +1693,16 @@ GraphicsPort* Gadget::newGraphicsPort(bool isForeground) {
 	// Ensure visible region cache is up to date
 	cacheVisibleRects();
 
-	// Choose the rect cache to use as the clipping rect list
-	WoopsiArray<Rect>* clipList = isForeground ? _rectCache->getForegroundRegions() : _rectCache->getBackgroundRegions();
+	// Choose the rect cache to use as the clipping region
+	const Region* clipRegion = isForeground ? _rectCache->getForegroundRegion() : _rectCache->getBackgroundRegion();
+
+	// Anything drawn through this port bypasses the surfaces of any layers
+	// that contain the gadget
+	Rect clippedRect;
+	getRectClippedToHierarchy(clippedRect);
+	markLayersDamaged(clippedRect);
 
-	return new GraphicsPort(rect.x + getX(), rect.y + getY(), rect.width, rect.height, isDrawingEnabled(), bitmap, clipList, NULL);
+	return new GraphicsPort(rect.x + getX(), rect.y + getY(), rect.width, rect.height, isDrawingEnabled(), bitmap, clipRegion, NULL);
 }
 
 FrameBuffer* Gadget::getFrameBufferForScreenNumber(u8 screenNumber) const {
@@ -1498,34 +1718,60 @@ FrameBuffer* Gadget::getFrameBufferForScreenNumber(u8 screenNumber) const {
 	return NULL;
 }
 
+void Gadget::setRenderTarget(FrameBuffer* bitmap, s16 x, s16 y) {
+	_renderTarget = bitmap;
+	_renderTargetX = x;
+	_renderTargetY = y;
+}
+
 // Return the client graphics port for a specific clipping rect
-GraphicsPort* Gadget::newGraphicsPort(Rect clipRect) {
+GraphicsPort* Gadget::newGraphicsPort(Rect clipRect, FrameArena* arena) {
 
 	Rect rect;
 	getClientRect(rect);
 
-	FrameBuffer* bitmap = getFrameBufferForScreenNumber(getPhysicalScreenNumber());
+	FrameBuffer* bitmap = _renderTarget != NULL ? _renderTarget : getFrameBufferForScreenNumber(getPhysicalScreenNumber());
 
 	// Ensure visible region cache is up to date
 	cacheVisibleRects();
 
-	return new GraphicsPort(rect.x + getX(), rect.y + getY(), rect.width, rect.height, isDrawingEnabled(), bitmap, NULL, &clipRect);
+	GraphicsPort* port = NULL;
+
+	if (arena != NULL) {
+		port = new (arena->allocate(sizeof(GraphicsPort))) GraphicsPort(rect.x + getX(), rect.y + getY(), rect.width, rect.height, isDrawingEnabled(), bitmap, NULL, &clipRect, arena);
+	} else {
+		port = new GraphicsPort(rect.x + getX(), rect.y + getY(), rect.width, rect.height, isDrawingEnabled(), bitmap, NULL, &clipRect);
+	}
+
+	if (_renderTarget != NULL) port->setBitmapOrigin(_renderTargetX, _renderTargetY);
+
+	return port;
 }
 
 // Return the internal graphics port for a specific clipping rect
-GraphicsPort* Gadget::newInternalGraphicsPort(Rect clipRect) {
+GraphicsPort* Gadget::newInternalGraphicsPort(Rect clipRect, FrameArena* arena) {
 
 	// Ensure visible region cache is up to date
 	cacheVisibleRects();
 
-	FrameBuffer* bitmap = getFrameBufferForScreenNumber(getPhysicalScreenNumber());
+	FrameBuffer* bitmap = _renderTarget != NULL ? _renderTarget : getFrameBufferForScreenNumber(getPhysicalScreenNumber());
+
+	GraphicsPort* port = NULL;
+
+	if (arena != NULL) {
+		port = new (arena->allocate(sizeof(GraphicsPort))) GraphicsPort(getX(), getY(), getWidth(), getHeight(), isDrawingEnabled(), bitmap, NULL, &clipRect, arena);
+	} else {
+		port = new GraphicsPort(getX(), getY(), getWidth(), getHeight(), isDrawingEnabled(), bitmap, NULL, &clipRect);
+	}
 
-	return new GraphicsPort(getX(), getY(), getWidth(), getHeight(), isDrawingEnabled(), bitmap, NULL, &clipRect);
+	if (_renderTarget != NULL) port->setBitmapOrigin(_renderTargetX, _renderTargetY);
+
+	return port;
 }
 
-// Return vector of visible rects, including any covered by children
-WoopsiArray<Rect>* Gadget::getForegroundRegions() {
-	return _rectCache->getForegroundRegions();
+// Return visible region, including any area covered by children
+const Region* Gadget::getForegroundRegion() {
+	return _rectCache->getForegroundRegion();
 }
 
 // Move up hierarchy, clipping rect to each ancestor
@@ -1591,6 +1837,42 @@ void Gadget::setGlyphFont(FontBase* font) {
 	_style.glyphFont = font;
 }
 
+void Gadget::setSpatialIndexEnabled(bool isEnabled) {
+	if (isEnabled) {
+		if (_spatialGrid == NULL) {
+			_spatialGrid = new SpatialGrid(SPATIAL_GRID_CELL_SIZE, SPATIAL_GRID_MAX_CELLS);
+		}
+	} else {
+		delete _spatialGrid;
+		_spatialGrid = NULL;
+	}
+}
+
+void Gadget::invalidateSpatialIndex() {
+	if (_spatialGrid != NULL) _spatialGrid->invalidate();
+}
+
+bool Gadget::getGadgetsIntersecting(const Rect& rect, WoopsiArray<s32>& indices) {
+	if (_spatialGrid == NULL) return false;
+
+	if (!_spatialGrid->isValid()) _spatialGrid->rebuild(_gadgets);
+
+	// Children are indexed using co-ordinates relative to this gadget
+	Rect relativeRect(rect.x - getX(), rect.y - getY(), rect.width, rect.height);
+
+	return _spatialGrid->getGadgetsIntersecting(relativeRect, indices);
+}
+
+bool Gadget::getGadgetsAt(s16 x, s16 y, WoopsiArray<s32>& indices) {
+	if (_spatialGrid == NULL) return false;
+
+	if (!_spatialGrid->isValid()) _spatialGrid->rebuild(_gadgets);
+
+	_spatialGrid->getGadgetsAt(x - getX(), y - getY(), indices);
+
+	return true;
+}
+
 bool Gadget::remove() {
 	markRectsDamaged();
 	
@@ -1639,6 +1921,7 @@ bool Gadget::removeGadget(Gadget* gadget) {
 
 			// Remove gadget from main vector
 			_gadgets.erase(i);
+			invalidateSpatialIndex();
 
 			return true;
 		}
@@ -1698,15 +1981,17 @@ bool Gadget::handleContextMenuSelection(const ListDataItem* item) {
 bool Gadget::show() {
 	if (_flags.hidden) {
 		_flags.hidden = false;
+		invalidateCachedState();
 
 		// Ensure that gadgets behind this do not draw over the
 		// top of the newly-visible gadget
 		if (_parent != NULL) {
+			_parent->getRectCache()->invalidateBackground();
 			_parent->invalidateLowerGadgetsVisibleRectCache(this);
-		} else {
-			invalidateVisibleRectCache();
 		}
 
+		invalidateVisibleRectCache();
+
 		if (raisesEvents()) {
 			_gadgetEventHandler->handleShowEvent(*this);
 		}
@@ -1724,13 +2009,15 @@ bool Gadget::hide() {
 		markRectsDamaged();
 
 		_flags.hidden = true;
+		invalidateCachedState();
 
 		// Ensure the gadget isn't running modally
 		stopModal();
 
 		// Ensure that gadgets behind this do draw over the top
 		if (_parent != NULL) {
-			_parent->invalidateVisibleRectCache();
+			_parent->getRectCache()->invalidateBackground();
+			_parent->invalidateLowerGadgetsVisibleRectCache(this);
 		} else {
 			invalidateVisibleRectCache();
 		}
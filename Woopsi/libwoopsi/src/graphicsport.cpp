@@ -4,37 +4,53 @@
 #include "woopsifuncs.h"
 #include "framebuffer.h"
 #include "bitmapbase.h"
+#include "framearena.h"
 #include "stringiterator.h"
 
 using namespace WoopsiUI;
 
-GraphicsPort::GraphicsPort(const s16 x, const s16 y, const u16 width, const u16 height, const bool isEnabled, FrameBuffer* bitmap, const WoopsiArray<Rect>* clipRectList, const Rect* clipRect) {
+GraphicsPort::GraphicsPort(const s16 x, const s16 y, const u16 width, const u16 height, const bool isEnabled, FrameBuffer* bitmap, const Region* clipRegion, const Rect* clipRect, FrameArena* arena) {
 	_rect.x = x;
 	_rect.y = y;
 	_rect.width = width;
 	_rect.height = height;
 	_isEnabled = isEnabled;
 	
-	_isTopScreen = (y >= TOP_SCREEN_Y_OFFSET) && (SCREEN_COUNT > 1);
+	bool isTopScreen = (y >= TOP_SCREEN_Y_OFFSET) && (SCREEN_COUNT > 1);
 	
-	if (_isTopScreen) {
-		int j = 0;
-		j++;
-	}
+	// Bitmap co-ordinates are relative to the top-left of the display
+	_bitmapX = 0;
+	_bitmapY = isTopScreen ? TOP_SCREEN_Y_OFFSET : 0;
+
+	_isGraphicsInArena = (arena != NULL);
 
-	_graphics = bitmap->newGraphics();
+	if (_isGraphicsInArena) {
+		Rect bitmapRect(0, 0, bitmap->getWidth(), bitmap->getHeight());
+		_graphics = new (arena->allocate(sizeof(Graphics))) Graphics(bitmap, bitmapRect);
+	} else {
+		_graphics = bitmap->newGraphics();
+	}
 	
 	// Set up clip rect
 	if (clipRect != NULL) {
 		setClipRect(*clipRect);
-	} else {
+	} else if (clipRegion != NULL) {
 
-		// Set up clip rect list
-		if (clipRectList != NULL) {
-			for (s32 i = 0; i < clipRectList->size(); ++i) {
-				addClipRect(clipRectList->at(i));
-			}
-		}
+		// Set up clip region.  The region is clipped to the dimensions of the
+		// GraphicsPort for the same reasons as in addClipRect()
+		_clipRegion = *clipRegion;
+		_clipRegion.intersectRect(_rect);
+	}
+}
+
+GraphicsPort::~GraphicsPort() {
+
+	// Graphics objects in the arena are reclaimed when the arena is reset or
+	// rewound, so we just need to destroy them
+	if (_isGraphicsInArena) {
+		_graphics->~Graphics();
+	} else {
+		delete _graphics;
 	}
 }
 
@@ -56,11 +72,11 @@ void GraphicsPort::addClipRect(const Rect& clipRect) {
 	// empty rects
 	if (!rect.hasDimensions()) return;
 	
-	_clipRectList.push_back(rect);
+	_clipRegion.addRect(rect);
 }
 
 void GraphicsPort::setClipRect(const Rect& clipRect) {
-	_clipRectList.clear();
+	_clipRegion.clear();
 	addClipRect(clipRect);
 }
 
@@ -68,11 +84,14 @@ void GraphicsPort::getClipRect(Rect& rect) const {
 
 	// The rect is adjusted such that its co-ordinates are relative to the
 	// GraphicsPort before it is returned.  This makes using the rect
-	// to optimise drawing easier.
-	rect.x = _clipRectList[0].x - getX();
-	rect.y = _clipRectList[0].y - getY();
-	rect.width = _clipRectList[0].width;
-	rect.height = _clipRectList[0].height;
+	// to optimise drawing easier.  If the region contains more than one
+	// rect we return the rect that bounds them all.
+	const Rect& bounds = _clipRegion.getBounds();
+
+	rect.x = bounds.x - getX();
+	rect.y = bounds.y - getY();
+	rect.width = bounds.width;
+	rect.height = bounds.height;
 }
 
 // Print a string in a specific colour
@@ -87,12 +106,13 @@ void GraphicsPort::drawText(s16 x, s16 y, FontBase* font, const WoopsiString& st
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawText(x, y, font, string, startIndex, length, colour);
@@ -111,12 +131,13 @@ void GraphicsPort::drawBaselineText(s16 x, s16 y, FontBase* font, const WoopsiSt
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawBaselineText(x, y, font, string, startIndex, length, colour);
@@ -139,12 +160,13 @@ void GraphicsPort::drawFilledRect(s16 x, s16 y, u16 width, u16 height, u16 colou
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawFilledRect(x, y, width, height, colour);
@@ -162,12 +184,13 @@ void GraphicsPort::drawEllipse(s16 xCentre, s16 yCentre, s16 horizRadius, s16 ve
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawEllipse(xCentre, yCentre, horizRadius, vertRadius, colour);
@@ -186,12 +209,13 @@ void GraphicsPort::drawFilledEllipse(s16 xCentre, s16 yCentre, s16 horizRadius,
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawFilledEllipse(xCentre, yCentre, horizRadius, vertRadius, colour);
@@ -209,12 +233,13 @@ void GraphicsPort::drawRect(s16 x, s16 y, u16 width, u16 height, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawRect(x, y, width, height, colour);
@@ -232,12 +257,13 @@ void GraphicsPort::drawBevelledRect(s16 x, s16 y, u16 width, u16 height, u16 shi
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawBevelledRect(x, y, width, height, shineColour, shadowColour);
@@ -255,12 +281,13 @@ void GraphicsPort::drawFilledXORRect(s16 x, s16 y, u16 width, u16 height, u16 co
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawFilledXORRect(x, y, width, height, colour);
@@ -286,12 +313,13 @@ void GraphicsPort::drawXORRect(s16 x, s16 y, u16 width, u16 height, u16 colour)
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawXORRect(x, y, width, height, colour);
@@ -310,12 +338,13 @@ void GraphicsPort::drawBitmap(s16 x, s16 y, u16 width, u16 height, const BitmapB
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawBitmap(x, y, width, height, bitmap, bitmapX, bitmapY);
@@ -334,12 +363,13 @@ void GraphicsPort::drawBitmap(s16 x, s16 y, u16 width, u16 height, const BitmapB
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawBitmap(x, y, width, height, bitmap, bitmapX, bitmapY, transparentColour);
@@ -357,12 +387,13 @@ void GraphicsPort::drawBitmapGreyScale(s16 x, s16 y, u16 width, u16 height, cons
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawBitmapGreyScale(x, y, width, height, bitmap, bitmapX, bitmapY);
@@ -384,12 +415,13 @@ void GraphicsPort::drawXORHorizLine(s16 x, s16 y, u16 width, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawXORHorizLine(x, y, width, colour);
@@ -407,12 +439,13 @@ void GraphicsPort::drawXORVertLine(s16 x, s16 y, u16 height, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawXORVertLine(x, y, height, colour);
@@ -428,8 +461,9 @@ void GraphicsPort::convertPortToScreenSpace(s16* x, s16* y) {
 	*x += getX();
 	*y += getY();
 
-	// Compensate for top screen offset
-	if (_isTopScreen) *y -= TOP_SCREEN_Y_OFFSET;
+	// Compensate for the position of the bitmap
+	*x -= _bitmapX;
+	*y -= _bitmapY;
 }
 
 void GraphicsPort::drawPixel(s16 x, s16 y, u16 colour) {
@@ -443,12 +477,13 @@ void GraphicsPort::drawPixel(s16 x, s16 y, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawPixel(x, y, colour);
@@ -470,12 +505,13 @@ void GraphicsPort::drawXORPixel(s16 x, s16 y, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawXORPixel(x, y, colour);
@@ -494,12 +530,13 @@ void GraphicsPort::drawLine(s16 x1, s16 y1, s16 x2, s16 y2, u16 colour) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->drawLine(x1, y1, x2, y2, colour);
@@ -518,12 +555,13 @@ void GraphicsPort::copy(s16 sourceX, s16 sourceY, s16 destX, s16 destY, u16 widt
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->copy(sourceX, sourceY, destX, destY, width, height);
@@ -541,12 +579,13 @@ void GraphicsPort::scroll(s16 x, s16 y, s16 xDistance, s16 yDistance, u16 width,
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->scroll(x, y, xDistance, yDistance, width, height, revealedRects);
@@ -557,7 +596,8 @@ void GraphicsPort::scroll(s16 x, s16 y, s16 xDistance, s16 yDistance, u16 width,
 		revealedRects->at(i).x -= _rect.x;
 		revealedRects->at(i).y -= _rect.y;
 		
-		if (_isTopScreen) revealedRects->at(i).y += TOP_SCREEN_Y_OFFSET;
+		revealedRects->at(i).x += _bitmapX;
+		revealedRects->at(i).y += _bitmapY;
 	}
 }
 
@@ -572,12 +612,13 @@ void GraphicsPort::dim(s16 x, s16 y, u16 width, u16 height) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->dim(x, y, width, height);
@@ -595,12 +636,13 @@ void GraphicsPort::greyScale(s16 x, s16 y, u16 width, u16 height) {
 	Rect rect;
 	
 	// Draw all visible rects
-	for (s32 i = 0; i < _clipRectList.size(); i++) {
+	for (s32 i = 0; i < _clipRegion.getRectCount(); i++) {
 		
 		// Adjust from graphicsport co-ordinates to framebuffer co-ordinates
-		_clipRectList.at(i).copyTo(rect);
+		_clipRegion.getRect(i).copyTo(rect);
 		
-		if (_isTopScreen) rect.y -= TOP_SCREEN_Y_OFFSET;
+		rect.x -= _bitmapX;
+		rect.y -= _bitmapY;
 		
 		_graphics->setClipRect(rect);
 		_graphics->greyScale(x, y, width, height);
@@ -1,4 +1,6 @@
 #include "hardware.h"
+#include "defines.h"
+#include "woopsismallarray.h"
 
 using namespace WoopsiUI;
 
@@ -19,6 +21,7 @@ SDL_Texture* Hardware::_texture = NULL;
 
 u16* Hardware::_topBitmap = NULL;
 u16* Hardware::_bottomBitmap = NULL;
+bool Hardware::_isPresentRequired = true;
 
 #endif
 
@@ -67,6 +70,10 @@ void Hardware::init() {
 	_topBuffer = new FrameBuffer(_topBitmap, SCREEN_WIDTH, SCREEN_HEIGHT);
 	_bottomBuffer = new FrameBuffer(_bottomBitmap, SCREEN_WIDTH, SCREEN_HEIGHT);
 
+	// Track changes so that only the changed parts are uploaded each frame
+	_topBuffer->setDirtyTrackingEnabled(true);
+	_bottomBuffer->setDirtyTrackingEnabled(true);
+
 #endif
 
 	_topGfx = _topBuffer->newGraphics();
@@ -97,18 +104,21 @@ void Hardware::waitForVBlank() {
 
 #else
 
-    SDL_Rect rect;
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = SCREEN_WIDTH;
-    rect.h = SCREEN_HEIGHT;
-	SDL_UpdateTexture(_texture, &rect, _topBitmap, SCREEN_WIDTH * sizeof(u16));
+	// Upload only the parts of the framebuffers that have changed
+	bool isDirty = uploadDirtyRects(_topBuffer, 0);
+	isDirty = uploadDirtyRects(_bottomBuffer, SCREEN_HEIGHT) || isDirty;
 
-    rect.y = SCREEN_HEIGHT;
-    SDL_UpdateTexture(_texture, &rect, _bottomBitmap, SCREEN_WIDTH * sizeof(u16));
+	if (isDirty || _isPresentRequired) {
+		SDL_RenderCopy(_renderer, _texture, NULL, NULL);
+		SDL_RenderPresent(_renderer);
 
-    SDL_RenderCopy(_renderer, _texture, NULL, NULL);
-    SDL_RenderPresent(_renderer);
+		_isPresentRequired = false;
+	} else {
+
+		// Presenting blocks until the next vsync.  If we have not presented,
+		// we must wait for the frame to elapse ourselves.
+		SDL_Delay(SDL_FRAME_DURATION);
+	}
 
 	// SDL event pump
 	SDL_Event event;
@@ -126,6 +136,13 @@ void Hardware::waitForVBlank() {
 					return;
                 }
                 break;
+			case SDL_WINDOWEVENT:
+
+				// The window contents may have been lost
+				if ((event.window.event == SDL_WINDOWEVENT_EXPOSED) || (event.window.event == SDL_WINDOWEVENT_RESTORED)) {
+					_isPresentRequired = true;
+				}
+				break;
         }
 	}
 
@@ -134,3 +151,50 @@ void Hardware::waitForVBlank() {
 	_pad.update();
 	_stylus.update();
 }
+
+u32 Hardware::waitForEvent(u32 timeout) {
+
+#ifdef USING_SDL
+
+	u32 startTime = SDL_GetTicks();
+
+	// Passing NULL leaves the event in the queue for waitForVBlank() to
+	// process
+	SDL_WaitEventTimeout(NULL, timeout);
+
+	return SDL_GetTicks() - startTime;
+
+#else
+
+	return 0;
+
+#endif
+
+}
+
+#ifdef USING_SDL
+
+bool Hardware::uploadDirtyRects(FrameBuffer* buffer, s16 textureY) {
+
+	if (!buffer->isDirty()) return false;
+
+	WoopsiSmallArray<Rect, 8> rects;
+	buffer->getDirtyRects(rects);
+	buffer->clearDirty();
+
+	const u16* data = buffer->getData();
+
+	for (s32 i = 0; i < rects.size(); ++i) {
+		SDL_Rect rect;
+		rect.x = rects[i].x;
+		rect.y = rects[i].y + textureY;
+		rect.w = rects[i].width;
+		rect.h = rects[i].height;
+
+		SDL_UpdateTexture(_texture, &rect, data + (rects[i].y * SCREEN_WIDTH) + rects[i].x, SCREEN_WIDTH * sizeof(u16));
+	}
+
+	return true;
+}
+
+#endif
@@ -25,8 +25,21 @@ void ListBox::addOption(ListBoxDataItem* option) {
 	_options.addItem(option);
 }
 
+void ListBox::addOptions(ListBoxDataItem* const* options, const s32 count) {
+	_options.beginUpdate();
+
+	for (s32 i = 0; i < count; ++i) {
+		_options.addItem(options[i]);
+	}
+
+	_options.endUpdate();
+}
+
 void ListBox::addOption(const WoopsiString& text, const u32 value, const u16 normalTextColour, const u16 normalBackColour, const u16 selectedTextColour, const u16 selectedBackColour) {
-	addOption(new ListBoxDataItem(text, value, normalTextColour, normalBackColour, selectedTextColour, selectedBackColour));
+	ListBoxDataItem* item = new ListBoxDataItem(text, value, normalTextColour, normalBackColour, selectedTextColour, selectedBackColour);
+	item->setTextSortKeyEnabled(true);
+
+	addOption(item);
 }
 
 void ListBox::addOption(const WoopsiString& text, const u32 value) {
@@ -65,22 +78,25 @@ void ListBox::drawContents(GraphicsPort* port) {
 	// Ensure top options is not negative
 	if (topOption < 0) topOption = 0;
 
-	// Ensure bottom option does not exceed number of options
-	if (bottomOption >= _options.getItemCount()) bottomOption = _options.getItemCount() - 1;
+	// Ensure bottom option does not exceed number of visible options
+	if (bottomOption >= _options.getVisibleItemCount()) bottomOption = _options.getVisibleItemCount() - 1;
 
 	// Calculate values for loop
 	s32 y = _canvasY + (topOption * optionHeight);
 	s32 i = topOption;
 
 	const ListBoxDataItem* item = NULL;
+	s32 index = 0;
 
 	// Loop through all options drawing each ones
 	while (i <= bottomOption) {
 
-		item = (const ListBoxDataItem*)_options.getItem(i);
+		// Rows show the options that match the filter
+		index = _options.getVisibleItemIndex(i);
+		item = (const ListBoxDataItem*)_options.getItem(index);
 		
 		// Is the option selected?
-		if (item->isSelected()) {
+		if (_options.isItemSelected(index)) {
 			
 			// Draw background
 			if (item->getSelectedBackColour() != getBackColour()) {
@@ -153,12 +169,16 @@ void ListBox::selectAllOptions() {
 	_options.selectAllItems();
 }
 
+void ListBox::selectOptionRange(const s32 first, const s32 last) {
+	_options.selectItemRange(first, last);
+}
+
 bool ListBox::isDoubleClick(s16 x, s16 y) {
 
 	if (!Gadget::isDoubleClick(x, y)) return false;
 
 	// Calculate which option was clicked
-	s32 selectedIndex = (-_canvasY + (y - getY())) / getOptionHeight();
+	s32 selectedIndex = getOptionIndexAt(y);
 
 	// Return true if the same option been clicked twice.  Ignore double-clicks
 	// that occur on different items
@@ -168,21 +188,16 @@ bool ListBox::isDoubleClick(s16 x, s16 y) {
 void ListBox::onClick(s16 x, s16 y) {
 
 	// Abort if there are no options to select
-	if (_options.getItemCount() == 0) return;
+	if (_options.getVisibleItemCount() == 0) return;
 
 	// Calculate which option was clicked
-	_lastSelectedIndex = (-_canvasY + (y - getY())) / getOptionHeight();
+	_lastSelectedIndex = getOptionIndexAt(y);
 
 	// Prevent selecting an option that doesn't exist
-	if (_lastSelectedIndex >= _options.getItemCount()) {
-		_lastSelectedIndex = -1;
-		return;
-	}
+	if (_lastSelectedIndex == -1) return;
 	
-	const ListBoxDataItem* item = (const ListBoxDataItem*)_options.getItem(_lastSelectedIndex);
-
 	// Are we setting or unsetting?
-	if (item->isSelected()) {
+	if (_options.isItemSelected(_lastSelectedIndex)) {
 		
 		// Deselecting
 		_options.deselectItem(_lastSelectedIndex);
@@ -200,10 +215,12 @@ void ListBox::onClick(s16 x, s16 y) {
 void ListBox::onDoubleClick(s16 x, s16 y) {
 
 	// Abort if there are no options to select
-	if (_options.getItemCount() == 0) return;
+	if (_options.getVisibleItemCount() == 0) return;
 
 	// Calculate which option was clicked
-	s32 newSelectedIndex = (-_canvasY + (y - getY())) / getOptionHeight();	
+	s32 newSelectedIndex = getOptionIndexAt(y);
+
+	if (newSelectedIndex == -1) return;
 
 	// Double-click - select the item exclusively
 	bool raisedEvents = raisesEvents();
@@ -218,6 +235,14 @@ void ListBox::onDoubleClick(s16 x, s16 y) {
 	}
 }
 
+const s32 ListBox::getOptionIndexAt(s16 y) const {
+	s32 row = (-_canvasY + (y - getY())) / getOptionHeight();
+
+	if ((row < 0) || (row >= _options.getVisibleItemCount())) return -1;
+
+	return _options.getVisibleItemIndex(row);
+}
+
 const u16 ListBox::getOptionHeight() const {
 	return getFont()->getHeight() + (_optionPadding << 1);
 }
@@ -230,8 +255,8 @@ void ListBox::resizeCanvas() {
 
 	s32 oldCanvasHeight = _canvasHeight;
 
-	// Resize the canvas
-	_canvasHeight = (_options.getItemCount() * getOptionHeight());
+	// Resize the canvas to fit the options that match the filter
+	_canvasHeight = (_options.getVisibleItemCount() * getOptionHeight());
 
 	// Ensure canvas is at least as tall as the gadget
 	_canvasHeight = _canvasHeight < rect.height ? rect.height : _canvasHeight;
@@ -248,6 +273,18 @@ void ListBox::removeAllOptions() {
 	_options.removeAllItems();
 }
 
+void ListBox::setDataProvider(ListDataProvider* dataProvider) {
+	_options.setDataProvider(dataProvider);
+}
+
+void ListBox::refreshOptions() {
+	_options.refresh();
+}
+
+void ListBox::setFilter(const WoopsiString& filter) {
+	_options.setFilter(filter);
+}
+
 void ListBox::handleListDataChangedEvent(ListData& source) {
 	
 	// Forget the last selected item as it may have changed
@@ -1,14 +1,28 @@
 #include <string.h>
 #include "listdata.h"
+#include "trigramindex.h"
+#include "defines.h"
 
 using namespace WoopsiUI;
 
 ListData::ListData() {
+	_dataProvider = NULL;
 	_allowMultipleSelections = true;
 	_sortInsertedItems = false;
+	_updateDepth = 0;
+	_sortPending = false;
+	_sortedCount = 0;
+	_dataChangePending = false;
+	_selectionChangePending = false;
+	_filterIndex = NULL;
+	_filterIndexValid = false;
+	_indexedItemCount = 0;
+	_filteredItemCount = 0;
+	_dataChangeIsAppend = true;
 }
 
 ListData::~ListData() {
+	delete _filterIndex;
 	
 	// Delete all option data
 	for (s32 i = 0; i < _items.size(); i++) {
@@ -20,36 +34,108 @@ ListData::~ListData() {
 
 void ListData::addItem(ListDataItem* item) {
 
+	// Items cannot be added to a provider's data
+	if (_dataProvider != NULL) {
+		delete item;
+		return;
+	}
+
+	bool isAppend = false;
+
 	// Determine insert type
-	if (_sortInsertedItems) {
+	if (_sortInsertedItems && (_updateDepth > 0)) {
+
+		// Defer sorting until the update ends so that bulk inserts are not
+		// quadratic.  The items already in the list are still sorted, so only
+		// the new items need sorting before the two are merged.
+		if (!_sortPending) {
+			_sortedCount = _items.size();
+			_sortPending = true;
+		}
+
+		_items.push_back(item);
+		_selection.setSize(_items.size());
+	} else if (_sortInsertedItems) {
 		
 		// Sorted insert
-		_items.insert(getSortedInsertionIndex(item), item);
+		s32 index = getSortedInsertionIndex(item);
+
+		_items.insert(index, item);
+		_selection.insert(index);
 	} else {
 
 		// Append
 		_items.push_back(item);
+		_selection.setSize(_items.size());
+
+		isAppend = true;
 	}
 
-	raiseDataChangedEvent();
+	raiseDataChangedEvent(isAppend);
+}
+
+void ListData::addItems(ListDataItem* const* items, const s32 count) {
+	beginUpdate();
+
+	for (s32 i = 0; i < count; ++i) {
+		addItem(items[i]);
+	}
+
+	endUpdate();
+}
+
+void ListData::beginUpdate() {
+	_updateDepth++;
+}
+
+void ListData::endUpdate() {
+	if (_updateDepth == 0) return;
+	if (--_updateDepth > 0) return;
+
+	bool isSorted = false;
+
+	if (_sortPending) {
+		_sortPending = false;
+		mergeSort(_sortedCount);
+		isSorted = true;
+	}
+
+	if (_dataChangePending) {
+		_dataChangePending = false;
+
+		// The changes made during the update have already been recorded, but
+		// sorting moves items that may have been indexed since
+		raiseDataChangedEvent(!isSorted);
+	}
+
+	if (_selectionChangePending) {
+		_selectionChangePending = false;
+		raiseSelectionChangedEvent();
+	}
 }
 
 void ListData::addItem(const WoopsiString& text, const u32 value) {
 	
-	// Create new option
-	addItem(new ListDataItem(text, value));
+	// Create new option; plain items compare by text so can use the text key
+	ListDataItem* item = new ListDataItem(text, value);
+	item->setTextSortKeyEnabled(true);
+
+	addItem(item);
 }
 
 void ListData::removeItem(const s32 index) {
 
 	// Bounds check
-	if (index < _items.size()) {
+	if ((index > -1) && (index < _items.size())) {
 
 		// Delete the option
 		delete _items[index];
 
 		// Erase the option from the list
 		_items.erase(index);
+		_selection.erase(index);
+
+		if (_sortPending && (index < _sortedCount)) _sortedCount--;
 
 		raiseDataChangedEvent();
 	}
@@ -59,23 +145,13 @@ void ListData::setSelectedIndex(const s32 index) {
 	setItemSelected(index, true);
 }
 
-const s32 ListData::getSelectedIndex() const {
-
-	// Get the first selected index
-	for (s32 i = 0; i < _items.size(); i++) {
-		if (_items[i]->isSelected()) return i;
-	}
-	
-	return -1;
-}
-
 const ListDataItem* ListData::getSelectedItem() const {
 	
 	// Get the first selected option
 	s32 index = getSelectedIndex();
 	
 	if (index > -1) {
-		return _items[index];
+		return getItem(index);
 	}
 	
 	return NULL;
@@ -91,73 +167,154 @@ void ListData::deselectItem(const s32 index) {
 
 void ListData::setItemSelected(const s32 index, bool selected) {
 
-	// Deselect old options if we're making an option selected and we're not a multiple list
+	// Deselect old options if we're making an option selected and we're not a
+	// multiple list.  A single-selection list has at most one item selected,
+	// so this is a constant-time operation
 	if (((!_allowMultipleSelections) || (index == -1)) && (selected)) {
-		for (s32 i = 0; i < _items.size(); i++) {
-			_items[i]->setSelected(false);
-		}
+		_selection.clear();
 	}
 
 	// Select or deselect the new option
-	if ((index > -1) && (index < _items.size())) {
-		_items[index]->setSelected(selected);
+	if ((index > -1) && (index < _selection.getSize())) {
+		_selection.setSelected(index, selected);
 	}
 
 	raiseSelectionChangedEvent();
 }
 
-void ListData::deselectAllItems() {
-	for (s32 i = 0; i < _items.size(); i++) {
-		_items[i]->setSelected(false);
+void ListData::selectItemRange(const s32 first, const s32 last) {
+	if (_allowMultipleSelections) {
+		_selection.setRangeSelected(first, last, true);
+
+		raiseSelectionChangedEvent();
 	}
+}
+
+void ListData::deselectAllItems() {
+	_selection.clear();
 
 	raiseSelectionChangedEvent();
 }
 
 void ListData::selectAllItems() {
 	if (_allowMultipleSelections) {
-		for (s32 i = 0; i < _items.size(); i++) {
-			_items[i]->setSelected(true);
-		}
+		_selection.setRangeSelected(0, _selection.getSize() - 1, true);
 
 		raiseSelectionChangedEvent();
 	}
 }
 
 void ListData::sort() {
-	quickSort(0, _items.size() - 1);
+
+	// Providers are responsible for the order of their own data
+	if (_dataProvider != NULL) return;
+
+	mergeSort(0);
 	
 	raiseDataChangedEvent();
 }
 
-void ListData::quickSort(const s32 start, const s32 end) {
-	if (end > start) {
+void ListData::mergeSort(const s32 sortedCount) {
+	s32 count = _items.size();
+	s32 first = sortedCount < count ? sortedCount : count;
+
+	if ((count < 2) || (first == count)) return;
 
-		int left = start;
-		int right = end;
+	SortEntry* entries = new SortEntry[count];
+	SortEntry* buffer = new SortEntry[count];
 
-		ListDataItem* pivot = _items[(start + end) >> 1];
+	// Fetch each key once so that the merge passes avoid virtual calls
+	for (s32 i = 0; i < count; ++i) {
+		entries[i].item = _items[i];
+		entries[i].key = _items[i]->getSortKey();
+		entries[i].selected = _selection.isSelected(i);
+	}
+
+	// The passes below never write to the sorted items, so they need to be
+	// present in both arrays
+	for (s32 i = 0; i < first; ++i) {
+		buffer[i] = entries[i];
+	}
+
+	// Bottom-up merge sort of the unsorted items, swapping the roles of the
+	// two arrays after each pass
+	for (s32 width = 1; width < count - first; width <<= 1) {
+		for (s32 start = first; start < count; start += width << 1) {
+			s32 middle = start + width < count ? start + width : count;
+			s32 end = middle + width < count ? middle + width : count;
+
+			mergeRuns(entries, buffer, start, middle, end);
+		}
 
-		do {
-			while ((pivot->compareTo(_items[left]) > 0) && (left < end)) left++;
-			while ((pivot->compareTo(_items[right]) < 0) && (right > start)) right--;
+		SortEntry* tmp = entries;
+		entries = buffer;
+		buffer = tmp;
+	}
 
-			if (left > right) break;
+	// Merge the newly-sorted items into the items that were already sorted
+	if (first > 0) {
+		mergeRuns(entries, buffer, 0, first, count);
 
-			swapItems(left, right);
-			left++;
-			right--;
-		} while (left <= right);
+		SortEntry* tmp = entries;
+		entries = buffer;
+		buffer = tmp;
+	}
 
-		quickSort(start, right);
-		quickSort(left, end);
+	for (s32 i = 0; i < count; ++i) {
+		_items[i] = entries[i].item;
 	}
+
+	// Selection states move with their items
+	if (_selection.getCount() > 0) {
+		_selection.clear();
+
+		for (s32 i = 0; i < count; ++i) {
+			if (entries[i].selected) _selection.setSelected(i, true);
+		}
+	}
+
+	delete[] entries;
+	delete[] buffer;
+}
+
+void ListData::mergeRuns(const SortEntry* source, SortEntry* dest, const s32 start, const s32 middle, const s32 end) {
+	s32 left = start;
+	s32 right = middle;
+	s32 i = start;
+
+	// If the runs are already in order they can be copied without comparing
+	// every entry, which makes sorting a mostly-sorted list cheap
+	if ((middle < end) && (compareItems(source[middle - 1].item, source[middle - 1].key, source[middle].item, source[middle].key) > 0)) {
+		while ((left < middle) && (right < end)) {
+
+			// Take from the left run when items are equal to keep the sort
+			// stable
+			if (compareItems(source[right].item, source[right].key, source[left].item, source[left].key) < 0) {
+				dest[i++] = source[right++];
+			} else {
+				dest[i++] = source[left++];
+			}
+		}
+	}
+
+	while (left < middle) dest[i++] = source[left++];
+	while (right < end) dest[i++] = source[right++];
+}
+
+s8 ListData::compareItems(const ListDataItem* item1, const u32 key1, const ListDataItem* item2, const u32 key2) {
+	if (key1 < key2) return -1;
+	if (key1 > key2) return 1;
+
+	return item1->compareTo(item2);
 }
 
 void ListData::swapItems(const s32 index1, const s32 index2) {
 	ListDataItem* tmp = _items[index1];
 	_items[index1] = _items[index2];
 	_items[index2] = tmp;
+
+	// Selection state moves with the items
+	_selection.swap(index1, index2);
 }
 
 void ListData::removeAllItems() {
@@ -168,26 +325,227 @@ void ListData::removeAllItems() {
 	}
 	
 	_items.clear();
+	_selection.setSize(0);
+	_sortPending = false;
+	_dataProvider = NULL;
+
+	raiseDataChangedEvent();
+}
+
+void ListData::setDataProvider(ListDataProvider* dataProvider) {
+
+	// Delete all option data
+	for (s32 i = 0; i < _items.size(); i++) {
+		delete _items[i];
+	}
+
+	_items.clear();
+	_selection.setSize(0);
+	_sortPending = false;
+	_dataProvider = dataProvider;
+
+	if (_dataProvider != NULL) {
+		_selection.setSize(_dataProvider->getItemCount());
+	}
+
+	raiseDataChangedEvent();
+}
+
+void ListData::refresh() {
+	if (_dataProvider != NULL) {
+		// Match the selection state to the new number of items
+		_selection.setSize(_dataProvider->getItemCount());
+	}
 
 	raiseDataChangedEvent();
 }
 
 const s32 ListData::getSortedInsertionIndex(const ListDataItem* item) const {
 
-	s32 i = 0;
+	u32 key = item->getSortKey();
+
+	s32 low = 0;
+	s32 high = _items.size();
+
+	// Binary search for the first item that is greater than the new item
+	while (low < high) {
+		s32 middle = (low + high) >> 1;
+
+		if (compareItems(item, key, _items[middle], _items[middle]->getSortKey()) < 0) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+void ListData::setFilter(const WoopsiString& filter) {
+	bool narrow = false;
+
+	// If the new filter contains the old one, every item that matches the new
+	// filter must already be visible.  The view is only up to date if no
+	// changes are waiting to be reported.
+	if (isFiltered() && (filter.getLength() > 0) && (!_dataChangePending)) {
+		char* oldTerm = newFoldedText(_filter);
+		narrow = containsFolded(filter.getCharArray(), filter.getByteCount(), oldTerm, _filter.getByteCount());
+		delete[] oldTerm;
+	}
+
+	_filter = filter;
+
+	if (isFiltered()) {
+		applyFilter(narrow);
+	} else {
+		_visibleIndices.clear();
+	}
+
+	if (_updateDepth > 0) {
+		_dataChangePending = true;
+		return;
+	}
+
+	_listDataEventHandler->handleListDataChangedEvent(*this);
+}
+
+void ListData::applyFilter(const bool narrow) {
+	s32 termLength = _filter.getByteCount();
+	char* term = newFoldedText(_filter);
+
+	if (narrow) {
+
+		// Compact the matching items towards the start of the list
+		s32 count = 0;
+
+		for (s32 i = 0; i < _visibleIndices.size(); ++i) {
+			s32 index = _visibleIndices[i];
+
+			if (itemMatches(index, term, termLength)) _visibleIndices[count++] = index;
+		}
+
+		while (_visibleIndices.size() > count) _visibleIndices.pop_back();
+	} else {
+		_visibleIndices.clear();
+
+		s32 itemCount = getItemCount();
+		const WoopsiArray<s32>* candidates = NULL;
 
-	// Locate slot where new option should go
-	while ((i < _items.size()) && (item->compareTo(_items[i]) > 0)) {
-		i++;
+		// Searching every item is fast enough for short lists, so the index
+		// is only built for long ones
+		if ((termLength >= 3) && (itemCount >= FILTER_INDEX_THRESHOLD)) {
+			if (_filterIndex == NULL) _filterIndex = new TrigramIndex();
+
+			if (!_filterIndexValid) {
+				_filterIndex->clear();
+				_indexedItemCount = 0;
+				_filterIndexValid = true;
+			}
+
+			// Only items appended since the index was built need adding
+			for (s32 i = _indexedItemCount; i < itemCount; ++i) {
+				const WoopsiString& text = getItem(i)->getText();
+				_filterIndex->add(i, text.getCharArray(), text.getByteCount());
+			}
+
+			_indexedItemCount = itemCount;
+
+			candidates = _filterIndex->getCandidates(term, termLength);
+		}
+
+		if (candidates != NULL) {
+			for (s32 i = 0; i < candidates->size(); ++i) {
+				if (itemMatches(candidates->at(i), term, termLength)) _visibleIndices.push_back(candidates->at(i));
+			}
+		} else {
+			for (s32 i = 0; i < itemCount; ++i) {
+				if (itemMatches(i, term, termLength)) _visibleIndices.push_back(i);
+			}
+		}
+
+		_filteredItemCount = itemCount;
+	}
+
+	delete[] term;
+}
+
+void ListData::filterAppendedItems() {
+	s32 termLength = _filter.getByteCount();
+	char* term = newFoldedText(_filter);
+	s32 itemCount = getItemCount();
+
+	for (s32 i = _filteredItemCount; i < itemCount; ++i) {
+		if (itemMatches(i, term, termLength)) _visibleIndices.push_back(i);
 	}
 
-	return i;
+	_filteredItemCount = itemCount;
+
+	delete[] term;
+}
+
+bool ListData::itemMatches(const s32 index, const char* term, const s32 termLength) const {
+	const WoopsiString& text = getItem(index)->getText();
+	return containsFolded(text.getCharArray(), text.getByteCount(), term, termLength);
 }
 
-void ListData::raiseDataChangedEvent() {
+char* ListData::newFoldedText(const WoopsiString& text) {
+	s32 length = text.getByteCount();
+	const char* source = text.getCharArray();
+
+	char* folded = new char[length > 0 ? length : 1];
+
+	for (s32 i = 0; i < length; ++i) {
+		folded[i] = TrigramIndex::fold(source[i]);
+	}
+
+	return folded;
+}
+
+bool ListData::containsFolded(const char* text, const s32 textLength, const char* term, const s32 termLength) {
+	for (s32 start = 0; start + termLength <= textLength; ++start) {
+		s32 i = 0;
+
+		while ((i < termLength) && (TrigramIndex::fold(text[start + i]) == term[i])) ++i;
+
+		if (i == termLength) return true;
+	}
+
+	return false;
+}
+
+void ListData::raiseDataChangedEvent(const bool isAppend) {
+
+	// Any change other than appending items leaves the index out of date
+	if (!isAppend) {
+		_filterIndexValid = false;
+		_dataChangeIsAppend = false;
+	}
+
+	if (_updateDepth > 0) {
+		_dataChangePending = true;
+		return;
+	}
+
+	// Bring the filtered view up to date.  If items have only been appended,
+	// just the new items need to be checked.
+	if (isFiltered()) {
+		if (_dataChangeIsAppend) {
+			filterAppendedItems();
+		} else {
+			applyFilter(false);
+		}
+	}
+
+	_dataChangeIsAppend = true;
+
 	_listDataEventHandler->handleListDataChangedEvent(*this);
 }
 
 void ListData::raiseSelectionChangedEvent() {
+	if (_updateDepth > 0) {
+		_selectionChangePending = true;
+		return;
+	}
+
 	_listDataEventHandler->handleListDataSelectionChangedEvent(*this);
 }
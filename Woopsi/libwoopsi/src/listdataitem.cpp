@@ -1,4 +1,5 @@
 #include "listdataitem.h"
+#include "stringiterator.h"
 
 using namespace WoopsiUI;
 
@@ -6,12 +7,59 @@ ListDataItem::ListDataItem(const WoopsiString& text, const u32 value) {
 
 	_text = text;
 	_value = value;
-	_isSelected = false;
+	_isTextSortKeyEnabled = false;
+
+	updateSortKey();
 }
 
 ListDataItem::~ListDataItem() {
 }
 
+void ListDataItem::setText(const WoopsiString& text) {
+	_text = text;
+
+	updateSortKey();
+}
+
 s8 ListDataItem::compareTo(const ListDataItem* item) const {
 	return _text.compareTo(item->getText());
 }
+
+void ListDataItem::updateSortKey() {
+	_sortKey = 0;
+
+	if (_text.getLength() == 0) return;
+
+	StringIterator* iterator = _text.newStringIterator();
+
+	// Pack up to four characters into the key, one per byte.  Unused bytes
+	// are left at 0 so that shorter strings sort first, as they do in
+	// WoopsiString::compareTo().
+	for (s32 shift = 24; shift >= 0; shift -= 8) {
+		u32 codePoint = iterator->getCodePoint();
+
+		// Match the case-insensitive comparison
+		if ((codePoint >= 'A') && (codePoint <= 'Z')) codePoint += 0x20;
+
+		// compareTo() compares runs of digits numerically, so all digits
+		// share one value and the rest of the comparison is left to it.
+		// Digits sort between the characters either side of them in the
+		// character set, just as they do in compareTo().  Characters that do
+		// not fit in a byte are treated in the same way.
+		if ((codePoint >= '0') && (codePoint <= '9')) {
+			_sortKey |= '0' << shift;
+			break;
+		}
+
+		if (codePoint >= 0xFF) {
+			_sortKey |= (u32)0xFF << shift;
+			break;
+		}
+
+		_sortKey |= codePoint << shift;
+
+		if (!iterator->moveToNext()) break;
+	}
+
+	delete iterator;
+}
@@ -0,0 +1,220 @@
+#include "logbuffer.h"
+#include "fontbase.h"
+#include "stringiterator.h"
+
+using namespace WoopsiUI;
+
+LogBuffer::LogBuffer(FontBase* font, u16 width, s32 capacity) {
+	_font = font;
+	_width = width;
+	_capacity = capacity > 0 ? capacity : 1;
+	_lines = new Line[_capacity];
+	_head = 0;
+	_count = 0;
+	_discarded = 0;
+	_isLastLineOpen = false;
+}
+
+LogBuffer::~LogBuffer() {
+	delete[] _lines;
+}
+
+const u8 LogBuffer::getLineHeight() const {
+
+	// Match the default line spacing used by Document
+	return _font->getHeight() + 1;
+}
+
+void LogBuffer::append(const WoopsiString& text, s32& firstChangedLine, s32& discardedLines) {
+
+	// Lines before this point are never touched by the append
+	s32 unchangedLines = _count;
+
+	_discarded = 0;
+
+	s32 length = text.getLength();
+	s32 start = 0;
+
+	while (start < length) {
+		s32 end = text.indexOf('\n', start);
+
+		if (end == -1) end = length;
+
+		if (end > start) {
+			WoopsiString line;
+
+			// Continue the open line by wrapping it again with the new text
+			if (_isLastLineOpen) {
+				takeOpenLine(line);
+
+				if (_count < unchangedLines) unchangedLines = _count;
+			}
+
+			line.append(text.subString(start, end - start));
+			appendWrapped(line);
+
+			_isLastLineOpen = true;
+		}
+
+		if (end < length) {
+
+			// An empty line still occupies a row once it is terminated
+			if (!_isLastLineOpen) appendLine(text, end, 0, false);
+
+			_isLastLineOpen = false;
+		}
+
+		start = end + 1;
+	}
+
+	firstChangedLine = unchangedLines - _discarded;
+
+	if (firstChangedLine < 0) firstChangedLine = 0;
+
+	discardedLines = _discarded;
+}
+
+void LogBuffer::clear() {
+	_head = 0;
+	_count = 0;
+	_isLastLineOpen = false;
+}
+
+void LogBuffer::setFont(FontBase* font) {
+	_font = font;
+	rewrap();
+}
+
+void LogBuffer::setWidth(u16 width) {
+	_width = width;
+	rewrap();
+}
+
+void LogBuffer::takeOpenLine(WoopsiString& text) {
+
+	// The open line starts at the last line that was not wrapped from its
+	// predecessor.  Its start may already have been discarded.
+	s32 first = _count - 1;
+
+	while ((first > 0) && (_lines[getSlot(first)].isContinuation)) {
+		first--;
+	}
+
+	for (s32 i = first; i < _count; ++i) {
+		text.append(_lines[getSlot(i)].text);
+	}
+
+	_count = first;
+}
+
+void LogBuffer::appendWrapped(const WoopsiString& text) {
+	StringIterator* iterator = text.newStringIterator();
+
+	s32 start = 0;
+	s32 index = 0;
+	s32 breakIndex = 0;
+	s32 lineWidth = 0;
+	bool isContinuation = false;
+
+	if (iterator->moveTo(0)) {
+		do {
+			u32 codePoint = iterator->getCodePoint();
+			u8 charWidth = _font->getCharWidth(codePoint);
+
+			// Break the line at the most recent breakpoint if the character
+			// does not fit.  Lines always hold at least one character.
+			while ((lineWidth + charWidth > _width) && (index > start)) {
+				s32 end = breakIndex > start ? breakIndex : index;
+
+				appendLine(text, start, end - start, isContinuation);
+				isContinuation = true;
+
+				// Carry the characters after the breakpoint onto the new line
+				lineWidth = _font->getStringWidth(text, end, index - end);
+				start = end;
+			}
+
+			lineWidth += charWidth;
+			index++;
+
+			if (isBreakPoint(codePoint)) breakIndex = index;
+		} while (iterator->moveToNext());
+	}
+
+	delete iterator;
+
+	appendLine(text, start, index - start, isContinuation);
+}
+
+void LogBuffer::appendLine(const WoopsiString& text, s32 startIndex, s32 length, bool isContinuation) {
+
+	// Reuse the oldest line's storage if the buffer is full
+	if (_count == _capacity) {
+		_head = getSlot(1);
+		_count--;
+		_discarded++;
+	}
+
+	Line& line = _lines[getSlot(_count)];
+
+	line.text = text.subString(startIndex, length);
+	line.isContinuation = isContinuation;
+	line.trimmedLength = length;
+
+	if (length > 0) {
+		StringIterator* iterator = line.text.newStringIterator();
+
+		iterator->moveTo(length - 1);
+
+		while ((line.trimmedLength > 0) && (_font->isCharBlank(iterator->getCodePoint()))) {
+			line.trimmedLength--;
+			iterator->moveToPrevious();
+		}
+
+		delete iterator;
+	}
+
+	_count++;
+}
+
+void LogBuffer::rewrap() {
+
+	// Reassemble the original text from the lines and append it again
+	WoopsiString text;
+
+	for (s32 i = 0; i < _count; ++i) {
+		const Line& line = _lines[getSlot(i)];
+
+		if ((i > 0) && (!line.isContinuation)) text.append("\n");
+
+		text.append(line.text);
+	}
+
+	if ((_count > 0) && (!_isLastLineOpen)) text.append("\n");
+
+	clear();
+
+	s32 firstChangedLine;
+	s32 discardedLines;
+
+	append(text, firstChangedLine, discardedLines);
+}
+
+bool LogBuffer::isBreakPoint(u32 codePoint) {
+	switch (codePoint) {
+		case ' ':
+		case ',':
+		case '.':
+		case '-':
+		case ':':
+		case ';':
+		case '?':
+		case '!':
+		case '+':
+		case '=':
+		case '/':
+			return true;
+		default:
+			return false;
+	}
+}
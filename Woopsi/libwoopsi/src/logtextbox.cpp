@@ -0,0 +1,217 @@
+#include "logtextbox.h"
+#include "damagedrectmanager.h"
+#include "fontbase.h"
+#include "graphicsport.h"
+#include "woopsi.h"
+#include "woopsifuncs.h"
+#include "woopsismallarray.h"
+
+using namespace WoopsiUI;
+
+LogTextBox::LogTextBox(s16 x, s16 y, u16 width, u16 height, s32 maxRows, GadgetStyle* style) : ScrollingPanel(x, y, width, height, style) {
+
+	_borderSize.top = 3;
+	_borderSize.right = 3;
+	_borderSize.bottom = 3;
+	_borderSize.left = 3;
+
+	Rect rect;
+	getClientRect(rect);
+
+	// Track the visible rows if no maximum is set
+	if (maxRows <= 0) maxRows = (rect.height / getFont()->getHeight()) + 1;
+
+	_buffer = new LogBuffer(getFont(), rect.width, maxRows);
+
+	_canvasWidth = rect.width;
+
+	_flags.draggable = true;
+
+	setAllowsHorizontalScroll(false);
+	limitCanvasHeight();
+}
+
+LogTextBox::~LogTextBox() {
+	delete _buffer;
+	_buffer = NULL;
+}
+
+void LogTextBox::drawContents(GraphicsPort* port) {
+
+	if (_buffer->getLineCount() == 0) return;
+
+	// Only draw the rows within the clip rect
+	Rect rect;
+	port->getClipRect(rect);
+
+	s32 lineHeight = getLineHeight();
+	s32 topRow = (rect.y - _canvasY) / lineHeight;
+	s32 bottomRow = (rect.y + rect.height - 1 - _canvasY) / lineHeight;
+
+	if (topRow < 0) topRow = 0;
+	if (bottomRow >= _buffer->getLineCount()) bottomRow = _buffer->getLineCount() - 1;
+
+	u16 colour = isEnabled() ? getTextColour() : getDarkColour();
+
+	for (s32 row = topRow; row <= bottomRow; ++row) {
+		port->drawText(_canvasX, _canvasY + (row * lineHeight), _buffer->getFont(), _buffer->getLine(row), 0, _buffer->getLineTrimmedLength(row), colour);
+	}
+}
+
+void LogTextBox::drawBorder(GraphicsPort* port) {
+
+	port->drawFilledRect(0, 0, getWidth(), getHeight(), getBackColour());
+
+	// Stop drawing if the gadget indicates it should not have an outline
+	if (isBorderless()) return;
+
+	port->drawBevelledRect(0, 0, getWidth(), getHeight(), getShadowColour(), getShineColour());
+}
+
+void LogTextBox::appendText(const WoopsiString& text) {
+
+	Rect rect;
+	getClientRect(rect);
+
+	// Only follow new text if the newest text is currently visible
+	bool isFollowing = _canvasY + _canvasHeight <= rect.height;
+	s32 oldCanvasY = _canvasY;
+
+	s32 firstChangedLine;
+	s32 discardedLines;
+
+	_buffer->append(text, firstChangedLine, discardedLines);
+
+	limitCanvasHeight();
+
+	// Discarding rows moves the remaining rows up the canvas
+	s32 discardedHeight = discardedLines * getLineHeight();
+	s32 bottomY = rect.height - _canvasHeight;
+
+	if (isFollowing) {
+		_canvasY = bottomY;
+	} else {
+
+		// Keep the rows being viewed in place
+		_canvasY = oldCanvasY + discardedHeight;
+
+		if (_canvasY > 0) _canvasY = 0;
+		if (_canvasY < bottomY) _canvasY = bottomY;
+	}
+
+	scrollAppendedText(_canvasY - oldCanvasY - discardedHeight, firstChangedLine);
+
+	if (raisesEvents()) {
+		_gadgetEventHandler->handleValueChangeEvent(*this);
+	}
+}
+
+void LogTextBox::scrollAppendedText(s32 dy, s32 firstChangedLine) {
+
+	Rect rect;
+	getClientRect(rect);
+
+	if (dy != 0) {
+
+		// Scrolling would move any part of the textbox that is still waiting
+		// to be drawn, so redraw the whole textbox instead.  This also means
+		// that further appends within the same frame cost nothing extra.
+		Rect screenRect = rect;
+		screenRect.x += getX();
+		screenRect.y += getY();
+
+		if (woopsiApplication->getDamagedRectManager()->isDamaged(screenRect)) {
+			markRectsDamaged();
+			return;
+		}
+
+		WoopsiSmallArray<Rect, 4> revealedRects;
+		GraphicsPort* port = newGraphicsPort(true);
+		port->scroll(0, 0, 0, dy, rect.width, rect.height, &revealedRects);
+		delete port;
+
+		for (s32 i = 0; i < revealedRects.size(); ++i) {
+
+			// Adjust co-ordinates from graphicsport-space to gadget space
+			revealedRects[i].x += _borderSize.left;
+			revealedRects[i].y += _borderSize.top;
+
+			markRectDamaged(revealedRects[i]);
+		}
+	}
+
+	// Draw the rows that have been added or re-wrapped
+	s32 top = _canvasY + (firstChangedLine * getLineHeight());
+	s32 bottom = _canvasY + (_buffer->getLineCount() * getLineHeight());
+
+	if (top < 0) top = 0;
+	if (bottom > rect.height) bottom = rect.height;
+
+	if (top < bottom) {
+		Rect changedRect;
+		changedRect.x = rect.x;
+		changedRect.y = rect.y + top;
+		changedRect.width = rect.width;
+		changedRect.height = bottom - top;
+
+		markRectDamaged(changedRect);
+	}
+}
+
+void LogTextBox::clearText() {
+
+	_buffer->clear();
+
+	limitCanvasHeight();
+	_canvasY = 0;
+
+	markRectsDamaged();
+
+	if (raisesEvents()) {
+		_gadgetEventHandler->handleValueChangeEvent(*this);
+	}
+}
+
+void LogTextBox::setFont(FontBase* font) {
+
+	_style.font = font;
+	_buffer->setFont(font);
+
+	Rect rect;
+	getClientRect(rect);
+
+	limitCanvasHeight();
+	_canvasY = rect.height - _canvasHeight;
+
+	markRectsDamaged();
+
+	if (raisesEvents()) {
+		_gadgetEventHandler->handleValueChangeEvent(*this);
+	}
+}
+
+void LogTextBox::limitCanvasHeight() {
+
+	_canvasHeight = _buffer->getLineCount() * getLineHeight();
+
+	Rect rect;
+	getClientRect(rect);
+	if (_canvasHeight < rect.height) _canvasHeight = rect.height;
+}
+
+void LogTextBox::onResize(u16 width, u16 height) {
+
+	// Ensure the base class resize method is called
+	ScrollingPanel::onResize(width, height);
+
+	// Re-wrap the text to the new width and show the newest rows
+	Rect rect;
+	getClientRect(rect);
+	_canvasWidth = rect.width;
+	_canvasX = 0;
+
+	_buffer->setWidth(rect.width);
+
+	limitCanvasHeight();
+	_canvasY = rect.height - _canvasHeight;
+}
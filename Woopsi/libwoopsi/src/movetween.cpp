@@ -0,0 +1,31 @@
+#include "movetween.h"
+#include "gadget.h"
+
+using namespace WoopsiUI;
+
+MoveTween::MoveTween(Gadget* gadget, s16 x, s16 y, u16 frames, Easing easing) : Tween(0, PROGRESS_MAX, frames, easing) {
+	_gadget = gadget;
+	_fromX = gadget->getRelativeX();
+	_fromY = gadget->getRelativeY();
+	_toX = x;
+	_toY = y;
+}
+
+void MoveTween::start() {
+	_fromX = _gadget->getRelativeX();
+	_fromY = _gadget->getRelativeY();
+
+	Tween::start();
+}
+
+void MoveTween::update(s32 progress) {
+	s16 x = interpolate(_fromX, _toX, progress);
+	s16 y = interpolate(_fromY, _toY, progress);
+
+	// Moving damages the gadget, so only move when the position changes
+	if ((x != _gadget->getRelativeX()) || (y != _gadget->getRelativeY())) {
+		_gadget->moveTo(x, y);
+	}
+
+	Tween::update(progress);
+}
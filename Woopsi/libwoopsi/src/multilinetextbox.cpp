@@ -78,7 +78,7 @@ void MultiLineTextBox::drawText(GraphicsPort* port) {
 
 void MultiLineTextBox::drawRow(GraphicsPort* port, s32 row) {
 
-	u8 rowLength = _document->getLineTrimmedLength(row);
+	s32 rowLength = _document->getLineTrimmedLength(row);
 	s16 textX = getRowX(row) + _canvasX;
 	s16 textY = getRowY(row) + _canvasY;
 	
@@ -121,7 +121,7 @@ void MultiLineTextBox::getCursorCoordinates(s16& x, s16& y) const {
 		cursorRow = _document->getLineContainingCharIndex(_cursorPos);
 
 		// Cursor line offset gives us the distance of the cursor from the start of the line
-		u8 cursorLineOffset = _cursorPos - _document->getLineStartIndex(cursorRow);
+		s32 cursorLineOffset = _cursorPos - _document->getLineStartIndex(cursorRow);
 			
 		StringIterator* iterator = _document->getText().newStringIterator();
 		iterator->moveTo(_document->getLineStartIndex(cursorRow));
@@ -170,13 +170,12 @@ u32 MultiLineTextBox::getCursorCodePoint() const {
 }
 
 // Calculate values for centralised text
-u8 MultiLineTextBox::getRowX(s32 row) const {
+s16 MultiLineTextBox::getRowX(s32 row) const {
 
 	Rect rect;
 	getClientRect(rect);
 
-	u8 rowLength = _document->getLineTrimmedLength(row);
-	u8 rowPixelWidth = _document->getFont()->getStringWidth(_document->getText(), _document->getLineStartIndex(row), rowLength);
+	s32 rowPixelWidth = _document->getLineTrimmedPixelLength(row);
 
 	// Calculate horizontal position
 	switch (_hAlignment) {
@@ -330,13 +329,19 @@ void MultiLineTextBox::jumpToCursor() {
 
 void MultiLineTextBox::setText(const WoopsiString& text) {
 
+	Rect cursorRect;
+	getCursorRect(cursorRect);
+	s32 lineCount = _document->getLineCount();
+
 	_document->setText(text);
 
-	cullTopLines();
+	bool culled = cullTopLines();
 	limitCanvasHeight();
-	jumpToTextBottom();
 
-	markRectsDamaged();
+	// Damage the rows before scrolling so that they are drawn in their
+	// current positions before the display is scrolled
+	markChangedRowsDamaged(cursorRect, lineCount, culled);
+	jumpToTextBottom();
 
 	if (raisesEvents()) {
 		_gadgetEventHandler->handleValueChangeEvent(*this);
@@ -345,13 +350,19 @@ void MultiLineTextBox::setText(const WoopsiString& text) {
 
 void MultiLineTextBox::appendText(const WoopsiString& text) {
 
+	Rect cursorRect;
+	getCursorRect(cursorRect);
+	s32 lineCount = _document->getLineCount();
+
 	_document->append(text);
 
-	cullTopLines();
+	bool culled = cullTopLines();
 	limitCanvasHeight();
-	jumpToTextBottom();
 
-	markRectsDamaged();
+	// Damage the rows before scrolling so that they are drawn in their
+	// current positions before the display is scrolled
+	markChangedRowsDamaged(cursorRect, lineCount, culled);
+	jumpToTextBottom();
 
 	if (raisesEvents()) {
 		_gadgetEventHandler->handleValueChangeEvent(*this);
@@ -364,15 +375,18 @@ void MultiLineTextBox::removeText(const u32 startIndex) {
 
 void MultiLineTextBox::removeText(const u32 startIndex, const u32 count) {
 
+	Rect cursorRect;
+	getCursorRect(cursorRect);
+	s32 lineCount = _document->getLineCount();
+
 	_document->remove(startIndex, count);
 
+	setCursorPosition(startIndex);
+
 	limitCanvasHeight();
+	markChangedRowsDamaged(cursorRect, lineCount, false);
 	limitCanvasY();
 
-	moveCursorToPosition(startIndex);
-
-	markRectsDamaged();
-
 	if (raisesEvents()) {
 		_gadgetEventHandler->handleValueChangeEvent(*this);
 	}
@@ -380,14 +394,18 @@ void MultiLineTextBox::removeText(const u32 startIndex, const u32 count) {
 
 void MultiLineTextBox::insertText(const WoopsiString& text, const u32 index) {
 
+	Rect cursorRect;
+	getCursorRect(cursorRect);
+	s32 lineCount = _document->getLineCount();
+
 	_document->insert(text, index);
 
-	cullTopLines();
-	limitCanvasHeight();
+	bool culled = cullTopLines();
 
-	moveCursorToPosition(index + text.getLength());
+	setCursorPosition(index + text.getLength());
 
-	markRectsDamaged();
+	limitCanvasHeight();
+	markChangedRowsDamaged(cursorRect, lineCount, culled);
 
 	if (raisesEvents()) {
 		_gadgetEventHandler->handleValueChangeEvent(*this);
@@ -464,14 +482,21 @@ const u32 MultiLineTextBox::getTextLength() const {
 void MultiLineTextBox::showCursor() {
 	if (!_showCursor) {
 		_showCursor = true;
-		markRectsDamaged();
+
+		Rect rect;
+		getCursorRect(rect);
+		markRectDamaged(rect);
 	}
 }
 
 void MultiLineTextBox::hideCursor() {
 	if (_showCursor) {
+
+		Rect rect;
+		getCursorRect(rect);
+		markRectDamaged(rect);
+
 		_showCursor = false;
-		markRectsDamaged();
 	}
 }
 
@@ -487,6 +512,16 @@ void MultiLineTextBox::moveCursorToPosition(const s32 position) {
 	// Erase existing cursor
 	drawCursor(port);
 
+	setCursorPosition(position);
+
+	// Draw cursor in new position
+	drawCursor(port);
+	
+	delete port;
+}
+
+void MultiLineTextBox::setCursorPosition(const s32 position) {
+
 	// Force position to within confines of string
 	if (position < 0) {
 		_cursorPos = 0;
@@ -494,11 +529,75 @@ void MultiLineTextBox::moveCursorToPosition(const s32 position) {
 		s32 len = (s32)_document->getText().getLength();
 		_cursorPos = len > position ? position : len;
 	}
+}
 
-	// Draw cursor in new position
-	drawCursor(port);
-	
-	delete port;
+void MultiLineTextBox::getCursorRect(Rect& rect) const {
+
+	s16 cursorX = 0;
+	s16 cursorY = 0;
+
+	getCursorCoordinates(cursorX, cursorY);
+
+	Rect clientRect;
+	getClientRect(clientRect);
+
+	// Convert from canvas co-ordinates to gadget co-ordinates
+	rect.x = clientRect.x + cursorX + _canvasX;
+	rect.y = clientRect.y + cursorY + _canvasY;
+	rect.width = _document->getFont()->getCharWidth(getCursorCodePoint());
+	rect.height = _document->getFont()->getHeight();
+}
+
+void MultiLineTextBox::markChangedRowsDamaged(const Rect& oldCursorRect, const s32 oldLineCount, const bool linesCulled) {
+
+	// Removing lines from the top of the text moves every row, as does
+	// changing the number of rows if the rows are centred or bottom-aligned
+	// because they fit within the textbox
+	bool rowsMoved = linesCulled;
+
+	if ((oldLineCount != _document->getLineCount()) && (_vAlignment != TEXT_ALIGNMENT_VERT_TOP)) {
+		if ((oldLineCount < _visibleRows) || (_document->getLineCount() < _visibleRows)) rowsMoved = true;
+	}
+
+	if (rowsMoved) {
+		markRectsDamaged();
+		return;
+	}
+
+	// Erase the cursor from its old position
+	if (_showCursor) markRectDamaged(oldCursorRect);
+
+	// Redraw the rows that the document reports have changed
+	Rect rect;
+	getClientRect(rect);
+
+	s32 firstRow = _document->getFirstChangedLine();
+	s32 lastRow = _document->getLastChangedLine();
+
+	if (firstRow <= lastRow) {
+		s32 top = getRowY(firstRow) + _canvasY;
+		s32 bottom = getRowY(lastRow) + _document->getLineHeight() + _canvasY;
+
+		if (top < 0) top = 0;
+		if (bottom > rect.height) bottom = rect.height;
+
+		if (top < bottom) {
+			Rect rowsRect;
+			rowsRect.x = rect.x;
+			rowsRect.y = rect.y + top;
+			rowsRect.width = rect.width;
+			rowsRect.height = bottom - top;
+
+			markRectDamaged(rowsRect);
+		}
+	}
+
+	// Draw the cursor in its new position
+	if (_showCursor) {
+		Rect cursorRect;
+		getCursorRect(cursorRect);
+		markRectDamaged(cursorRect);
+	}
 }
 
 void MultiLineTextBox::onClick(s16 x, s16 y) {
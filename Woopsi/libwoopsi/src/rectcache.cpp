@@ -8,9 +8,14 @@ RectCache::RectCache(const Gadget* gadget) {
 	_gadget = gadget;
 	_foregroundInvalid = true;
 	_backgroundInvalid = true;
-	
-	_foregroundRegions = new WoopsiArray<Rect>(4);
-	_backgroundRegions = new WoopsiArray<Rect>(4);
+}
+
+void* RectCache::operator new(size_t size) {
+	return Gadget::getAllocator().allocate(size);
+}
+
+void RectCache::operator delete(void* data, size_t size) {
+	Gadget::getAllocator().release(data, size);
 }
 
 void RectCache::markRectsDamaged() const {
@@ -19,9 +24,7 @@ void RectCache::markRectsDamaged() const {
 	// down
 	if (woopsiApplication == NULL) return;
 	
-	for (s32 i = 0; i < _foregroundRegions->size(); ++i) {
-		woopsiApplication->getDamagedRectManager()->addDamagedRect(_foregroundRegions->at(i));
-	}
+	woopsiApplication->getDamagedRectManager()->addDamagedRegion(_foregroundRegion);
 }
 
 void RectCache::markRectDamaged(const Rect& rect) const {
@@ -30,32 +33,13 @@ void RectCache::markRectDamaged(const Rect& rect) const {
 	// down
 	if (woopsiApplication == NULL) return;
 	
-	WoopsiArray<Rect> dirtyRects(4);
-	WoopsiArray<Rect> remainderRects(4);
-	Rect intersect;
-	
-	dirtyRects.push_back(rect);
-	
 	// Work out which parts of the dirty rect overlap the visible portions of
 	// this gadget - we only want to attempt to redraw the visible portions of
 	// the rect that overlap.
-	for (s32 i = 0; i < _foregroundRegions->size(); ++i) {
-		for (s32 j = 0; j < dirtyRects.size(); ++j) {
-			if (_foregroundRegions->at(i).splitIntersection(dirtyRects[j], intersect, &remainderRects)) {
-				dirtyRects.erase(j);
-				i--;
-				
-				i += remainderRects.size();
-				for (s32 k = 0; k < remainderRects.size(); ++k) {
-					dirtyRects.push_back(remainderRects[k]);
-				}
-				
-				woopsiApplication->getDamagedRectManager()->addDamagedRect(intersect);
-				
-				remainderRects.clear();
-			}
-		}
-	}
+	Region dirtyRegion(_foregroundRegion);
+	dirtyRegion.intersectRect(rect);
+	
+	woopsiApplication->getDamagedRectManager()->addDamagedRegion(dirtyRegion);
 }
 
 void RectCache::cache() {
@@ -66,13 +50,9 @@ void RectCache::cacheForegroundRegions() {
 
 	if (_foregroundInvalid) {
 		
-		// Use internal region cache to store the non-overlapped rectangles
+		// Use internal region cache to store the non-overlapped area
 		// We will use this to clip the gadget
-		_foregroundRegions->clear();
-
-		// Create pointer to a vector to store the overlapped rectangles
-		// We can discard this later as we don't need it
-		WoopsiArray<Rect>* invisibleRects = new WoopsiArray<Rect>(4);
+		_foregroundRegion.clear();
 
 		// Copy the clipped gadget dimensions into a rect
 		Rect rect;
@@ -81,18 +61,25 @@ void RectCache::cacheForegroundRegions() {
 		// Do we have a visible region left?
 		if ((rect.height > 0) && (rect.width > 0)) {
 
-			// Add rect to list
-			_foregroundRegions->push_back(rect);
-			
-			// Request refresh
 			if (_gadget->getParent() != NULL) {
-				_gadget->getParent()->getRectCache()->removeOverlappedRects(_foregroundRegions, invisibleRects, _gadget);
+
+				// Our visible region is the part of the parent's visible
+				// region that we cover, minus anything covered by higher
+				// siblings.  Anything covered by the parent's siblings and
+				// ancestors' siblings has already been removed from the
+				// parent's region, so we do not need to walk up the hierarchy.
+				RectCache* parentCache = _gadget->getParent()->getRectCache();
+				parentCache->cacheForegroundRegions();
+
+				_foregroundRegion = parentCache->_foregroundRegion;
+				_foregroundRegion.intersectRect(rect);
+
+				parentCache->removeOverlappedRects(_foregroundRegion, _gadget);
+			} else {
+				_foregroundRegion.setRect(rect);
 			}
 		}
 
-		// Tidy up
-		delete invisibleRects;
-
 		_foregroundInvalid = false;
 	}
 }
@@ -104,107 +91,55 @@ void RectCache::cacheBackgroundRegions() {
 
 	if (_backgroundInvalid) {
 
-		// Cache visible regions not overlapped by children
-		_backgroundRegions->clear();
-
-		// Create pointer to a vector to store the overlapped rectangles
-		// We can discard this later as we don't need it
-		WoopsiArray<Rect>* invisibleRects = new WoopsiArray<Rect>(4);
+		// Cache visible area not overlapped by children
+		_backgroundRegion = _foregroundRegion;
 
-		// Copy all foreground regions into the new vector
-		for (s32 i = 0; i < _foregroundRegions->size(); i++) {
-			_backgroundRegions->push_back(_foregroundRegions->at(i));
-		}
-
-		// Remove all child rects from the visible vector
+		// Remove all child rects from the visible region
 		for (s32 i = 0; i < _gadget->getGadgetCount(); i++) {
 			
-			// Stop if there are no more regions to split
-			if (_backgroundRegions->size() == 0) break;
+			// Stop if there is nothing left to remove
+			if (_backgroundRegion.isEmpty()) break;
 			
-			_gadget->getGadget(i)->getRectCache()->splitRectangles(_backgroundRegions, invisibleRects);
+			_gadget->getGadget(i)->getRectCache()->removeFromRegion(_backgroundRegion);
 		}
 
-		// Tidy up
-		delete invisibleRects;
-
 		_backgroundInvalid = false;
 	}
 }
 
-// Split rectangles into valid and invalid sub-rectangles
+// Remove the gadget's rect from the region
 // Used when calculating which portions of a gadget to draw
-void RectCache::splitRectangles(WoopsiArray<Rect>* invalidRects, WoopsiArray<Rect>* validRects) const {
+void RectCache::removeFromRegion(Region& region) const {
 
 	// Bypass if the gadget is hidden - we do not want hidden gadgets to be able
 	// to affect the structure of the screen
 	if (_gadget->isHidden()) return;
 	
-	WoopsiArray<Rect> remainderRects(4);
-	Rect checkRect;
-	Rect intersection;
 	Rect gadgetRect;
+	_gadget->getRectClippedToHierarchy(gadgetRect);
 
-	// Check for collisions with any rectangles in the vector
-	for (s32 i = 0; i < invalidRects->size(); ++i) {
-
-		// Get rectangle to check
-		checkRect = invalidRects->at(i);
-
-		_gadget->getRectClippedToHierarchy(gadgetRect);
-
-		if (gadgetRect.splitIntersection(checkRect, intersection, &remainderRects)) {
-			invalidRects->erase(i);
-			i--;
-
-			i += remainderRects.size();
-
-			for (int j = 0; j < remainderRects.size(); ++j) {
-				invalidRects->insert(0, remainderRects[j]);
-			}
-
-			validRects->push_back(intersection);
-
-			remainderRects.clear();
-		}
-	}
+	region.subtractRect(gadgetRect);
 }
 
-// Remove any rectangles that this gadget overlaps from the visible vector
-// and add them to the invisible vector
+// Remove any areas that this gadget's children overlap from the visible
+// region
 // Called when drawing a gadget to check that no higher gadgets get overwritten
-void RectCache::removeOverlappedRects(WoopsiArray<Rect>* visibleRects, WoopsiArray<Rect>* invisibleRects, const Gadget* gadget) const {
+void RectCache::removeOverlappedRects(Region& visibleRegion, const Gadget* gadget) const {
 
-	const Gadget* parent = _gadget;
-	s32 gadgetIndex = -1;
+	// Locate gadget in the list; we add one to the index to ensure that we
+	// deal with the next gadget up in the z-order
+	s32 gadgetIndex = _gadget->getGadgetIndex(gadget) + 1;
 
-	while ((gadget != NULL) && (parent != NULL)) {
+	// Gadget should never be the bottom item on the screen
+	if (gadgetIndex <= 0) return;
 
-		// Locate gadget in the list; we add one to the index to
-		// ensure that we deal with the next gadget up in the z-order
-		gadgetIndex = parent->getGadgetIndex(gadget) + 1;
+	// Remove any overlapped rectangles
+	for (s32 i = gadgetIndex; i < _gadget->getGadgetCount(); i++) {
+		if (visibleRegion.isEmpty()) break;
 
-		// Gadget should never be the bottom item on the screen
-		if (gadgetIndex > 0) {
+		// Non-opaque gadgets do not hide the gadgets beneath them
+		if (!_gadget->getGadget(i)->isOpaque()) continue;
 
-			// Remove any overlapped rectangles
-			for (s32 i = gadgetIndex; i < parent->getGadgetCount(); i++) {
-				if (visibleRects->size() > 0) {
-					parent->getGadget(i)->getRectCache()->splitRectangles(visibleRects, invisibleRects);
-				} else {
-					break;
-				}
-			}
-		}
-
-		if (visibleRects->size() > 0) {
-			gadget = parent;
-
-			if (parent != NULL) {
-				parent = parent->getParent();
-			}
-		} else {
-			return;
-		}
+		_gadget->getGadget(i)->getRectCache()->removeFromRegion(visibleRegion);
 	}
 }
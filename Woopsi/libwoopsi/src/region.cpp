@@ -0,0 +1,343 @@
+#include "region.h"
+
+using namespace WoopsiUI;
+
+// Co-ordinate used to represent "no more edges"
+#define REGION_INFINITY 0x7FFFFFFF
+
+Region::Region() {
+	_bounds = Rect(0, 0, 0, 0);
+}
+
+Region::Region(const Rect& rect) {
+	setRect(rect);
+}
+
+Region::Region(const Region& region) {
+	for (s32 i = 0; i < region._rects.size(); ++i) {
+		_rects.push_back(region._rects.at(i));
+	}
+
+	_bounds = region._bounds;
+}
+
+Region& Region::operator=(const Region& region) {
+	if (&region == this) return *this;
+
+	_rects.clear();
+
+	for (s32 i = 0; i < region._rects.size(); ++i) {
+		_rects.push_back(region._rects.at(i));
+	}
+
+	_bounds = region._bounds;
+
+	return *this;
+}
+
+void Region::clear() {
+	_rects.clear();
+	_bounds = Rect(0, 0, 0, 0);
+}
+
+void Region::setRect(const Rect& rect) {
+	_rects.clear();
+
+	if (rect.hasDimensions()) {
+		_rects.push_back(rect);
+		_bounds = rect;
+	} else {
+		_bounds = Rect(0, 0, 0, 0);
+	}
+}
+
+const s32 Region::getArea() const {
+	s32 area = 0;
+
+	for (s32 i = 0; i < _rects.size(); ++i) {
+		area += _rects.at(i).width * _rects.at(i).height;
+	}
+
+	return area;
+}
+
+bool Region::contains(s16 x, s16 y) const {
+	if (!_bounds.contains(x, y)) return false;
+
+	for (s32 i = 0; i < _rects.size(); ++i) {
+
+		// Rects are sorted by y, so we can stop once we pass the point
+		if (_rects.at(i).y > y) return false;
+		if (_rects.at(i).contains(x, y)) return true;
+	}
+
+	return false;
+}
+
+bool Region::intersects(const Rect& rect) const {
+	if (!rect.hasDimensions()) return false;
+	if (!_bounds.intersects(rect)) return false;
+
+	for (s32 i = 0; i < _rects.size(); ++i) {
+		if (_rects.at(i).y > rect.getY2()) return false;
+		if (_rects.at(i).intersects(rect)) return true;
+	}
+
+	return false;
+}
+
+void Region::addRect(const Rect& rect) {
+	if (!rect.hasDimensions()) return;
+
+	if (isEmpty()) {
+		setRect(rect);
+		return;
+	}
+
+	combine(Region(rect), OPERATION_UNION);
+}
+
+void Region::addRegion(const Region& region) {
+	if (region.isEmpty()) return;
+
+	if (isEmpty()) {
+		*this = region;
+		return;
+	}
+
+	combine(region, OPERATION_UNION);
+}
+
+void Region::intersectRect(const Rect& rect) {
+	if (isEmpty()) return;
+
+	if (!_bounds.intersects(rect)) {
+		clear();
+		return;
+	}
+
+	// Nothing to do if the rect covers the entire region
+	Rect intersection;
+	_bounds.getIntersect(rect, intersection);
+
+	if (intersection == _bounds) return;
+
+	combine(Region(rect), OPERATION_INTERSECT);
+}
+
+void Region::intersectRegion(const Region& region) {
+	if (isEmpty()) return;
+
+	if (!_bounds.intersects(region._bounds)) {
+		clear();
+		return;
+	}
+
+	combine(region, OPERATION_INTERSECT);
+}
+
+void Region::subtractRect(const Rect& rect) {
+	if (isEmpty()) return;
+	if (!_bounds.intersects(rect)) return;
+
+	combine(Region(rect), OPERATION_SUBTRACT);
+}
+
+void Region::subtractRegion(const Region& region) {
+	if (isEmpty()) return;
+	if (region.isEmpty()) return;
+	if (!_bounds.intersects(region._bounds)) return;
+
+	combine(region, OPERATION_SUBTRACT);
+}
+
+void Region::translate(s16 dx, s16 dy) {
+	for (s32 i = 0; i < _rects.size(); ++i) {
+		_rects.at(i).x += dx;
+		_rects.at(i).y += dy;
+	}
+
+	if (!isEmpty()) {
+		_bounds.x += dx;
+		_bounds.y += dy;
+	}
+}
+
+void Region::combine(const Region& region, Operation operation) {
+
+	const WoopsiArray<Rect>& rects1 = _rects;
+	const WoopsiArray<Rect>& rects2 = region._rects;
+
+	WoopsiSmallArray<Rect, 8> result;
+
+	s32 index1 = 0;
+	s32 index2 = 0;
+	s32 y = -REGION_INFINITY;
+	s32 previousBand = -1;
+
+	while ((index1 < rects1.size()) || (index2 < rects2.size())) {
+
+		// Stop early if the remaining bands cannot produce any output
+		if ((operation != OPERATION_UNION) && (index1 >= rects1.size())) break;
+		if ((operation == OPERATION_INTERSECT) && (index2 >= rects2.size())) break;
+
+		// Get the vertical extent of the band at the front of each list
+		s32 top1 = index1 < rects1.size() ? rects1.at(index1).y : REGION_INFINITY;
+		s32 bottom1 = index1 < rects1.size() ? top1 + rects1.at(index1).height : REGION_INFINITY;
+		s32 top2 = index2 < rects2.size() ? rects2.at(index2).y : REGION_INFINITY;
+		s32 bottom2 = index2 < rects2.size() ? top2 + rects2.at(index2).height : REGION_INFINITY;
+
+		// Skip any gap in which neither list has a band
+		s32 top = y;
+		if (top < top1 && top < top2) top = top1 < top2 ? top1 : top2;
+
+		bool isActive1 = top1 <= top;
+		bool isActive2 = top2 <= top;
+
+		// The output band ends at the next horizontal edge in either list
+		s32 bottom = isActive1 ? bottom1 : top1;
+		s32 bottom2Edge = isActive2 ? bottom2 : top2;
+		if (bottom2Edge < bottom) bottom = bottom2Edge;
+
+		s32 end1 = isActive1 ? getBandEnd(rects1, index1) : index1;
+		s32 end2 = isActive2 ? getBandEnd(rects2, index2) : index2;
+
+		s32 bandStart = result.size();
+
+		combineBand(rects1, index1, end1, rects2, index2, end2, top, bottom - top, operation, result);
+
+		if (result.size() > bandStart) {
+			if ((previousBand < 0) || (!coalesceBands(result, previousBand, bandStart))) {
+				previousBand = bandStart;
+			}
+		}
+
+		// Move past any bands that have been completely consumed
+		y = bottom;
+
+		if (isActive1 && bottom1 == bottom) index1 = end1;
+		if (isActive2 && bottom2 == bottom) index2 = end2;
+	}
+
+	_rects.clear();
+
+	for (s32 i = 0; i < result.size(); ++i) {
+		_rects.push_back(result[i]);
+	}
+
+	updateBounds();
+}
+
+void Region::combineBand(const WoopsiArray<Rect>& rects1, s32 start1, s32 end1, const WoopsiArray<Rect>& rects2, s32 start2, s32 end2, s32 top, s32 height, Operation operation, WoopsiArray<Rect>& dest) {
+
+	// Walk the vertical edges of both span lists from left to right, tracking
+	// whether we are inside each list and emitting a span whenever we leave
+	// an area that the operation keeps
+	bool isInside1 = false;
+	bool isInside2 = false;
+	bool isInside = false;
+	s32 spanStart = 0;
+
+	while (true) {
+		s32 edge1 = REGION_INFINITY;
+		s32 edge2 = REGION_INFINITY;
+
+		if (start1 < end1) edge1 = isInside1 ? rects1.at(start1).x + rects1.at(start1).width : rects1.at(start1).x;
+		if (start2 < end2) edge2 = isInside2 ? rects2.at(start2).x + rects2.at(start2).width : rects2.at(start2).x;
+
+		if ((edge1 == REGION_INFINITY) && (edge2 == REGION_INFINITY)) break;
+
+		s32 x = edge1 < edge2 ? edge1 : edge2;
+
+		if (edge1 == x) {
+			isInside1 = !isInside1;
+			if (!isInside1) start1++;
+		}
+
+		if (edge2 == x) {
+			isInside2 = !isInside2;
+			if (!isInside2) start2++;
+		}
+
+		bool wasInside = isInside;
+
+		switch (operation) {
+			case OPERATION_UNION:
+				isInside = isInside1 || isInside2;
+				break;
+			case OPERATION_INTERSECT:
+				isInside = isInside1 && isInside2;
+				break;
+			case OPERATION_SUBTRACT:
+				isInside = isInside1 && !isInside2;
+				break;
+		}
+
+		if (isInside && !wasInside) {
+			spanStart = x;
+		} else if (!isInside && wasInside) {
+			dest.push_back(Rect(spanStart, top, x - spanStart, height));
+		}
+	}
+}
+
+bool Region::coalesceBands(WoopsiArray<Rect>& rects, s32 previousStart, s32 currentStart) {
+
+	s32 count = currentStart - previousStart;
+
+	if (rects.size() - currentStart != count) return false;
+
+	// Bands must touch
+	if (rects.at(previousStart).y + rects.at(previousStart).height != rects.at(currentStart).y) return false;
+
+	// Bands must have identical spans
+	for (s32 i = 0; i < count; ++i) {
+		const Rect& previous = rects.at(previousStart + i);
+		const Rect& current = rects.at(currentStart + i);
+
+		if ((previous.x != current.x) || (previous.width != current.width)) return false;
+	}
+
+	// Stretch the previous band down over the current band and discard the
+	// current band
+	s32 height = rects.at(currentStart).height;
+
+	for (s32 i = 0; i < count; ++i) {
+		rects.at(previousStart + i).height += height;
+		rects.pop_back();
+	}
+
+	return true;
+}
+
+s32 Region::getBandEnd(const WoopsiArray<Rect>& rects, s32 start) {
+	s32 end = start + 1;
+	s16 y = rects.at(start).y;
+
+	while ((end < rects.size()) && (rects.at(end).y == y)) end++;
+
+	return end;
+}
+
+void Region::updateBounds() {
+	if (_rects.size() == 0) {
+		_bounds = Rect(0, 0, 0, 0);
+		return;
+	}
+
+	// Rects are sorted by y, so the vertical extent comes from the first and
+	// last rects
+	s32 x1 = _rects.at(0).x;
+	s32 x2 = _rects.at(0).x + _rects.at(0).width;
+	s32 y1 = _rects.at(0).y;
+	s32 y2 = _rects.at(_rects.size() - 1).y + _rects.at(_rects.size() - 1).height;
+
+	for (s32 i = 1; i < _rects.size(); ++i) {
+		const Rect& rect = _rects.at(i);
+
+		if (rect.x < x1) x1 = rect.x;
+		if (rect.x + rect.width > x2) x2 = rect.x + rect.width;
+	}
+
+	_bounds = Rect(x1, y1, x2 - x1, y2 - y1);
+}
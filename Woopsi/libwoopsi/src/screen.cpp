@@ -85,10 +85,10 @@ void Screen::onDrag(s16 x, s16 y, s16 vX, s16 vY) {
 			
 			// Copy the current screen display to its new location.  Only copy
 			// a single rect as screens have at most one rect visible
-			if (getRectCache()->getForegroundRegions()->size() == 1) {
+			if (getRectCache()->getForegroundRegion()->getRectCount() == 1) {
 				
 				// Get dimensions of visible portion of screen
-				Rect rect = getRectCache()->getForegroundRegions()->at(0);
+				Rect rect = getRectCache()->getForegroundRegion()->getRect(0);
 				
 				// Clip to display
 				if (rect.y + rect.height > SCREEN_HEIGHT) {
@@ -121,11 +121,11 @@ void Screen::onDrag(s16 x, s16 y, s16 vX, s16 vY) {
 				// Moving up - we need to redraw the new section at
 				// the bottom of the screen
 				
-				if (getRectCache()->getForegroundRegions()->size() > 0) {
+				if (getRectCache()->getForegroundRegion()->getRectCount() > 0) {
 					
 					// Screen is visible - get data from visible rect
-					rect.y = getRectCache()->getForegroundRegions()->at(0).y;
-					rect.height = getRectCache()->getForegroundRegions()->at(0).height;
+					rect.y = getRectCache()->getForegroundRegion()->getRect(0).y;
+					rect.height = getRectCache()->getForegroundRegion()->getRect(0).height;
 					
 					// Clip to display
 					if (rect.y + rect.height > SCREEN_HEIGHT) {
@@ -145,6 +145,10 @@ void Screen::onDrag(s16 x, s16 y, s16 vX, s16 vY) {
 			}
 			
 			_rect.setY(_newY);
+
+			invalidateCachedState();
+
+			if (_parent != NULL) _parent->invalidateSpatialIndex();
 			
 			// Erase the screen from its old location
 			woopsiApplication->getDamagedRectManager()->addDamagedRect(rect);
@@ -153,7 +157,12 @@ void Screen::onDrag(s16 x, s16 y, s16 vX, s16 vY) {
 			invalidateVisibleRectCache();
 			
 			if (_parent != NULL) {
+				_parent->getRectCache()->invalidateBackground();
 				_parent->invalidateLowerGadgetsVisibleRectCache(this);
+
+				// Screens below this that were under the erased area are now
+				// visible
+				_parent->invalidateLowerGadgetsVisibleRectCache(this, rect);
 			}
 		}
 	}
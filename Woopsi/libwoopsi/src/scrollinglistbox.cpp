@@ -62,7 +62,7 @@ void ScrollingListBox::updateScrollbar() {
 	
 	s32 pageSize = rect.height / _listbox->getOptionHeight();
 
-	_scrollbar->setMaximumValue(_listbox->getOptionCount());
+	_scrollbar->setMaximumValue(_listbox->getVisibleOptionCount());
 	_scrollbar->setPageSize(pageSize);
 	
 	// Ditto for value
@@ -135,40 +135,91 @@ void ScrollingListBox::setFont(FontBase* font) {
 
 void ScrollingListBox::addOption(ListBoxDataItem* item) {
 	_listbox->addOption(item);
-	_scrollbar->setMaximumValue(_listbox->getOptionCount() - 1);
+
+	if (_listbox->isUpdating()) return;
+
+	_scrollbar->setMaximumValue(_listbox->getVisibleOptionCount() - 1);
 	
 	updateScrollbar();
 }
 
+void ScrollingListBox::addOptions(ListBoxDataItem* const* options, const s32 count) {
+	_listbox->addOptions(options, count);
+
+	if (_listbox->isUpdating()) return;
+
+	updateScrollbar();
+}
+
 void ScrollingListBox::addOption(const WoopsiString& text, const u32 value) {
 	_listbox->addOption(text, value);
-	_scrollbar->setMaximumValue(_listbox->getOptionCount() - 1);
+
+	if (_listbox->isUpdating()) return;
+
+	_scrollbar->setMaximumValue(_listbox->getVisibleOptionCount() - 1);
 	
 	updateScrollbar();
 }
 
 void ScrollingListBox::addOption(const WoopsiString& text, const u32 value, const u16 normalTextColour, const u16 normalBackColour, const u16 selectedTextColour, const u16 selectedBackColour) {
 	_listbox->addOption(text, value, normalTextColour, normalBackColour, selectedTextColour, selectedBackColour);
-	_scrollbar->setMaximumValue(_listbox->getOptionCount() - 1);
+
+	if (_listbox->isUpdating()) return;
+
+	_scrollbar->setMaximumValue(_listbox->getVisibleOptionCount() - 1);
 	
 	updateScrollbar();
 }
 
 void ScrollingListBox::removeOption(const s32 index) {
 	_listbox->removeOption(index);
-	_scrollbar->setMaximumValue(_listbox->getOptionCount() - 1);
+
+	if (_listbox->isUpdating()) return;
+
+	_scrollbar->setMaximumValue(_listbox->getVisibleOptionCount() - 1);
 	
 	updateScrollbar();
 }
 
 void ScrollingListBox::removeAllOptions() {
 	_listbox->removeAllOptions();
+
+	if (_listbox->isUpdating()) return;
+
 	_scrollbar->setMaximumValue(0);
 	_scrollbar->setValue(0);
 	
 	updateScrollbar();
 };
 
+void ScrollingListBox::setDataProvider(ListDataProvider* dataProvider) {
+	_listbox->setDataProvider(dataProvider);
+	
+	updateScrollbar();
+}
+
+void ScrollingListBox::refreshOptions() {
+	_listbox->refreshOptions();
+	
+	updateScrollbar();
+}
+
+void ScrollingListBox::setFilter(const WoopsiString& filter) {
+	_listbox->setFilter(filter);
+
+	if (_listbox->isUpdating()) return;
+
+	updateScrollbar();
+}
+
+void ScrollingListBox::endUpdate() {
+	_listbox->endUpdate();
+
+	if (_listbox->isUpdating()) return;
+
+	updateScrollbar();
+}
+
 // Get the preferred dimensions of the gadget
 void ScrollingListBox::getPreferredDimensions(Rect& rect) const {
 
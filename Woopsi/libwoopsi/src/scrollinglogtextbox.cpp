@@ -0,0 +1,156 @@
+#include "scrollinglogtextbox.h"
+#include "scrollbarvertical.h"
+#include "graphicsport.h"
+
+using namespace WoopsiUI;
+
+ScrollingLogTextBox::ScrollingLogTextBox(s16 x, s16 y, u16 width, u16 height, s32 maxRows, GadgetStyle* style) : Gadget(x, y, width, height, style) {
+	_scrollbarWidth = 10;
+
+	setBorderless(true);
+
+	_textbox = new LogTextBox(0, 0, width - _scrollbarWidth, height, maxRows, &_style);
+	_textbox->setGadgetEventHandler(this);
+
+	// Create scrollbar
+	_scrollbar = new ScrollbarVertical(width - _scrollbarWidth, 0, _scrollbarWidth, height, &_style);
+
+	updateScrollbar();
+
+	_scrollbar->setGadgetEventHandler(this);
+
+	// Add children to child array
+	addGadget(_textbox);
+	addGadget(_scrollbar);
+}
+
+void ScrollingLogTextBox::appendText(const WoopsiString& text) {
+	_textbox->appendText(text);
+}
+
+void ScrollingLogTextBox::clearText() {
+	_textbox->clearText();
+}
+
+void ScrollingLogTextBox::setFont(FontBase* font) {
+	_style.font = font;
+	_textbox->setFont(font);
+	_scrollbar->setFont(font);
+}
+
+const LogBuffer* ScrollingLogTextBox::getBuffer() const {
+	return _textbox->getBuffer();
+}
+
+void ScrollingLogTextBox::handleValueChangeEvent(Gadget& source) {
+	if (&source == _scrollbar) {
+
+		if (_textbox != NULL) {
+			_textbox->setRaisesEvents(false);
+			_textbox->jump(0, 0 - _scrollbar->getValue() * _textbox->getLineHeight());
+			_textbox->setRaisesEvents(true);
+		}
+	} else if (&source == _textbox) {
+		updateScrollbar();
+	}
+}
+
+void ScrollingLogTextBox::updateScrollbar() {
+
+	if (_scrollbar == NULL) return;
+
+	_scrollbar->setRaisesEvents(false);
+
+	Rect rect;
+	_textbox->getClientRect(rect);
+
+	// Use same scaling method used in Range class to ensure we round correctly
+	// when calculating page size
+	u32 div = rect.height / _textbox->getLineHeight();
+	u32 mod = rect.height % _textbox->getLineHeight();
+
+	s32 pageSize = div + (2 * mod + _textbox->getLineHeight()) / (2 * _textbox->getLineHeight());
+
+	_scrollbar->setMaximumValue(_textbox->getLineCount());
+	_scrollbar->setPageSize(pageSize);
+
+	// Ditto for value
+	div = (0 - _textbox->getCanvasY()) / _textbox->getLineHeight();
+	mod = (0 - _textbox->getCanvasY()) % _textbox->getLineHeight();
+
+	s32 value = div + (2 * mod + _textbox->getLineHeight()) / (2 * _textbox->getLineHeight());
+
+	_scrollbar->setValue(value);
+
+	_scrollbar->setRaisesEvents(true);
+}
+
+void ScrollingLogTextBox::handleScrollEvent(Gadget& source, const WoopsiPoint& delta) {
+	if (&source == _textbox) {
+		updateScrollbar();
+	}
+}
+
+void ScrollingLogTextBox::drawContents(GraphicsPort* port) {
+	port->drawFilledRect(0, 0, getWidth(), getHeight(), getBackColour());
+}
+
+void ScrollingLogTextBox::onResize(u16 width, u16 height) {
+
+	// Resize the children
+	_textbox->resize(width - _scrollbarWidth, height);
+	_scrollbar->resize(_scrollbarWidth, height);
+
+	// Move the scrollbar
+	_scrollbar->moveTo(width - _scrollbarWidth, 0);
+
+	updateScrollbar();
+}
+
+const s32 ScrollingLogTextBox::getCanvasX() const {
+	return _textbox->getCanvasX();
+}
+
+const s32 ScrollingLogTextBox::getCanvasY() const {
+	return _textbox->getCanvasY();
+}
+
+const s32 ScrollingLogTextBox::getCanvasWidth() const {
+	return _textbox->getCanvasWidth();
+}
+
+const s32 ScrollingLogTextBox::getCanvasHeight() const {
+	return _textbox->getCanvasHeight();
+}
+
+void ScrollingLogTextBox::scroll(s32 dx, s32 dy) {
+	_textbox->scroll(dx, dy);
+}
+
+void ScrollingLogTextBox::jump(s32 x, s32 y) {
+	_textbox->jump(x, y);
+}
+
+void ScrollingLogTextBox::setAllowsVerticalScroll(bool allow) {
+	_textbox->setAllowsVerticalScroll(allow);
+}
+
+void ScrollingLogTextBox::setAllowsHorizontalScroll(bool allow) {
+	// NOP
+}
+
+void ScrollingLogTextBox::setCanvasWidth(const s32 width) {
+	// NOP
+}
+
+void ScrollingLogTextBox::setCanvasHeight(const s32 height) {
+	// NOP
+}
+
+bool ScrollingLogTextBox::allowsVerticalScroll() const {
+	return _textbox->allowsVerticalScroll();
+}
+
+bool ScrollingLogTextBox::allowsHorizontalScroll() const {
+	return _textbox->allowsHorizontalScroll();
+}
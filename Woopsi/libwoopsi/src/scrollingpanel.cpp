@@ -4,6 +4,7 @@
 #include "woopsi.h"
 #include "woopsifuncs.h"
 #include "woopsipoint.h"
+#include "woopsismallarray.h"
 
 using namespace WoopsiUI;
 
@@ -73,7 +74,7 @@ void ScrollingPanel::scroll(s32 dx, s32 dy) {
 		if (_isContentScrolled) {
 
 			// Perform scroll
-			WoopsiArray<Rect> revealedRects(4);
+			WoopsiSmallArray<Rect, 4> revealedRects;
 			GraphicsPort* port = newGraphicsPort(true);
 			port->scroll(0, 0, dx, dy, rect.width, rect.height, &revealedRects);
 			delete port;
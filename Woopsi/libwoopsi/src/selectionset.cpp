@@ -0,0 +1,259 @@
+#include "selectionset.h"
+
+using namespace WoopsiUI;
+
+SelectionSet::SelectionSet() {
+	_words = NULL;
+	_wordCapacity = 0;
+	_size = 0;
+	_count = 0;
+	_first = -1;
+}
+
+SelectionSet::~SelectionSet() {
+	delete[] _words;
+}
+
+const s32 SelectionSet::getNext(const s32 index) const {
+	s32 start = index + 1;
+
+	if (start >= _size) return -1;
+
+	s32 wordCount = (_size + 31) >> 5;
+	s32 word = start >> 5;
+
+	// Mask out the bits before the start position in the first word
+	u32 bits = _words[word] & (0xFFFFFFFF << (start & 31));
+
+	while (bits == 0) {
+		if (++word >= wordCount) return -1;
+		bits = _words[word];
+	}
+
+	s32 bit = 0;
+	while ((bits & 1) == 0) {
+		bits >>= 1;
+		bit++;
+	}
+
+	return (word << 5) + bit;
+}
+
+void SelectionSet::setSize(const s32 size) {
+	if (size > _size) {
+
+		// Bits beyond the end of the set are always clear, so new indices
+		// are automatically unselected
+		reserve(size);
+		_size = size;
+		return;
+	}
+
+	if (size == _size) return;
+
+	s32 oldWordCount = (_size + 31) >> 5;
+	s32 wordCount = (size + 31) >> 5;
+
+	// Clear the discarded bits in the last word that remains in use
+	if ((size & 31) != 0) {
+		_words[wordCount - 1] &= ((u32)1 << (size & 31)) - 1;
+	}
+
+	for (s32 i = wordCount; i < oldWordCount; ++i) {
+		_words[i] = 0;
+	}
+
+	_size = size;
+
+	if ((_count > 0) && (_first >= size)) {
+		_count = 0;
+		_first = -1;
+	} else if (_count > 1) {
+		recount();
+	}
+}
+
+void SelectionSet::setSelected(const s32 index, const bool selected) {
+	if (isSelected(index) == selected) return;
+
+	u32 mask = (u32)1 << (index & 31);
+
+	if (selected) {
+		_words[index >> 5] |= mask;
+		_count++;
+
+		if ((_first == -1) || (index < _first)) _first = index;
+	} else {
+		_words[index >> 5] &= ~mask;
+		_count--;
+
+		if (index == _first) _first = _count > 0 ? getNext(index) : -1;
+	}
+}
+
+void SelectionSet::setRangeSelected(const s32 first, const s32 last, const bool selected) {
+	s32 start = first < 0 ? 0 : first;
+	s32 end = last >= _size ? _size - 1 : last;
+
+	if (start > end) return;
+
+	s32 startWord = start >> 5;
+	s32 endWord = end >> 5;
+
+	for (s32 word = startWord; word <= endWord; ++word) {
+
+		// Build a mask covering the part of the range within this word
+		u32 mask = 0xFFFFFFFF;
+		if (word == startWord) mask &= 0xFFFFFFFF << (start & 31);
+		if (word == endWord) mask &= 0xFFFFFFFF >> (31 - (end & 31));
+
+		if (selected) {
+			_count += countBits(~_words[word] & mask);
+			_words[word] |= mask;
+		} else {
+			_count -= countBits(_words[word] & mask);
+			_words[word] &= ~mask;
+		}
+	}
+
+	if (_count == 0) {
+		_first = -1;
+	} else if (selected) {
+		if ((_first == -1) || (start < _first)) _first = start;
+	} else if ((_first >= start) && (_first <= end)) {
+		_first = getNext(end);
+	}
+}
+
+void SelectionSet::clear() {
+	if (_count == 0) return;
+
+	if (_count == 1) {
+
+		// Only one bit can be set, so there is no need to touch any other
+		// words
+		_words[_first >> 5] = 0;
+	} else {
+		s32 wordCount = (_size + 31) >> 5;
+
+		for (s32 i = 0; i < wordCount; ++i) {
+			_words[i] = 0;
+		}
+	}
+
+	_count = 0;
+	_first = -1;
+}
+
+void SelectionSet::insert(const s32 index) {
+	reserve(_size + 1);
+
+	s32 wordCount = (_size + 32) >> 5;
+	s32 indexWord = index >> 5;
+
+	// Shift whole words up by one bit, carrying the top bit of each word
+	// into the word above
+	for (s32 word = wordCount - 1; word > indexWord; --word) {
+		_words[word] = (_words[word] << 1) | (_words[word - 1] >> 31);
+	}
+
+	// Shift the bits at and above the index in its own word
+	u32 lowMask = ((u32)1 << (index & 31)) - 1;
+	_words[indexWord] = (_words[indexWord] & lowMask) | ((_words[indexWord] & ~lowMask) << 1);
+
+	_size++;
+
+	if (_first >= index) _first++;
+}
+
+void SelectionSet::erase(const s32 index) {
+	bool wasSelected = isSelected(index);
+
+	s32 wordCount = (_size + 31) >> 5;
+	s32 indexWord = index >> 5;
+
+	// Shift the bits above the index in its own word down by one bit
+	u32 lowMask = ((u32)1 << (index & 31)) - 1;
+	_words[indexWord] = (_words[indexWord] & lowMask) | ((_words[indexWord] >> 1) & ~lowMask);
+
+	// Shift the remaining words down, carrying the bottom bit of each word
+	// into the top of the word below
+	for (s32 word = indexWord + 1; word < wordCount; ++word) {
+		_words[word - 1] |= _words[word] << 31;
+		_words[word] >>= 1;
+	}
+
+	_size--;
+
+	if (wasSelected) {
+		_count--;
+
+		if (index == _first) _first = _count > 0 ? getNext(index - 1) : -1;
+	} else if (_first > index) {
+		_first--;
+	}
+}
+
+void SelectionSet::swap(const s32 index1, const s32 index2) {
+	bool selected1 = isSelected(index1);
+
+	if (selected1 == isSelected(index2)) return;
+
+	// Flipping both bits exchanges their states without changing the count
+	_words[index1 >> 5] ^= (u32)1 << (index1 & 31);
+	_words[index2 >> 5] ^= (u32)1 << (index2 & 31);
+
+	s32 selectedIndex = selected1 ? index2 : index1;
+	s32 deselectedIndex = selected1 ? index1 : index2;
+
+	if (selectedIndex < _first) {
+		_first = selectedIndex;
+	} else if (deselectedIndex == _first) {
+		_first = getNext(deselectedIndex);
+	}
+}
+
+void SelectionSet::reserve(const s32 size) {
+	s32 wordCount = (size + 31) >> 5;
+
+	if (wordCount <= _wordCapacity) return;
+
+	// Grow geometrically to keep repeated insertions cheap
+	s32 capacity = _wordCapacity > 0 ? _wordCapacity * 2 : 4;
+	if (capacity < wordCount) capacity = wordCount;
+
+	u32* words = new u32[capacity];
+
+	for (s32 i = 0; i < _wordCapacity; ++i) {
+		words[i] = _words[i];
+	}
+
+	for (s32 i = _wordCapacity; i < capacity; ++i) {
+		words[i] = 0;
+	}
+
+	delete[] _words;
+
+	_words = words;
+	_wordCapacity = capacity;
+}
+
+s32 SelectionSet::countBits(u32 word) {
+	word = word - ((word >> 1) & 0x55555555);
+	word = (word & 0x33333333) + ((word >> 2) & 0x33333333);
+	word = (word + (word >> 4)) & 0x0F0F0F0F;
+
+	return (s32)((word * 0x01010101) >> 24);
+}
+
+void SelectionSet::recount() {
+	s32 wordCount = (_size + 31) >> 5;
+
+	_count = 0;
+
+	for (s32 i = 0; i < wordCount; ++i) {
+		_count += countBits(_words[i]);
+	}
+
+	_first = _count > 0 ? getNext(-1) : -1;
+}
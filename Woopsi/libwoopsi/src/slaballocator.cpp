@@ -0,0 +1,103 @@
+#include "slaballocator.h"
+
+using namespace WoopsiUI;
+
+// Number of objects in the first slab allocated for each size class
+#define SLAB_INITIAL_OBJECT_COUNT 2
+
+// Maximum number of objects in a single slab
+#define SLAB_MAX_OBJECT_COUNT 32
+
+SlabAllocator::SlabAllocator(u32 granularity, u32 maxObjectSize) {
+	_granularity = granularity;
+	_maxObjectSize = maxObjectSize;
+	_sizeClassCount = (maxObjectSize + granularity - 1) / granularity;
+	_slabs = NULL;
+	_objectCount = 0;
+	_slabMemory = 0;
+
+	// Size class n holds objects of (n + 1) * granularity bytes
+	_freeSlots = new FreeSlot*[_sizeClassCount];
+	_nextSlabObjectCounts = new u8[_sizeClassCount];
+
+	for (u32 i = 0; i < _sizeClassCount; ++i) {
+		_freeSlots[i] = NULL;
+		_nextSlabObjectCounts[i] = SLAB_INITIAL_OBJECT_COUNT;
+	}
+}
+
+SlabAllocator::~SlabAllocator() {
+	while (_slabs != NULL) {
+		Slab* next = _slabs->next;
+		delete [] (u8*)_slabs;
+		_slabs = next;
+	}
+
+	delete [] _freeSlots;
+	delete [] _nextSlabObjectCounts;
+}
+
+void* SlabAllocator::allocate(u32 size) {
+
+	// Large objects come straight from the heap
+	if ((size == 0) || (size > _maxObjectSize)) return new u8[size];
+
+	u32 sizeClass = (size - 1) / _granularity;
+
+	if (_freeSlots[sizeClass] == NULL) allocateSlab(sizeClass);
+
+	// Pop the first free slot off the list
+	FreeSlot* slot = _freeSlots[sizeClass];
+	_freeSlots[sizeClass] = slot->next;
+
+	_objectCount++;
+
+	return slot;
+}
+
+void SlabAllocator::release(void* data, u32 size) {
+	if (data == NULL) return;
+
+	if ((size == 0) || (size > _maxObjectSize)) {
+		delete [] (u8*)data;
+		return;
+	}
+
+	u32 sizeClass = (size - 1) / _granularity;
+
+	// Push the slot back onto the list
+	FreeSlot* slot = (FreeSlot*)data;
+	slot->next = _freeSlots[sizeClass];
+	_freeSlots[sizeClass] = slot;
+
+	_objectCount--;
+}
+
+void SlabAllocator::allocateSlab(u32 sizeClass) {
+	u32 objectSize = (sizeClass + 1) * _granularity;
+	u32 objectCount = _nextSlabObjectCounts[sizeClass];
+	u32 slabSize = sizeof(Slab) + (objectSize * objectCount);
+
+	u8* memory = new u8[slabSize];
+
+	// Chain the slab into the list of slabs
+	Slab* slab = (Slab*)memory;
+	slab->next = _slabs;
+	_slabs = slab;
+
+	_slabMemory += slabSize;
+
+	// Carve the rest of the slab into slots and add them to the free list
+	u8* slotMemory = memory + sizeof(Slab);
+
+	for (u32 i = 0; i < objectCount; ++i) {
+		FreeSlot* slot = (FreeSlot*)(slotMemory + (i * objectSize));
+		slot->next = _freeSlots[sizeClass];
+		_freeSlots[sizeClass] = slot;
+	}
+
+	// The next slab for this size class will be larger
+	if (objectCount < SLAB_MAX_OBJECT_COUNT) {
+		_nextSlabObjectCounts[sizeClass] = objectCount * 2;
+	}
+}
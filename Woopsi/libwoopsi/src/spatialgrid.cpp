@@ -0,0 +1,240 @@
+#include "spatialgrid.h"
+#include "gadget.h"
+
+using namespace WoopsiUI;
+
+SpatialGrid::SpatialGrid(u16 cellSize, s32 maxCells) {
+	_preferredCellSize = cellSize;
+	_maxCells = maxCells;
+	_cellSize = cellSize;
+	_originX = 0;
+	_originY = 0;
+	_columns = 0;
+	_rows = 0;
+	_cellStarts = NULL;
+	_cellStartsSize = 0;
+	_entries = NULL;
+	_entriesSize = 0;
+	_marks = NULL;
+	_marksSize = 0;
+	_markStamp = 0;
+	_isValid = false;
+}
+
+SpatialGrid::~SpatialGrid() {
+	delete [] _cellStarts;
+	delete [] _entries;
+	delete [] _marks;
+}
+
+void SpatialGrid::rebuild(const WoopsiArray<Gadget*>& gadgets) {
+
+	_columns = 0;
+	_rows = 0;
+	_isValid = true;
+
+	// Work out the bounding box of all children
+	Rect bounds;
+	bool hasBounds = false;
+
+	for (s32 i = 0; i < gadgets.size(); ++i) {
+		Rect rect(gadgets[i]->getRelativeX(), gadgets[i]->getRelativeY(), gadgets[i]->getWidth(), gadgets[i]->getHeight());
+
+		if (!rect.hasDimensions()) continue;
+
+		if (hasBounds) {
+			bounds.expandToInclude(rect);
+		} else {
+			bounds = rect;
+			hasBounds = true;
+		}
+	}
+
+	if (!hasBounds) return;
+
+	// Choose a cell size that keeps the grid within the cell limit
+	_cellSize = _preferredCellSize;
+	_originX = bounds.x;
+	_originY = bounds.y;
+
+	while (true) {
+		_columns = (bounds.width + _cellSize - 1) / _cellSize;
+		_rows = (bounds.height + _cellSize - 1) / _cellSize;
+
+		if (_columns * _rows <= _maxCells) break;
+
+		_cellSize *= 2;
+	}
+
+	s32 cellCount = _columns * _rows;
+
+	if (_cellStartsSize < cellCount + 1) {
+		delete [] _cellStarts;
+		_cellStarts = new s32[cellCount + 1];
+		_cellStartsSize = cellCount + 1;
+	}
+
+	for (s32 i = 0; i <= cellCount; ++i) {
+		_cellStarts[i] = 0;
+	}
+
+	// Count the entries in each cell.  Counts are stored one cell along so
+	// that the running total below produces the start index of each cell.
+	s32 column1, row1, column2, row2;
+
+	for (s32 i = 0; i < gadgets.size(); ++i) {
+		Rect rect(gadgets[i]->getRelativeX(), gadgets[i]->getRelativeY(), gadgets[i]->getWidth(), gadgets[i]->getHeight());
+
+		if (!getCellRange(rect, column1, row1, column2, row2)) continue;
+
+		for (s32 row = row1; row <= row2; ++row) {
+			for (s32 column = column1; column <= column2; ++column) {
+				_cellStarts[(row * _columns) + column + 1]++;
+			}
+		}
+	}
+
+	for (s32 i = 1; i <= cellCount; ++i) {
+		_cellStarts[i] += _cellStarts[i - 1];
+	}
+
+	s32 entryCount = _cellStarts[cellCount];
+
+	if (_entriesSize < entryCount) {
+		delete [] _entries;
+		_entries = new s32[entryCount];
+		_entriesSize = entryCount;
+	}
+
+	// Store the entries.  Each cell's start index is used as its insertion
+	// point, which leaves it pointing at the start of the next cell.
+	for (s32 i = 0; i < gadgets.size(); ++i) {
+		Rect rect(gadgets[i]->getRelativeX(), gadgets[i]->getRelativeY(), gadgets[i]->getWidth(), gadgets[i]->getHeight());
+
+		if (!getCellRange(rect, column1, row1, column2, row2)) continue;
+
+		for (s32 row = row1; row <= row2; ++row) {
+			for (s32 column = column1; column <= column2; ++column) {
+				s32 cell = (row * _columns) + column;
+				_entries[_cellStarts[cell]] = i;
+				_cellStarts[cell]++;
+			}
+		}
+	}
+
+	// Shift the start indices back into place
+	for (s32 i = cellCount; i > 0; --i) {
+		_cellStarts[i] = _cellStarts[i - 1];
+	}
+
+	_cellStarts[0] = 0;
+
+	// Ensure there is a mark for every gadget
+	if (_marksSize < gadgets.size()) {
+		delete [] _marks;
+		_marks = new u32[gadgets.size()];
+		_marksSize = gadgets.size();
+
+		for (s32 i = 0; i < _marksSize; ++i) {
+			_marks[i] = 0;
+		}
+
+		_markStamp = 0;
+	}
+}
+
+void SpatialGrid::getGadgetsAt(s16 x, s16 y, WoopsiArray<s32>& indices) const {
+
+	s32 column1, row1, column2, row2;
+
+	if (!getCellRange(Rect(x, y, 1, 1), column1, row1, column2, row2)) return;
+
+	s32 cell = (row1 * _columns) + column1;
+
+	// Entries are in ascending z-order, so walk them backwards
+	for (s32 i = _cellStarts[cell + 1] - 1; i >= _cellStarts[cell]; --i) {
+		indices.push_back(_entries[i]);
+	}
+}
+
+bool SpatialGrid::getGadgetsIntersecting(const Rect& rect, WoopsiArray<s32>& indices) {
+
+	s32 column1, row1, column2, row2;
+
+	if (!getCellRange(rect, column1, row1, column2, row2)) return true;
+
+	// If the rect covers most of the grid, gathering and sorting the indices
+	// would be slower than checking every gadget
+	s32 cellCount = ((column2 - column1) + 1) * ((row2 - row1) + 1);
+
+	if (cellCount * 2 > _columns * _rows) return false;
+
+	// Reset the marks if the stamp wraps
+	_markStamp++;
+
+	if (_markStamp == 0) {
+		for (s32 i = 0; i < _marksSize; ++i) {
+			_marks[i] = 0;
+		}
+
+		_markStamp = 1;
+	}
+
+	s32 first = indices.size();
+
+	for (s32 row = row1; row <= row2; ++row) {
+		for (s32 column = column1; column <= column2; ++column) {
+			s32 cell = (row * _columns) + column;
+
+			for (s32 i = _cellStarts[cell]; i < _cellStarts[cell + 1]; ++i) {
+				s32 index = _entries[i];
+
+				// Gadgets that span several cells are only added once
+				if (_marks[index] == _markStamp) continue;
+
+				_marks[index] = _markStamp;
+
+				// Insert in descending order.  Queries return few gadgets, so
+				// an insertion sort is fine.
+				s32 position = indices.size();
+
+				while ((position > first) && (indices[position - 1] < index)) {
+					position--;
+				}
+
+				indices.insert(position, index);
+			}
+		}
+	}
+
+	return true;
+}
+
+bool SpatialGrid::getCellRange(const Rect& rect, s32& column1, s32& row1, s32& column2, s32& row2) const {
+
+	if ((_columns == 0) || (_rows == 0)) return false;
+	if (!rect.hasDimensions()) return false;
+
+	// Convert to grid co-ordinates
+	s32 x1 = rect.x - _originX;
+	s32 y1 = rect.y - _originY;
+	s32 x2 = x1 + rect.width - 1;
+	s32 y2 = y1 + rect.height - 1;
+
+	s32 gridWidth = _columns * _cellSize;
+	s32 gridHeight = _rows * _cellSize;
+
+	if ((x2 < 0) || (y2 < 0) || (x1 >= gridWidth) || (y1 >= gridHeight)) return false;
+
+	if (x1 < 0) x1 = 0;
+	if (y1 < 0) y1 = 0;
+	if (x2 >= gridWidth) x2 = gridWidth - 1;
+	if (y2 >= gridHeight) y2 = gridHeight - 1;
+
+	column1 = x1 / _cellSize;
+	row1 = y1 / _cellSize;
+	column2 = x2 / _cellSize;
+	row2 = y2 / _cellSize;
+
+	return true;
+}
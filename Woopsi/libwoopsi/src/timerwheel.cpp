@@ -0,0 +1,213 @@
+#include "timerwheel.h"
+#include "wheeltimerhandler.h"
+#include "defines.h"
+
+using namespace WoopsiUI;
+
+TimerWheel::TimerWheel() {
+	_expiring = NULL;
+	_time = 0;
+	_timerCount = 0;
+
+	for (s32 level = 0; level < LEVEL_COUNT; ++level) {
+		for (s32 i = 0; i < SLOT_COUNT; ++i) {
+			_slots[level][i] = NULL;
+		}
+	}
+}
+
+TimerWheel::~TimerWheel() {
+	for (s32 level = 0; level < LEVEL_COUNT; ++level) {
+		for (s32 i = 0; i < SLOT_COUNT; ++i) {
+			detachAll(_slots[level][i]);
+		}
+	}
+
+	detachAll(_expiring);
+}
+
+void TimerWheel::schedule(WheelTimer* timer, u32 frames, u32 interval) {
+
+	// Remove the timer from whichever wheel it is currently in
+	timer->cancel();
+
+	if (frames == 0) frames = 1;
+	if (frames > MAX_DELAY) frames = MAX_DELAY;
+	if (interval > MAX_DELAY) interval = MAX_DELAY;
+
+	timer->_wheel = this;
+	timer->_deadline = _time + frames;
+	timer->_interval = interval;
+
+	insert(timer);
+
+	_timerCount++;
+}
+
+void TimerWheel::scheduleMilliseconds(WheelTimer* timer, u32 milliseconds, u32 interval) {
+	schedule(timer, millisecondsToFrames(milliseconds), millisecondsToFrames(interval));
+}
+
+void TimerWheel::cancel(WheelTimer* timer) {
+	if (timer->_wheel != this) return;
+
+	unlink(timer);
+	timer->_wheel = NULL;
+
+	_timerCount--;
+}
+
+void TimerWheel::advance(u32 frames) {
+	for (; frames > 0; --frames) {
+
+		// Nothing can happen until a timer is scheduled, so skip straight to
+		// the end
+		if (_timerCount == 0) {
+			_time += frames;
+			return;
+		}
+
+		tick();
+	}
+}
+
+bool TimerWheel::getFramesUntilNextExpiry(u32& frames) const {
+	if (_timerCount == 0) return false;
+
+	// Timers in the upper levels cannot expire before they have cascaded,
+	// which happens when level 0 wraps, so the scan never needs to look
+	// beyond that point
+	for (u32 i = 1; i <= SLOT_COUNT; ++i) {
+		u32 index = (_time + i) & SLOT_MASK;
+
+		if ((index == 0) || (_slots[0][index] != NULL)) {
+			frames = i;
+			return true;
+		}
+	}
+
+	frames = SLOT_COUNT;
+	return true;
+}
+
+u32 TimerWheel::millisecondsToFrames(u32 milliseconds) {
+
+	// Convert whole seconds separately to avoid overflow
+	u32 seconds = milliseconds / 1000;
+	u32 remainder = milliseconds % 1000;
+
+	return (seconds * FRAMES_PER_SECOND) + (((remainder * FRAMES_PER_SECOND) + 999) / 1000);
+}
+
+void TimerWheel::tick() {
+	_time++;
+
+	// Each time a level wraps, move the timers in the next slot of the level
+	// above down into the lower levels
+	u32 index = _time & SLOT_MASK;
+
+	for (s32 level = 1; (index == 0) && (level < LEVEL_COUNT); ++level) {
+		index = (_time >> (level * SLOT_BITS)) & SLOT_MASK;
+		cascade(level, index);
+	}
+
+	expire(_time & SLOT_MASK);
+}
+
+void TimerWheel::insert(WheelTimer* timer) {
+	u32 delay = timer->_deadline - _time;
+
+	// Find the lowest level whose revolution covers the delay
+	s32 level = 0;
+
+	while ((level < LEVEL_COUNT - 1) && (delay >> ((level + 1) * SLOT_BITS) != 0)) {
+		level++;
+	}
+
+	u32 index = (timer->_deadline >> (level * SLOT_BITS)) & SLOT_MASK;
+
+	link(timer, &_slots[level][index]);
+}
+
+void TimerWheel::cascade(s32 level, u32 index) {
+	WheelTimer* timer = _slots[level][index];
+	_slots[level][index] = NULL;
+
+	// Every timer in the slot is due within one revolution of the level
+	// below, so none of them can end up back in this slot
+	while (timer != NULL) {
+		WheelTimer* next = timer->_next;
+		insert(timer);
+		timer = next;
+	}
+}
+
+void TimerWheel::expire(u32 index) {
+	if (_slots[0][index] == NULL) return;
+
+	// Detach the slot before notifying anything so that handlers can freely
+	// schedule and cancel timers, including those still waiting to be
+	// notified
+	_expiring = _slots[0][index];
+	_slots[0][index] = NULL;
+
+	for (WheelTimer* timer = _expiring; timer != NULL; timer = timer->_next) {
+		timer->_head = &_expiring;
+	}
+
+	while (_expiring != NULL) {
+		WheelTimer* timer = _expiring;
+		unlink(timer);
+
+		// Reschedule repeating timers before notifying the handler, as the
+		// handler may delete the timer
+		if (timer->_interval > 0) {
+			timer->_deadline += timer->_interval;
+			insert(timer);
+		} else {
+			timer->_wheel = NULL;
+			_timerCount--;
+		}
+
+		if (timer->_handler != NULL) {
+			timer->_handler->handleTimerExpired(*timer);
+		}
+	}
+}
+
+void TimerWheel::link(WheelTimer* timer, WheelTimer** head) {
+	timer->_head = head;
+	timer->_previous = NULL;
+	timer->_next = *head;
+
+	if (*head != NULL) (*head)->_previous = timer;
+
+	*head = timer;
+}
+
+void TimerWheel::unlink(WheelTimer* timer) {
+	if (timer->_previous != NULL) {
+		timer->_previous->_next = timer->_next;
+	} else {
+		*timer->_head = timer->_next;
+	}
+
+	if (timer->_next != NULL) timer->_next->_previous = timer->_previous;
+
+	timer->_head = NULL;
+	timer->_previous = NULL;
+	timer->_next = NULL;
+}
+
+void TimerWheel::detachAll(WheelTimer* head) {
+	while (head != NULL) {
+		WheelTimer* next = head->_next;
+
+		head->_wheel = NULL;
+		head->_head = NULL;
+		head->_previous = NULL;
+		head->_next = NULL;
+
+		head = next;
+	}
+}
@@ -0,0 +1,60 @@
+#include "trigramindex.h"
+
+using namespace WoopsiUI;
+
+TrigramIndex::TrigramIndex() : _empty(1) {
+	for (s32 i = 0; i < BUCKET_COUNT; ++i) {
+		_buckets[i] = NULL;
+	}
+}
+
+TrigramIndex::~TrigramIndex() {
+	clear();
+}
+
+void TrigramIndex::clear() {
+	for (s32 i = 0; i < BUCKET_COUNT; ++i) {
+		delete _buckets[i];
+		_buckets[i] = NULL;
+	}
+}
+
+void TrigramIndex::add(const s32 id, const char* text, const s32 length) {
+	if (length < 3) return;
+
+	char trigram[3];
+	trigram[1] = fold(text[0]);
+	trigram[2] = fold(text[1]);
+
+	for (s32 i = 2; i < length; ++i) {
+		trigram[0] = trigram[1];
+		trigram[1] = trigram[2];
+		trigram[2] = fold(text[i]);
+
+		u32 bucket = getBucket(trigram);
+
+		if (_buckets[bucket] == NULL) _buckets[bucket] = new WoopsiArray<s32>(4);
+
+		// IDs arrive in ascending order, so a string that contains the same
+		// trigram more than once only needs to be compared with the last ID
+		WoopsiArray<s32>* ids = _buckets[bucket];
+		if ((ids->size() == 0) || (ids->at(ids->size() - 1) != id)) ids->push_back(id);
+	}
+}
+
+const WoopsiArray<s32>* TrigramIndex::getCandidates(const char* term, const s32 length) const {
+	if (length < 3) return NULL;
+
+	const WoopsiArray<s32>* best = NULL;
+
+	// Use the trigram that appears in the fewest strings
+	for (s32 i = 0; i + 2 < length; ++i) {
+		const WoopsiArray<s32>* ids = _buckets[getBucket(term + i)];
+
+		if (ids == NULL) return &_empty;
+
+		if ((best == NULL) || (ids->size() < best->size())) best = ids;
+	}
+
+	return best;
+}
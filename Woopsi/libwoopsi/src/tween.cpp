@@ -0,0 +1,104 @@
+#include "tween.h"
+#include "animator.h"
+#include "tweeneventhandler.h"
+#include "woopsi.h"
+
+using namespace WoopsiUI;
+
+Tween::Tween(s32 from, s32 to, u16 frames, Easing easing) {
+	_eventHandler = NULL;
+	_from = from;
+	_to = to;
+	_value = from;
+	_duration = frames > 0 ? frames : 1;
+	_elapsed = 0;
+	_easing = easing;
+	_isRunning = false;
+}
+
+Tween::~Tween() {
+	stop();
+}
+
+void Tween::start() {
+	if (woopsiApplication == NULL) return;
+
+	_elapsed = 0;
+	update(0);
+
+	_isRunning = true;
+	woopsiApplication->getAnimator()->add(this);
+}
+
+void Tween::stop() {
+	if (!_isRunning) return;
+
+	_isRunning = false;
+
+	if (woopsiApplication != NULL) {
+		woopsiApplication->getAnimator()->remove(this);
+	}
+}
+
+bool Tween::animate() {
+	_elapsed++;
+
+	update(getEasedProgress());
+
+	if (_elapsed < _duration) return true;
+
+	// Leave the animator before raising the event so that a handler that
+	// restarts the tween adds it again rather than finding it still present.
+	// The handler may delete the tween, so nothing can be touched after it
+	// has been called.
+	_isRunning = false;
+
+	woopsiApplication->getAnimator()->remove(this);
+
+	if (_eventHandler != NULL) {
+		_eventHandler->handleTweenCompleteEvent(*this);
+	}
+
+	return false;
+}
+
+void Tween::update(s32 progress) {
+	s32 value = interpolate(_from, _to, progress);
+
+	if (value == _value) return;
+
+	_value = value;
+
+	if (_eventHandler != NULL) {
+		_eventHandler->handleTweenValueChangeEvent(*this);
+	}
+}
+
+s32 Tween::interpolate(s32 from, s32 to, s32 progress) {
+	s32 distance = to - from;
+
+	// Split the distance to avoid overflowing when multiplying large values
+	return from + ((distance / PROGRESS_MAX) * progress) + (((distance % PROGRESS_MAX) * progress) / PROGRESS_MAX);
+}
+
+s32 Tween::getEasedProgress() const {
+	s32 progress = (_elapsed * PROGRESS_MAX) / _duration;
+	s32 remaining = PROGRESS_MAX - progress;
+
+	switch (_easing) {
+		case TWEEN_EASING_LINEAR:
+			return progress;
+		case TWEEN_EASING_IN:
+			return (progress * progress) / PROGRESS_MAX;
+		case TWEEN_EASING_OUT:
+			return PROGRESS_MAX - ((remaining * remaining) / PROGRESS_MAX);
+		case TWEEN_EASING_IN_OUT:
+			if (progress < PROGRESS_MAX / 2) {
+				return (2 * progress * progress) / PROGRESS_MAX;
+			}
+
+			return PROGRESS_MAX - ((2 * remaining * remaining) / PROGRESS_MAX);
+	}
+
+	return progress;
+}
@@ -0,0 +1,22 @@
+#include "wheeltimer.h"
+#include "timerwheel.h"
+
+using namespace WoopsiUI;
+
+WheelTimer::WheelTimer(WheelTimerHandler* handler) {
+	_wheel = NULL;
+	_handler = handler;
+	_head = NULL;
+	_previous = NULL;
+	_next = NULL;
+	_deadline = 0;
+	_interval = 0;
+}
+
+WheelTimer::~WheelTimer() {
+	cancel();
+}
+
+void WheelTimer::cancel() {
+	if (_wheel != NULL) _wheel->cancel(this);
+}
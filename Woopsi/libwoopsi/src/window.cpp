@@ -1,14 +1,53 @@
 #include "window.h"	
 #include "woopsi.h"
+#include "backingstore.h"
 #include "damagedrectmanager.h"
 
 using namespace WoopsiUI;
 
 Window::Window(s16 x, s16 y, u16 width, u16 height, const WoopsiString& title, GadgetStyle* style) : Gadget(x, y, width, height, style) {
 	_title = title;
+	_backingStore = NULL;
+}
+
+Window::~Window() {
+	delete _backingStore;
+}
+
+void Window::setBackingStoreEnabled(bool isEnabled) {
+	if (isEnabled == isBackingStoreEnabled()) return;
+
+	if (isEnabled) {
+		_backingStore = new BackingStore(this);
+	} else {
+		delete _backingStore;
+		_backingStore = NULL;
+	}
+}
+
+void Window::moveFromBackingStore(s16 x, s16 y) {
+
+	DamagedRectManager* damagedRectManager = woopsiApplication->getDamagedRectManager();
+
+	// Ensure the display and the store are both up to date
+	damagedRectManager->redraw();
+	_backingStore->update();
+
+	// Moving damages the old and new areas.  The new area will be copied
+	// from the store, so only the uncovered part of the old area needs to
+	// be redrawn.
+	moveTo(x, y);
+
+	cacheVisibleRects();
+	damagedRectManager->removeDamagedRegion(*getForegroundRegion());
+
+	_backingStore->draw();
 }
 
 void Window::onDragStop() {
+
+	// The window has already been moved
+	if (_backingStore != NULL) return;
 	
 	woopsiApplication->getDamagedRectManager()->redraw();
 	
@@ -61,6 +100,14 @@ void Window::onDrag(s16 x, s16 y, s16 vX, s16 vY) {
 		if (destY < 0) {
 			destY = 0;
 		}
+
+		if (_backingStore != NULL) {
+			_newX = destX;
+			_newY = destY;
+
+			moveFromBackingStore(destX, destY);
+			return;
+		}
 		
 		woopsiApplication->getDamagedRectManager()->redraw();
 
@@ -101,6 +148,13 @@ void Window::onDragStart() {
 	
 	woopsiApplication->getDamagedRectManager()->redraw();
 
+	// Take a copy of the visible parts of the window and render the rest
+	if (_backingStore != NULL) {
+		_backingStore->capture();
+		_backingStore->update();
+		return;
+	}
+
 	// Draw XOR rect
 
 	// Get a graphics port from the parent screen
@@ -1,6 +1,9 @@
+#include "animator.h"
 #include "contextmenu.h"
 #include "damagedrectmanager.h"
+#include "directorycache.h"
 #include "fontbase.h"
+#include "framearena.h"
 #include "graphicsport.h"
 #include "gadgetstyle.h"
 #include "hardware.h"
@@ -8,11 +11,11 @@
 #include "pad.h"
 #include "screen.h"
 #include "stylus.h"
+#include "timerwheel.h"
 #include "woopsi.h"
 #include "woopsifuncs.h"
 #include "woopsikeyboard.h"
 #include "woopsikeyboardscreen.h"
-#include "woopsitimer.h"
 
 using namespace WoopsiUI;
 
@@ -33,6 +36,10 @@ Woopsi::Woopsi(GadgetStyle* style) : Gadget(0, 0, SCREEN_WIDTH, TOP_SCREEN_Y_OFF
 	singleton = this;
 
 	_damagedRectManager = new DamagedRectManager(this);
+	_frameArena = new FrameArena(FRAME_ARENA_SIZE);
+	_timerWheel = new TimerWheel();
+	_animator = new Animator();
+	_directoryCache = new DirectoryCache(DIRECTORY_CACHE_SIZE);
 
 	woopsiInitDefaultGadgetStyle();
 
@@ -99,6 +106,21 @@ Woopsi::~Woopsi() {
 	delete _damagedRectManager;
 	_damagedRectManager = NULL;
 
+	delete _frameArena;
+	_frameArena = NULL;
+
+	// Any timers still scheduled are detached from the wheel
+	delete _timerWheel;
+	_timerWheel = NULL;
+
+	// Children are deleted after the singleton is cleared, so they will not
+	// try to remove themselves from the animator
+	delete _animator;
+	_animator = NULL;
+
+	delete _directoryCache;
+	_directoryCache = NULL;
+
 	Hardware::shutdown();
 
 	woopsiFreeDefaultGadgetStyle();
@@ -112,10 +134,45 @@ void Woopsi::processOneVBL(Gadget* gadget) {
 	
 	// Redraw all damaged rects
 	_damagedRectManager->redraw();
+
+	// Release everything allocated for this frame
+	_frameArena->reset();
+
+	// Nothing will change until the next input event or timer deadline, so
+	// stop polling
+	if (isIdle()) {
+		u32 timeout = IDLE_TIMEOUT;
+		u32 frames;
+
+		// The next VBL advances the wheel by one frame, so we only need to
+		// wait for the frames before that
+		if (_timerWheel->getFramesUntilNextExpiry(frames)) {
+			u32 frameTimeout = ((frames - 1) * 1000) / FRAMES_PER_SECOND;
+
+			if (frameTimeout < timeout) timeout = frameTimeout;
+		}
+
+		if (timeout > 0) {
+			u32 elapsed = Hardware::waitForEvent(timeout);
+
+			// Account for any frames spent waiting
+			_timerWheel->advance((elapsed * FRAMES_PER_SECOND) / 1000);
+		}
+	}
 	
 	Hardware::waitForVBlank();
 }
 
+bool Woopsi::isIdle() {
+	if (_damagedRectManager->isDamaged()) return false;
+	if (_deleteQueue.size() > 0) return false;
+	if (_animator->isAnimating()) return false;
+	if (!Hardware::getStylus().isIdle()) return false;
+	if (!Hardware::getPad().isIdle()) return false;
+
+	return true;
+}
+
 void Woopsi::handleVBL() {
 
 	// Increase vbl counter
@@ -124,12 +181,11 @@ void Woopsi::handleVBL() {
 	// Delete any queued gadgets
 	processDeleteQueue();
 
-	// VBL
-	s32 i = 0;
-	while (i < _vblListeners.size()) {
-		_vblListeners[i]->run();
-		i++;
-	}
+	// Fire any timers that have expired
+	_timerWheel->advance(1);
+
+	// Advance all running animations and tweens
+	_animator->run();
 }
 
 // Process all stylus input
@@ -329,32 +385,6 @@ bool Woopsi::flipScreens(Gadget* gadget) {
 	return true;
 }
 
-// Add a timer to the list of timers that receive VBL events
-void Woopsi::registerForVBL(WoopsiTimer* timer) {
-
-	// Ensure gadget is not already in the list
-	for (s32 i = 0; i < _vblListeners.size(); i++) {
-		if (_vblListeners[i] == timer) {
-			return;
-		}
-	}
-
-	_vblListeners.push_back(timer);
-}
-
-// Remove a timer from the VBL list
-void Woopsi::unregisterFromVBL(WoopsiTimer* timer) {
-	
-	// Locate gadget in the list
-	for (s32 i = 0; i < _vblListeners.size(); i++) {
-		if (_vblListeners[i] == timer) {
-			_vblListeners.erase(i);
-			return;
-		}
-	}
-}
-
-
 // Delete all gadgets in the queue
 void Woopsi::processDeleteQueue() {
 
@@ -17,6 +17,9 @@ WoopsiKeyboard::WoopsiKeyboard(s16 x, s16 y, GadgetStyle* style) : Gadget(x, y,
 	_borderSize.left = 0;
 	_flags.borderless = true;
 
+	// The keyboard has dozens of keys, so index them for fast hit-testing
+	setSpatialIndexEnabled(true);
+
 	// Get available window region
 	Rect rect;
 	getClientRect(rect);
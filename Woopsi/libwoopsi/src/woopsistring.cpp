@@ -179,15 +179,17 @@ char* WoopsiString::getToken(s32 index) const {
 	// Early exit if the index is greater than the length of the string
 	if (index >= _stringLength) return NULL;
 
-	char token;
+	u8 token;
 	char* pos = _text;
 
 	while (index > 0) {
 
 		pos++;
-		token = *pos;
+		token = (u8)*pos;
 
-		if ((token < 0x80) || ((token > 0xC2) && (token < 0xFE))) {
+		// Count ASCII chars and UTF-8 leading bytes; reading the byte as
+		// unsigned ensures this works wherever char is signed
+		if ((token < 0x80) || ((token >= 0xC2) && (token < 0xFE))) {
 			if (index <= 1) return pos;
 			index--;
 		}
@@ -458,7 +460,10 @@ s32 WoopsiString::filterString(char* dest, const char* src, s32 sourceBytes, s32
 }
 
 u32 WoopsiString::getCodePoint(const char* string, u8* numChars) const {
-	char char0 = *string;
+	// Read bytes as unsigned so that the comparisons work wherever char is
+	// signed
+	const u8* data = (const u8*)string;
+	u8 char0 = data[0];
 
 	if (numChars) *numChars = 0;
 
@@ -469,55 +474,55 @@ u32 WoopsiString::getCodePoint(const char* string, u8* numChars) const {
 	}
 
 	// 1xxxxxxx 10xxxxxx
-	if ((string[1] < 0x80) || (string[1] >= 0xC0)) return 0; 
+	if ((data[1] < 0x80) || (data[1] >= 0xC0)) return 0; 
 
 	// 110xxxxx 10xxxxxx
 	if (char0 < 0xE0) {
 		if (char0 < 0xC2) return 0; // 10xxxxxx (invalid leading char) or  1100000x 10xxxxxx (invalid representation : should have been coded with just 1 char)
 		if (numChars) *numChars = 2;
-		return ((char0 - 0xC0) << 6) | (string[1] - 0x80); 
+		return ((char0 - 0xC0) << 6) | (data[1] - 0x80); 
 	}
 
 	// 111yyyyy 10xxxxxx 10xxxxxx
-	if ((string[2]<0x80) || (string[2] >= 0xC0)) return 0; 
+	if ((data[2]<0x80) || (data[2] >= 0xC0)) return 0; 
 	
 	// 1110xxxx 10xxxxxx 10xxxxxx
 	if (char0 < 0xF0) {
-		if ((char0 == 0xE0) && (string[1] < 0xA0)) return 0; // 11100000 100xxxxx 10xxxxxx (invalid representation : should have been coded with at most 2 chars)
+		if ((char0 == 0xE0) && (data[1] < 0xA0)) return 0; // 11100000 100xxxxx 10xxxxxx (invalid representation : should have been coded with at most 2 chars)
 		if (numChars) *numChars = 3;
-		return ((char0 - 0xE0) << 12) | ((string[1] - 0x80) << 6) | (string[2] - 0x80); 
+		return ((char0 - 0xE0) << 12) | ((data[1] - 0x80) << 6) | (data[2] - 0x80); 
 	}
 
 	// There shouldn't be many utf-8 tokens beyond this point
 
 	// 1111yyyy 10xxxxxx 10xxxxxx 10xxxxxx
-	if ((string[3] < 0x80) || (string[3] >= 0xC0)) return 0; 
+	if ((data[3] < 0x80) || (data[3] >= 0xC0)) return 0; 
 
 	// 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx
 	if (char0 < 0xF8) {
-		if ((char0 == 0xF0) && (string[1]<0x90)) return 0; // 11110000 1000xxxx 10xxxxxx 10xxxxxx  (invalid representation : should have been coded with at most 3 chars)
+		if ((char0 == 0xF0) && (data[1]<0x90)) return 0; // 11110000 1000xxxx 10xxxxxx 10xxxxxx  (invalid representation : should have been coded with at most 3 chars)
 		if (numChars) *numChars = 4;
-		return ((char0 - 0xF0) << 18) | ((string[1] - 0x80) << 12) | ((string[2] - 0x80) << 6) | (string[3] - 0x80);
+		return ((char0 - 0xF0) << 18) | ((data[1] - 0x80) << 12) | ((data[2] - 0x80) << 6) | (data[3] - 0x80);
 	}            
 
 	// 11111yyy 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx
-	if ((string[4] < 0x80) || (string[4] >= 0xC0)) return 0; 
+	if ((data[4] < 0x80) || (data[4] >= 0xC0)) return 0; 
 
 	// 111110xx 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx
 	if (char0 < 0xFC) {
-		if ((char0 == 0xF8) && (string[1]<0x88)) return 0; // 11111000 10000xxx 10xxxxxx 10xxxxxx 10xxxxxx (invalid representation : should have been coded with at most 4 chars)
+		if ((char0 == 0xF8) && (data[1]<0x88)) return 0; // 11111000 10000xxx 10xxxxxx 10xxxxxx 10xxxxxx (invalid representation : should have been coded with at most 4 chars)
 		if (numChars) *numChars = 5;
-		return ((char0-0xF8)<<24) | ((string[1]-0x80)<<18) | ((string[2]-0x80)<<12) | ((string[3]-0x80)<<6) | (string[4] -0x80);
+		return ((char0-0xF8)<<24) | ((data[1]-0x80)<<18) | ((data[2]-0x80)<<12) | ((data[3]-0x80)<<6) | (data[4] -0x80);
 	}   
 
 	// 111111yy 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx
-	if ((string[5] < 0x80) || (string[5] >= 0xC0)) return 0; 
+	if ((data[5] < 0x80) || (data[5] >= 0xC0)) return 0; 
 
 	// 1111110x 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx
 	if (char0 < 0xFE) {
-		if ((char0 == 0xFC) && (string[1]<0x84)) return 0; // 11111100 100000xx 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx (invalid representation : should have been coded with at most 5 chars)
+		if ((char0 == 0xFC) && (data[1]<0x84)) return 0; // 11111100 100000xx 10xxxxxx 10xxxxxx 10xxxxxx 10xxxxxx (invalid representation : should have been coded with at most 5 chars)
 		if (numChars) *numChars = 6;
-		return ((char0-0xFC)<<30) | ((string[1]-0x80)<<24) | ((string[2]-0x80)<<18) | ((string[3]-0x80)<<12) | ((string[4]-0x80)<<6) | (string[5] -0x80);
+		return ((char0-0xFC)<<30) | ((data[1]-0x80)<<24) | ((data[2]-0x80)<<18) | ((data[3]-0x80)<<12) | ((data[4]-0x80)<<6) | (data[5] -0x80);
 	}   
 
 	// 11111110 and 11111111 are invalid
@@ -539,7 +544,7 @@ const char* WoopsiString::encodeCodePoint(u32 codepoint, u8* numBytes) const {
 		if (numBytes) *numBytes = 2;
 		char* buffer = new char[2];
 		buffer[0] = (codepoint >> 6) + 0xC0;
-		buffer[1] = (codepoint & 0x1F) + 0x80;
+		buffer[1] = (codepoint & 0x3F) + 0x80;
 		return buffer;
 	}
 
@@ -1,4 +1,6 @@
 #include "woopsitimer.h"
+#include "timerwheel.h"
+#include "woopsi.h"
 
 using namespace WoopsiUI;
 
@@ -6,35 +8,74 @@ WoopsiTimer::WoopsiTimer(u32 timeout, bool repeat) : Gadget(0, 0, 0, 0) {
 	_timeout = timeout;
 	_isRepeater = repeat;
 	_frameCount = 0;
-	_isRunning = false;
+	_startTime = 0;
+
+	_wheelTimer.setHandler(this);
 
 	// Ensure that Woopsi makes no attempt to draw this gadget
 	hide();
+}
 
-	// Ensure that this gadget receives VBL notifications
-	if (woopsiApplication != NULL) {
-		woopsiApplication->registerForVBL(this);
-	}
+const u32 WoopsiTimer::getFrameCount() const {
+	if (!isRunning()) return _frameCount;
+
+	return _frameCount + (woopsiApplication->getTimerWheel()->getTime() - _startTime);
 }
 
-bool WoopsiTimer::run() {
-	if (_isRunning) {
-		_frameCount++;
+void WoopsiTimer::reset() {
+	_frameCount = 0;
+
+	if (isRunning()) schedule();
+}
+
+void WoopsiTimer::start() {
+	if (isRunning()) return;
+
+	schedule();
+}
+
+void WoopsiTimer::stop() {
+	_wheelTimer.cancel();
+	_frameCount = 0;
+}
 
-		if (_frameCount >= _timeout) {
-			if (!_isRepeater) {
-				stop();
-			} else {
-				_frameCount = 0;
-			}
+void WoopsiTimer::pause() {
+	_frameCount = getFrameCount();
+	_wheelTimer.cancel();
+}
 
-			if (raisesEvents()) {
-				_gadgetEventHandler->handleActionEvent(*this);
-			}
+void WoopsiTimer::setTimeout(u32 timeout) {
+	_timeout = timeout;
 
-			return true;
-		}
+	if (isRunning()) {
+		_frameCount = getFrameCount();
+		schedule();
 	}
+}
+
+void WoopsiTimer::schedule() {
+	if (woopsiApplication == NULL) return;
+
+	TimerWheel* wheel = woopsiApplication->getTimerWheel();
+
+	// Fire on the next frame if the timeout has already been reached
+	u32 remaining = _frameCount < _timeout ? _timeout - _frameCount : 1;
+	u32 interval = 0;
+
+	if (_isRepeater) interval = _timeout > 0 ? _timeout : 1;
 
-	return false;
+	_startTime = wheel->getTime();
+	wheel->schedule(&_wheelTimer, remaining, interval);
+}
+
+void WoopsiTimer::handleTimerExpired(WheelTimer& source) {
+
+	// The wheel reschedules repeating timers itself and removes one-shot
+	// timers, so we just need to restart the count
+	_frameCount = 0;
+	_startTime = woopsiApplication->getTimerWheel()->getTime();
+
+	if (raisesEvents()) {
+		_gadgetEventHandler->handleActionEvent(*this);
+	}
 }